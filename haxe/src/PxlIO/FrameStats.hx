@@ -0,0 +1,22 @@
+package pxlio;
+
+import haxe.Int32;
+
+class FrameStats {
+    public var spritesSubmitted: Int32;
+    public var spritesCulled: Int32;
+    public var drawCalls: Int32;
+    public var pipelineBinds: Int32;
+    public var textureBinds: Int32;
+    public var bytesUploaded: Float;
+    public var buffersAllocated: Int32;
+    public var fenceWaitMs: Single;
+    public var acquireMs: Single;
+    public var presentMs: Single;
+    public var heapAllocations: Int32;
+    public var heapAllocatedBytes: Float;
+
+    public function new() {
+
+    }
+}
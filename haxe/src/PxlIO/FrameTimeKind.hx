@@ -0,0 +1,9 @@
+package pxlio;
+
+import haxe.Int32;
+
+class FrameTimeKind {
+	public static inline var Cpu:Int32 = 0;
+	public static inline var Gpu:Int32 = 1;
+	public static inline var Present:Int32 = 2;
+}
@@ -0,0 +1,16 @@
+package pxlio;
+
+import haxe.Int32;
+
+class FrameTimePercentiles {
+	public var sampleCount: Int32;
+	public var hitchCount: Int32;
+	public var p50Ms: Single;
+	public var p95Ms: Single;
+	public var p99Ms: Single;
+	public var maxMs: Single;
+
+	public function new() {
+
+	}
+}
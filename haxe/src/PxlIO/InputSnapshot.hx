@@ -0,0 +1,108 @@
+package pxlio;
+
+import haxe.Int32;
+
+// All of a frame's input, copied into a buffer that is reused every frame by a single call to update, so that it can
+// be queried without calling into the native library or allocating. Laid out the same as the native InputSnapshot.
+class InputSnapshot {
+	public static inline var size:Int32 = 532;
+	// Keys after this many pressed in one frame are left out of getPressedKey.
+	public static inline var maxPressedKeys:Int32 = 32;
+
+	static inline var overflowKeyIndexStart:Int32 = 640;
+	static inline var maxOverflowKeys:Int32 = 32;
+	static inline var keyIndexCount:Int32 = 672;
+	static inline var scancodeMask:Int32 = 0x40000000;
+
+	static inline var heldKeysOffset:Int32 = 24;
+	static inline var pressedKeysOffset:Int32 = 108;
+	static inline var releasedKeysOffset:Int32 = 192;
+	static inline var pressedKeyListOffset:Int32 = 276;
+	static inline var overflowKeysOffset:Int32 = 404;
+
+	final bytes:hl.Bytes;
+
+	public function new() {
+		bytes = new hl.Bytes(size);
+		bytes.fill(0, size, 0);
+	}
+
+	// Call once per frame after PxlIO.pollEvents.
+	public function update() {
+		PxlIOBindings.pxlio_get_input_snapshot(bytes, size);
+	}
+
+	public function isKeyHeld(key:Int32):Bool {
+		return getKeyBit(heldKeysOffset, key);
+	}
+
+	public function wasKeyPressed(key:Int32):Bool {
+		return getKeyBit(pressedKeysOffset, key);
+	}
+
+	public function wasKeyReleased(key:Int32):Bool {
+		return getKeyBit(releasedKeysOffset, key);
+	}
+
+	public function getPressedKeyCount():Int32 {
+		return bytes.getI32(20);
+	}
+
+	// Keys pressed this frame in the order they were pressed.
+	public function getPressedKey(i:Int32):Int32 {
+		return bytes.getI32(pressedKeyListOffset + i * 4);
+	}
+
+	public function getMouseX():Int32 {
+		return bytes.getI32(0);
+	}
+
+	public function getMouseY():Int32 {
+		return bytes.getI32(4);
+	}
+
+	public function isMouseButtonHeld(mouseButton:Int32):Bool {
+		return getMouseButtonBit(8, mouseButton);
+	}
+
+	public function wasMouseButtonPressed(mouseButton:Int32):Bool {
+		return getMouseButtonBit(12, mouseButton);
+	}
+
+	public function wasMouseButtonReleased(mouseButton:Int32):Bool {
+		return getMouseButtonBit(16, mouseButton);
+	}
+
+	inline function getKeyBit(offset:Int32, key:Int32):Bool {
+		var keyIndex = getKeyIndex(key);
+
+		if (keyIndex < 0 || keyIndex >= keyIndexCount) {
+			return false;
+		}
+
+		return (bytes.getI32(offset + (keyIndex >> 5) * 4) & (1 << (keyIndex & 31))) != 0;
+	}
+
+	// The same numbering as the native Input::GetKeyIndex.
+	function getKeyIndex(key:Int32):Int32 {
+		if (key < 128) {
+			return key;
+		}
+
+		if ((key & scancodeMask) != 0) {
+			return 128 + (key ^ scancodeMask);
+		}
+
+		for (i in 0...maxOverflowKeys) {
+			if (bytes.getI32(overflowKeysOffset + i * 4) == key) {
+				return overflowKeyIndexStart + i;
+			}
+		}
+
+		return keyIndexCount;
+	}
+
+	inline function getMouseButtonBit(offset:Int32, mouseButton:Int32):Bool {
+		return (bytes.getI32(offset) & (1 << (mouseButton & 31))) != 0;
+	}
+}
@@ -0,0 +1,10 @@
+package pxlio;
+
+class MemoryHeapBudget {
+	public var usageBytes: Float;
+	public var budgetBytes: Float;
+
+	public function new() {
+
+	}
+}
@@ -0,0 +1,17 @@
+package pxlio;
+
+import haxe.Int32;
+
+class MemoryReport {
+	public var spriteBatches: Array<SpriteBatchMemory> = [];
+	public var allocatedBytes: Float;
+	public var reservedBytes: Float;
+	public var allocationCount: Int32;
+	public var estimated: Bool;
+	public var budgetsFromDriver: Bool;
+	public var heaps: Array<MemoryHeapBudget> = [];
+
+	public function new() {
+
+	}
+}
@@ -3,8 +3,14 @@ package pxlio;
 import haxe.Int32;
 
 class PxlIO {
-	public function new(windowName:String, windowWidth:Int32, windowHeight:Int32, viewWidth:Int32, viewHeight:Int32, enableVsync:Bool = true) {
-		PxlIOBindings.pxlio_create(windowName, windowWidth, windowHeight, viewWidth, viewHeight, enableVsync);
+	public function new(windowName:String, windowWidth:Int32, windowHeight:Int32, viewWidth:Int32, viewHeight:Int32, enableVsync:Bool = true,
+			backend:Int32 = RendererBackend.Default) {
+		PxlIOBindings.pxlio_create(windowName, windowWidth, windowHeight, viewWidth, viewHeight, enableVsync, backend);
+	}
+
+	// The backend that was created, the default backend falls back to the next one when one fails to initialize.
+	public function getBackend():Int32 {
+		return PxlIOBindings.pxlio_get_backend();
 	}
 
 	public function pollEvents():Bool {
@@ -23,6 +29,78 @@ class PxlIO {
 		PxlIOBindings.pxlio_end_drawing();
 	}
 
+	public function getFrameStats():FrameStats {
+		var frameStatsBytes = PxlIOBindings.pxlio_get_frame_stats();
+		var frameStats = new FrameStats();
+
+		frameStats.spritesSubmitted = frameStatsBytes.getI32(0);
+		frameStats.spritesCulled = frameStatsBytes.getI32(4);
+		frameStats.drawCalls = frameStatsBytes.getI32(8);
+		frameStats.pipelineBinds = frameStatsBytes.getI32(12);
+		frameStats.textureBinds = frameStatsBytes.getI32(16);
+		frameStats.buffersAllocated = frameStatsBytes.getI32(20);
+		frameStats.fenceWaitMs = frameStatsBytes.getF32(24);
+		frameStats.acquireMs = frameStatsBytes.getF32(28);
+		frameStats.presentMs = frameStatsBytes.getF32(32);
+		frameStats.heapAllocations = frameStatsBytes.getI32(36);
+		frameStats.bytesUploaded = frameStatsBytes.getF64(40);
+		frameStats.heapAllocatedBytes = frameStatsBytes.getF64(48);
+
+		return frameStats;
+	}
+
+	public function getFrameTimePercentiles(kind:Int32):FrameTimePercentiles {
+		var percentilesBytes = PxlIOBindings.pxlio_get_frame_time_percentiles(kind);
+		var percentiles = new FrameTimePercentiles();
+
+		percentiles.sampleCount = percentilesBytes.getI32(0);
+		percentiles.hitchCount = percentilesBytes.getI32(4);
+		percentiles.p50Ms = percentilesBytes.getF32(8);
+		percentiles.p95Ms = percentilesBytes.getF32(12);
+		percentiles.p99Ms = percentilesBytes.getF32(16);
+		percentiles.maxMs = percentilesBytes.getF32(20);
+
+		return percentiles;
+	}
+
+	public function getMemoryReport():MemoryReport {
+		var reportBytes = PxlIOBindings.pxlio_get_memory_report();
+		var report = new MemoryReport();
+
+		report.allocatedBytes = reportBytes.getF64(0);
+		report.reservedBytes = reportBytes.getF64(8);
+		report.allocationCount = reportBytes.getI32(16);
+		report.estimated = reportBytes.getI32(20) != 0;
+		report.budgetsFromDriver = reportBytes.getI32(24) != 0;
+		var heapCount = reportBytes.getI32(28);
+		var spriteBatchCount = reportBytes.getI32(32);
+
+		var offset = 40;
+		for (i in 0...heapCount) {
+			var heap = new MemoryHeapBudget();
+			heap.usageBytes = reportBytes.getF64(offset);
+			heap.budgetBytes = reportBytes.getF64(offset + 8);
+			report.heaps.push(heap);
+			offset += 16;
+		}
+
+		for (i in 0...spriteBatchCount) {
+			var memory = new SpriteBatchMemory();
+			memory.spriteBatchId = reportBytes.getI32(offset);
+			memory.maxSprites = reportBytes.getI32(offset + 4);
+			memory.peakSprites = reportBytes.getI32(offset + 8);
+			memory.capacity = reportBytes.getI32(offset + 12);
+			memory.cpuVertexBytes = reportBytes.getF64(offset + 16);
+			memory.cpuIndexBytes = reportBytes.getF64(offset + 24);
+			memory.gpuBufferBytes = reportBytes.getF64(offset + 32);
+			memory.textureBytes = reportBytes.getF64(offset + 40);
+			report.spriteBatches.push(memory);
+			offset += 48;
+		}
+
+		return report;
+	}
+
 	public function setBackgroundColor(r:Single, g:Single, b:Single) {
 		PxlIOBindings.pxlio_set_background_color(r, g, b);
 	}
@@ -40,6 +118,7 @@ class PxlIO {
 	}
 
 	public function drawSpriteBatch(spriteBatch:SpriteBatch) {
+		spriteBatch.flushQueued();
 		PxlIOBindings.pxlio_draw_sprite_batch(spriteBatch.id);
 	}
 
@@ -55,6 +134,21 @@ class PxlIO {
 		return PxlIOBindings.pxlio_was_key_released(key);
 	}
 
+	// Milliseconds since the library started, see getTicks, of when the key was last pressed.
+	public function getKeyPressedTime(key:Int32):Int32 {
+		return PxlIOBindings.pxlio_get_key_pressed_time(key);
+	}
+
+	// When the oldest input handled by the last pollEvents happened, or zero if there was none. getTicks minus this is
+	// how long that input waited to reach the game.
+	public function getFirstInputTime():Int32 {
+		return PxlIOBindings.pxlio_get_first_input_time();
+	}
+
+	public function getTicks():Int32 {
+		return PxlIOBindings.pxlio_get_ticks();
+	}
+
 	public function getPressedKeys():Array<Int32> {
 		var pressedKeyBytes = PxlIOBindings.pxlio_get_pressed_keys();
 		var pressedKeyCount = pressedKeyBytes.getI32(0);
@@ -90,4 +184,44 @@ class PxlIO {
 	public function close() {
 		PxlIOBindings.pxlio_close();
 	}
+
+	public function getTraceFrame():Int32 {
+		return PxlIOBindings.pxlio_get_trace_frame();
+	}
+
+	public function writeTrace(path:String, firstFrame:Int32, lastFrame:Int32) {
+		PxlIOBindings.pxlio_write_trace(path, firstFrame, lastFrame);
+	}
+
+	// Records the renderer calls of the next frameCount frames, which can be played back with PxlIOReplay.
+	public function startCapture(path:String, frameCount:Int32) {
+		PxlIOBindings.pxlio_start_capture(path, frameCount);
+	}
+
+	public function stopCapture() {
+		PxlIOBindings.pxlio_stop_capture();
+	}
+
+	// Records the input and delta time of every following frame, which startInputReplay feeds back exactly.
+	public function startInputRecording(path:String):Bool {
+		return PxlIOBindings.pxlio_start_input_recording(path);
+	}
+
+	public function stopInputRecording() {
+		PxlIOBindings.pxlio_stop_input_recording();
+	}
+
+	// Replaces real input with a recording, pollEvents returns false once it ends.
+	public function startInputReplay(path:String) {
+		PxlIOBindings.pxlio_start_input_replay(path);
+	}
+
+	public function isReplayingInput():Bool {
+		return PxlIOBindings.pxlio_is_replaying_input();
+	}
+
+	// Zero goes back to measuring the time between frames.
+	public function setFixedDeltaTime(seconds:Single) {
+		PxlIOBindings.pxlio_set_fixed_delta_time(seconds);
+	}
 }
@@ -4,7 +4,11 @@ import haxe.Int32;
 
 @:hlNative("PxlIO")
 class PxlIOBindings {
-	public static function pxlio_create(windowName:String, windowWidth:Int32, windowHeight:Int32, viewWidth:Int32, viewHeight:Int32, enableVsync:Bool):Void {}
+	public static function pxlio_create(windowName:String, windowWidth:Int32, windowHeight:Int32, viewWidth:Int32, viewHeight:Int32, enableVsync:Bool, backend:Int32):Void {}
+
+	public static function pxlio_get_backend():Int32 {
+		return 0;
+	}
 
 	public static function pxlio_poll_events():Bool {
 		return false;
@@ -18,6 +22,18 @@ class PxlIOBindings {
 
 	public static function pxlio_end_drawing():Void {}
 
+	public static function pxlio_get_frame_stats():hl.Bytes {
+		return null;
+	}
+
+	public static function pxlio_get_frame_time_percentiles(kind:Int32):hl.Bytes {
+		return null;
+	}
+
+	public static function pxlio_get_memory_report():hl.Bytes {
+		return null;
+	}
+
 	public static function pxlio_set_background_color(r:Single, g:Single, b:Single) {}
 
 	public static function pxlio_set_screen_background_color(r:Single, g:Single, b:Single) {}
@@ -30,9 +46,38 @@ class PxlIOBindings {
 
 	public static function pxlio_sprite_batch_clear(id:Int32) {}
 
+	public static function pxlio_sprite_batch_get_overflow_count(id:Int32):Int32 {
+		return 0;
+	}
+
+	public static function pxlio_sprite_batch_set_shrink_enabled(id:Int32, enabled:Bool) {}
+
 	public static function pxlio_sprite_batch_add(id:Int32, x:Single, y:Single, z:Single, width:Single, height:Single, texX:Single, texY:Single,
 		texWidth:Single, texHeight:Single, originX:Single, originY:Single, rotation:Single, r:Single, g:Single, b:Single, a:Single, tint:Single) {}
 
+	public static function pxlio_sprite_batch_add_many(id:Int32, records:hl.Bytes, count:Int32) {}
+
+	public static function pxlio_sprite_batch_map_vertices(id:Int32, count:Int32):hl.Bytes {
+		return null;
+	}
+
+	public static function pxlio_sprite_batch_get_mapped_sprite_count(id:Int32):Int32 {
+		return 0;
+	}
+
+	public static function pxlio_sprite_batch_commit_vertices(id:Int32, count:Int32) {}
+
+	public static function pxlio_sprite_batch_get_texture_width(id:Int32):Int32 {
+		return 0;
+	}
+
+	public static function pxlio_sprite_batch_get_texture_height(id:Int32):Int32 {
+		return 0;
+	}
+
+	public static function pxlio_sprite_batch_add_frame_time_graph(id:Int32, kind:Int32, x:Single, y:Single, z:Single, barCount:Int32,
+		height:Single, maxMs:Single, texX:Single, texY:Single) {}
+
 	public static function pxlio_draw_sprite_batch(id:Int32) {}
 
 	public static function pxlio_is_key_held(keyNumber:Int32):Bool {
@@ -47,10 +92,26 @@ class PxlIOBindings {
 		return false;
 	}
 
+	public static function pxlio_get_key_pressed_time(keyNumber:Int32):Int32 {
+		return 0;
+	}
+
+	public static function pxlio_get_first_input_time():Int32 {
+		return 0;
+	}
+
+	public static function pxlio_get_ticks():Int32 {
+		return 0;
+	}
+
 	public static function pxlio_get_pressed_keys():hl.Bytes {
 		return null;
 	}
 
+	public static function pxlio_get_input_snapshot(buffer:hl.Bytes, size:Int32):Bool {
+		return false;
+	}
+
 	public static function pxlio_get_mouse_x():Int32 {
 		return 0;
 	}
@@ -73,6 +134,30 @@ class PxlIOBindings {
 
 	public static function pxlio_close() {}
 
+	public static function pxlio_get_trace_frame():Int32 {
+		return 0;
+	}
+
+	public static function pxlio_write_trace(path:String, firstFrame:Int32, lastFrame:Int32) {}
+
+	public static function pxlio_start_capture(path:String, frameCount:Int32) {}
+
+	public static function pxlio_stop_capture() {}
+
+	public static function pxlio_start_input_recording(path:String):Bool {
+		return false;
+	}
+
+	public static function pxlio_stop_input_recording() {}
+
+	public static function pxlio_start_input_replay(path:String) {}
+
+	public static function pxlio_is_replaying_input():Bool {
+		return false;
+	}
+
+	public static function pxlio_set_fixed_delta_time(seconds:Single) {}
+
 	public static function pxlio_audio_constructor(path:String):Int32 {
 		return 0;
 	}
@@ -0,0 +1,11 @@
+package pxlio;
+
+import haxe.Int32;
+
+class RendererBackend {
+	public static inline var Default:Int32 = 0;
+	public static inline var Vulkan:Int32 = 1;
+	public static inline var OpenGL:Int32 = 2;
+	public static inline var Software:Int32 = 3;
+	public static inline var Null:Int32 = 4;
+}
@@ -3,18 +3,164 @@ package pxlio;
 import haxe.Int32;
 
 class SpriteBatch {
+	// Seventeen floats per sprite, see addMany.
+	public static inline var packedSpriteSize:Int32 = 68;
+
+	// Ten floats for each of four vertices per sprite, see mapVertices.
+	public static inline var mappedSpriteSize:Int32 = 160;
+
+	static inline var initialQueueCapacity:Int32 = 64;
+
 	public final id:Int32;
+	public final textureWidth:Int32;
+	public final textureHeight:Int32;
+
+	var queuedSprites:hl.Bytes = null;
+	var queuedCapacity:Int32 = 0;
+	var queuedCount:Int32 = 0;
 
 	public function new(id:Int32) {
 		this.id = id;
+		textureWidth = PxlIOBindings.pxlio_sprite_batch_get_texture_width(id);
+		textureHeight = PxlIOBindings.pxlio_sprite_batch_get_texture_height(id);
 	}
 
 	public function clear() {
+		queuedCount = 0;
 		PxlIOBindings.pxlio_sprite_batch_clear(this.id);
 	}
 
+	// Sprites dropped over the batch's whole lifetime because it was already holding maxSprites.
+	public function getOverflowCount():Int32 {
+		return PxlIOBindings.pxlio_sprite_batch_get_overflow_count(id);
+	}
+
+	// Lets the batch halve its capacity after it has used little of it for a while.
+	public function setShrinkEnabled(enabled:Bool) {
+		PxlIOBindings.pxlio_sprite_batch_set_shrink_enabled(id, enabled);
+	}
+
 	public function add(x:Single, y:Single, z:Single, sprite:Sprite) {
 		PxlIOBindings.pxlio_sprite_batch_add(id, x, y, z, sprite.width, sprite.height, sprite.texX, sprite.texY, sprite.texWidth, sprite.texHeight,
 			sprite.originX, sprite.originY, sprite.rotation, sprite.r, sprite.g, sprite.b, sprite.a, sprite.tint);
 	}
-}
+
+	// Like add, but the sprite is only packed into a buffer on the Haxe side, and the whole buffer is added in one call
+	// when the batch is drawn or flushQueued is called. Much cheaper than add for batches with many sprites. Queued
+	// sprites are added after any sprites that were added directly since the last flush.
+	public function queue(x:Single, y:Single, z:Single, sprite:Sprite) {
+		if (queuedCount == queuedCapacity) {
+			growQueue();
+		}
+
+		var offset = queuedCount * packedSpriteSize;
+		queuedSprites.setF32(offset, x);
+		queuedSprites.setF32(offset + 4, y);
+		queuedSprites.setF32(offset + 8, z);
+		queuedSprites.setF32(offset + 12, sprite.width);
+		queuedSprites.setF32(offset + 16, sprite.height);
+		queuedSprites.setF32(offset + 20, sprite.texX);
+		queuedSprites.setF32(offset + 24, sprite.texY);
+		queuedSprites.setF32(offset + 28, sprite.texWidth);
+		queuedSprites.setF32(offset + 32, sprite.texHeight);
+		queuedSprites.setF32(offset + 36, sprite.originX);
+		queuedSprites.setF32(offset + 40, sprite.originY);
+		queuedSprites.setF32(offset + 44, sprite.rotation);
+		queuedSprites.setF32(offset + 48, sprite.r);
+		queuedSprites.setF32(offset + 52, sprite.g);
+		queuedSprites.setF32(offset + 56, sprite.b);
+		queuedSprites.setF32(offset + 60, sprite.a);
+		queuedSprites.setF32(offset + 64, sprite.tint);
+		queuedCount++;
+	}
+
+	public function flushQueued() {
+		if (queuedCount == 0) {
+			return;
+		}
+
+		addMany(queuedSprites, queuedCount);
+		queuedCount = 0;
+	}
+
+	// Adds count sprites packed as packedSpriteSize bytes each, the floats x, y, z, width, height, texX, texY, texWidth,
+	// texHeight, originX, originY, rotation, r, g, b, a and tint in that order.
+	public function addMany(records:hl.Bytes, count:Int32) {
+		PxlIOBindings.pxlio_sprite_batch_add_many(id, records, count);
+	}
+
+	// Returns the batch's own vertex memory for count more sprites, so that they can be written in place, for example
+	// with writeMappedSprite, and added by commitVertices without any copies. Each vertex is x, y, z, u, v, r, g, b, a
+	// and tint, with u and v from 0 to 1, and a sprite's vertices go bottom left, bottom right, top right then top
+	// left. The memory is only valid until the batch is added to, including by flushing queued sprites, cleared or
+	// mapped again. Sprites past maxSprites are dropped and counted by getOverflowCount like they are by add, so check
+	// getMappedSpriteCount before writing, it's null if none fit.
+	public function mapVertices(count:Int32):hl.Bytes {
+		return PxlIOBindings.pxlio_sprite_batch_map_vertices(id, count);
+	}
+
+	// How many sprites the memory returned by the last mapVertices has room for.
+	public function getMappedSpriteCount():Int32 {
+		return PxlIOBindings.pxlio_sprite_batch_get_mapped_sprite_count(id);
+	}
+
+	// Adds the first count sprites written to the memory returned by mapVertices.
+	public function commitVertices(count:Int32) {
+		PxlIOBindings.pxlio_sprite_batch_commit_vertices(id, count);
+	}
+
+	// Writes the vertices that add would create for the sprite, index counts sprites from the start of vertices.
+	public function writeMappedSprite(vertices:hl.Bytes, index:Int32, x:Single, y:Single, z:Single, sprite:Sprite) {
+		var radians = sprite.rotation * Math.PI / 180;
+		var cos:Single = Math.cos(radians);
+		var sin:Single = Math.sin(radians);
+		var u0:Single = sprite.texX / textureWidth;
+		var v0:Single = sprite.texY / textureHeight;
+		var u1:Single = (sprite.texX + sprite.texWidth) / textureWidth;
+		var v1:Single = (sprite.texY + sprite.texHeight) / textureHeight;
+		var offset = index * mappedSpriteSize;
+
+		writeMappedVertex(vertices, offset, x, y, z, 0, 0, u0, v1, sprite, cos, sin);
+		writeMappedVertex(vertices, offset + 40, x, y, z, 1, 0, u1, v1, sprite, cos, sin);
+		writeMappedVertex(vertices, offset + 80, x, y, z, 1, 1, u1, v0, sprite, cos, sin);
+		writeMappedVertex(vertices, offset + 120, x, y, z, 0, 1, u0, v0, sprite, cos, sin);
+	}
+
+	inline function writeMappedVertex(vertices:hl.Bytes, offset:Int32, x:Single, y:Single, z:Single, cornerX:Single, cornerY:Single,
+			u:Single, v:Single, sprite:Sprite, cos:Single, sin:Single) {
+		// Rotated around the origin the same way as the native SpriteBatch.add.
+		var originOffsetX = cornerX - sprite.originX;
+		var originOffsetY = cornerY - sprite.originY;
+		var vertexX = originOffsetX * cos + originOffsetY * sin + sprite.originX;
+		var vertexY = -originOffsetX * sin + originOffsetY * cos + sprite.originY;
+
+		vertices.setF32(offset, x + vertexX * sprite.width);
+		vertices.setF32(offset + 4, y + vertexY * sprite.height);
+		vertices.setF32(offset + 8, z);
+		vertices.setF32(offset + 12, u);
+		vertices.setF32(offset + 16, v);
+		vertices.setF32(offset + 20, sprite.r);
+		vertices.setF32(offset + 24, sprite.g);
+		vertices.setF32(offset + 28, sprite.b);
+		vertices.setF32(offset + 32, sprite.a);
+		vertices.setF32(offset + 36, sprite.tint);
+	}
+
+	function growQueue() {
+		var newCapacity = queuedCapacity == 0 ? initialQueueCapacity : queuedCapacity * 2;
+		var newQueuedSprites = new hl.Bytes(newCapacity * packedSpriteSize);
+
+		if (queuedCount > 0) {
+			newQueuedSprites.blit(0, queuedSprites, 0, queuedCount * packedSpriteSize);
+		}
+
+		queuedSprites = newQueuedSprites;
+		queuedCapacity = newCapacity;
+	}
+
+	// Draws the recent frame times of a FrameTimeKind as one bar per frame, texX and texY should point at an opaque texel.
+	public function addFrameTimeGraph(kind:Int32, x:Single, y:Single, z:Single, barCount:Int32, height:Single, maxMs:Single, texX:Single,
+			texY:Single) {
+		PxlIOBindings.pxlio_sprite_batch_add_frame_time_graph(id, kind, x, y, z, barCount, height, maxMs, texX, texY);
+	}
+}
\ No newline at end of file
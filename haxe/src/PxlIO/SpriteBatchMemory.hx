@@ -0,0 +1,18 @@
+package pxlio;
+
+import haxe.Int32;
+
+class SpriteBatchMemory {
+	public var spriteBatchId: Int32;
+	public var maxSprites: Int32;
+	public var capacity: Int32;
+	public var peakSprites: Int32;
+	public var cpuVertexBytes: Float;
+	public var cpuIndexBytes: Float;
+	public var gpuBufferBytes: Float;
+	public var textureBytes: Float;
+
+	public function new() {
+
+	}
+}
@@ -0,0 +1,152 @@
+#include "AllocationTracker.hpp"
+
+#ifdef PXLIO_TRACK_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+// Everything here is constant initialized, so operator new can use it before any constructors have run.
+static thread_local bool isTracking = false;
+static thread_local const char *currentSite = nullptr;
+static thread_local AllocationReport currentReport;
+static thread_local AllocationReport lastReport;
+
+void AllocationTracker::Begin()
+{
+    currentReport = AllocationReport{};
+    isTracking = true;
+}
+
+void AllocationTracker::End()
+{
+    isTracking = false;
+    lastReport = currentReport;
+}
+
+const AllocationReport &AllocationTracker::GetLastReport()
+{
+    return lastReport;
+}
+
+void AllocationTracker::Record(size_t byteSize)
+{
+    if (!isTracking)
+    {
+        return;
+    }
+
+    ++currentReport.count;
+    currentReport.byteSize += byteSize;
+
+#ifndef NDEBUG
+    uint32_t siteIndex = 0;
+    while (siteIndex < currentReport.siteCount && currentReport.sites[siteIndex].name != currentSite)
+    {
+        ++siteIndex;
+    }
+
+    if (siteIndex == currentReport.siteCount)
+    {
+        if (currentReport.siteCount < maxAllocationSites)
+        {
+            currentReport.sites[siteIndex].name = currentSite;
+            ++currentReport.siteCount;
+        }
+        else
+        {
+            siteIndex = maxAllocationSites - 1;
+        }
+    }
+
+    ++currentReport.sites[siteIndex].count;
+    currentReport.sites[siteIndex].byteSize += byteSize;
+#endif
+}
+
+const char *AllocationTracker::SetSite(const char *name)
+{
+    const char *previousSite = currentSite;
+    currentSite = name;
+
+    return previousSite;
+}
+
+static void *Allocate(size_t byteSize)
+{
+    AllocationTracker::Record(byteSize);
+
+    // Zero sized allocations still have to return a unique pointer.
+    return std::malloc(byteSize == 0 ? 1 : byteSize);
+}
+
+void *operator new(size_t byteSize)
+{
+    void *pointer = Allocate(byteSize);
+
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+void *operator new[](size_t byteSize)
+{
+    return operator new(byteSize);
+}
+
+void *operator new(size_t byteSize, const std::nothrow_t &) noexcept
+{
+    return Allocate(byteSize);
+}
+
+void *operator new[](size_t byteSize, const std::nothrow_t &) noexcept
+{
+    return Allocate(byteSize);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+#else
+static AllocationReport emptyReport;
+
+void AllocationTracker::Begin()
+{
+}
+
+void AllocationTracker::End()
+{
+}
+
+const AllocationReport &AllocationTracker::GetLastReport()
+{
+    return emptyReport;
+}
+#endif
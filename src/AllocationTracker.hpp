@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+
+struct AllocationSite
+{
+    // The innermost trace zone that was active, null for allocations made outside of any zone.
+    const char *name = nullptr;
+    uint64_t count = 0;
+    uint64_t byteSize = 0;
+};
+
+// Zones past this many in one tracking window are all counted in the last site.
+const uint32_t maxAllocationSites = 64;
+
+struct AllocationReport
+{
+    uint64_t count = 0;
+    uint64_t byteSize = 0;
+    // Only filled in debug builds.
+    std::array<AllocationSite, maxAllocationSites> sites{};
+    uint32_t siteCount = 0;
+};
+
+// Counts the heap allocations made through operator new on the calling thread between Begin and End. Only does
+// anything when building with PXLIO_TRACK_ALLOCATIONS, which replaces the global operator new and delete, the
+// reports are empty otherwise. Over-aligned allocations use the default operators, so they aren't counted.
+class AllocationTracker
+{
+  public:
+    static void Begin();
+    static void End();
+    // What the calling thread allocated during its last tracking window.
+    static const AllocationReport &GetLastReport();
+
+    static constexpr bool GetEnabled()
+    {
+#ifdef PXLIO_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef PXLIO_TRACK_ALLOCATIONS
+    // Called from operator new, so it must not allocate.
+    static void Record(size_t byteSize);
+    // Returns the previous site, so that scopes can restore it.
+    static const char *SetSite(const char *name);
+#endif
+};
+
+#if defined(PXLIO_TRACK_ALLOCATIONS) && !defined(NDEBUG)
+class AllocationSiteScope
+{
+  public:
+    // The name has to outlive the report, so it should be a string literal.
+    AllocationSiteScope(const char *name) : previousName(AllocationTracker::SetSite(name))
+    {
+    }
+
+    ~AllocationSiteScope()
+    {
+        AllocationTracker::SetSite(previousName);
+    }
+
+  private:
+    const char *previousName;
+};
+#endif
@@ -0,0 +1,664 @@
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../PxlIO.hpp"
+
+// Runs scripted scenarios for a fixed number of frames with vsync off, then writes frame time percentiles and
+// averaged renderer stats as JSON so that backends and releases can be compared.
+
+const int32_t benchmarkWindowWidth = 640;
+const int32_t benchmarkWindowHeight = 480;
+const int32_t benchmarkViewWidth = 320;
+const int32_t benchmarkViewHeight = 240;
+const int32_t benchmarkTileSize = 16;
+const char *benchmarkTexturePath = "res/tiles.png";
+
+struct BenchmarkOptions
+{
+    RendererBackend backend = RendererBackendOpenGL;
+    uint32_t frameCount = 600;
+    // Frames run before measuring, so that pipelines, buffers and driver caches are warm.
+    uint32_t warmupFrameCount = 60;
+    // Empty runs every scenario.
+    std::string scenarioName;
+    // Empty writes to stdout.
+    std::string outputPath;
+    bool headless = false;
+    // Fails the run if any measured frame made a heap allocation, needs PXLIO_TRACK_ALLOCATIONS.
+    bool requireZeroAllocations = false;
+};
+
+// Deterministic so that every run draws exactly the same frames.
+static float CalcNoise(uint32_t i)
+{
+    i = i * 747796405u + 2891336453u;
+    i = ((i >> ((i >> 28) + 4)) ^ i) * 277803737u;
+    i = (i >> 22) ^ i;
+
+    return i / static_cast<float>(UINT32_MAX);
+}
+
+static Sprite CreateTileSprite()
+{
+    Sprite sprite;
+    sprite.width = sprite.height = benchmarkTileSize;
+    sprite.texWidth = sprite.texHeight = benchmarkTileSize;
+
+    return sprite;
+}
+
+class BenchmarkScenario
+{
+  public:
+    virtual ~BenchmarkScenario() {}
+
+    virtual const char *GetName() = 0;
+    virtual void Create(Renderer &rend) = 0;
+    // Called between BeginDrawing and EndDrawing.
+    virtual void Draw(Renderer &rend, uint32_t frame) = 0;
+
+    void Destroy(Renderer &rend)
+    {
+        for (SpriteBatch *spriteBatch : spriteBatches)
+        {
+            rend.DestroySpriteBatch(*spriteBatch);
+        }
+
+        spriteBatches.clear();
+    }
+
+  protected:
+    // Owned by the renderer.
+    std::vector<SpriteBatch *> spriteBatches;
+};
+
+// Layers of tiles covering the whole view that never change, the cheapest case for the CPU.
+class StaticTilesScenario : public BenchmarkScenario
+{
+  public:
+    const char *GetName() override
+    {
+        return "static_tiles";
+    }
+
+    void Create(Renderer &rend) override
+    {
+        spriteBatches.push_back(&rend.CreateSpriteBatch(benchmarkTexturePath, columnCount * rowCount * layerCount));
+    }
+
+    void Draw(Renderer &rend, uint32_t frame) override
+    {
+        SpriteBatch &spriteBatch = *spriteBatches[0];
+        spriteBatch.Clear();
+
+        Sprite sprite = CreateTileSprite();
+
+        for (uint32_t layer = 0; layer < layerCount; layer++)
+        {
+            for (uint32_t y = 0; y < rowCount; y++)
+            {
+                for (uint32_t x = 0; x < columnCount; x++)
+                {
+                    float tileX = static_cast<float>(x * benchmarkTileSize);
+                    float tileY = static_cast<float>(y * benchmarkTileSize);
+                    spriteBatch.Add(tileX, tileY, static_cast<float>(layer), sprite);
+                }
+            }
+        }
+
+        rend.DrawSpriteBatch(spriteBatch);
+    }
+
+  private:
+    static const uint32_t columnCount = benchmarkViewWidth / benchmarkTileSize;
+    static const uint32_t rowCount = benchmarkViewHeight / benchmarkTileSize;
+    static const uint32_t layerCount = 32;
+};
+
+// Sprites that move and rotate every frame, which takes the rotated path through SpriteBatch::Add.
+class MovingSpritesScenario : public BenchmarkScenario
+{
+  public:
+    const char *GetName() override
+    {
+        return "moving_sprites";
+    }
+
+    void Create(Renderer &rend) override
+    {
+        spriteBatches.push_back(&rend.CreateSpriteBatch(benchmarkTexturePath, spriteCount));
+    }
+
+    void Draw(Renderer &rend, uint32_t frame) override
+    {
+        SpriteBatch &spriteBatch = *spriteBatches[0];
+        spriteBatch.Clear();
+
+        Sprite sprite = CreateTileSprite();
+        sprite.originX = sprite.originY = 0.5f;
+
+        for (uint32_t i = 0; i < spriteCount; i++)
+        {
+            float speed = 0.5f + CalcNoise(i * 4) * 2.0f;
+            float x = CalcNoise(i * 4 + 1) * benchmarkViewWidth + frame * speed;
+            float y = CalcNoise(i * 4 + 2) * benchmarkViewHeight + frame * speed * 0.5f;
+
+            sprite.rotation = CalcNoise(i * 4 + 3) * 360.0f + frame * speed;
+            spriteBatch.Add(std::fmod(x, static_cast<float>(benchmarkViewWidth)),
+                            std::fmod(y, static_cast<float>(benchmarkViewHeight)), 0.0f, sprite);
+        }
+
+        rend.DrawSpriteBatch(spriteBatch);
+    }
+
+  private:
+    static const uint32_t spriteCount = 10000;
+};
+
+// Small translucent tinted sprites in a blended batch, which stresses fill rate and the blended pipeline.
+class BlendedParticlesScenario : public BenchmarkScenario
+{
+  public:
+    const char *GetName() override
+    {
+        return "blended_particles";
+    }
+
+    void Create(Renderer &rend) override
+    {
+        spriteBatches.push_back(&rend.CreateSpriteBatch(benchmarkTexturePath, particleCount, false, true));
+    }
+
+    void Draw(Renderer &rend, uint32_t frame) override
+    {
+        SpriteBatch &spriteBatch = *spriteBatches[0];
+        spriteBatch.Clear();
+
+        Sprite sprite = CreateTileSprite();
+        sprite.width = sprite.height = 4.0f;
+        sprite.tint = 0.5f;
+
+        for (uint32_t i = 0; i < particleCount; i++)
+        {
+            // Each particle lives for particleLifetime frames, then respawns at the center.
+            uint32_t age = (frame + i) % particleLifetime;
+            float angle = CalcNoise(i * 3) * 6.2831853f;
+            float distance = age * (0.5f + CalcNoise(i * 3 + 1) * 2.0f);
+
+            sprite.r = CalcNoise(i * 3 + 2);
+            sprite.g = 1.0f - sprite.r;
+            sprite.b = 1.0f;
+            sprite.a = 1.0f - age / static_cast<float>(particleLifetime);
+            spriteBatch.Add(benchmarkViewWidth * 0.5f + std::cos(angle) * distance,
+                            benchmarkViewHeight * 0.5f + std::sin(angle) * distance, 1.0f, sprite);
+        }
+
+        rend.DrawSpriteBatch(spriteBatch);
+    }
+
+  private:
+    static const uint32_t particleCount = 20000;
+    static const uint32_t particleLifetime = 120;
+};
+
+// Many batches with only a few sprites each, where per draw overhead dominates.
+class SmallBatchesScenario : public BenchmarkScenario
+{
+  public:
+    const char *GetName() override
+    {
+        return "small_batches";
+    }
+
+    void Create(Renderer &rend) override
+    {
+        for (uint32_t i = 0; i < batchCount; i++)
+        {
+            spriteBatches.push_back(&rend.CreateSpriteBatch(benchmarkTexturePath, spritesPerBatch));
+        }
+    }
+
+    void Draw(Renderer &rend, uint32_t frame) override
+    {
+        Sprite sprite = CreateTileSprite();
+
+        for (uint32_t i = 0; i < batchCount; i++)
+        {
+            SpriteBatch &spriteBatch = *spriteBatches[i];
+            spriteBatch.Clear();
+
+            for (uint32_t j = 0; j < spritesPerBatch; j++)
+            {
+                uint32_t k = i * spritesPerBatch + j;
+                spriteBatch.Add(CalcNoise(k * 2) * benchmarkViewWidth, CalcNoise(k * 2 + 1) * benchmarkViewHeight,
+                                static_cast<float>(i % 16), sprite);
+            }
+
+            rend.DrawSpriteBatch(spriteBatch);
+        }
+    }
+
+  private:
+    static const uint32_t batchCount = 256;
+    static const uint32_t spritesPerBatch = 32;
+};
+
+// Replaces the oldest batch with a new one every frame, measuring the cost of creating and destroying batches,
+// including loading their textures, while others are still in flight.
+class BatchChurnScenario : public BenchmarkScenario
+{
+  public:
+    const char *GetName() override
+    {
+        return "batch_churn";
+    }
+
+    void Create(Renderer &rend) override
+    {
+        for (uint32_t i = 0; i < liveBatchCount; i++)
+        {
+            spriteBatches.push_back(&rend.CreateSpriteBatch(benchmarkTexturePath, spritesPerBatch));
+        }
+
+        oldestBatch = 0;
+    }
+
+    void Draw(Renderer &rend, uint32_t frame) override
+    {
+        rend.DestroySpriteBatch(*spriteBatches[oldestBatch]);
+        spriteBatches[oldestBatch] = &rend.CreateSpriteBatch(benchmarkTexturePath, spritesPerBatch);
+        oldestBatch = (oldestBatch + 1) % liveBatchCount;
+
+        Sprite sprite = CreateTileSprite();
+
+        for (uint32_t i = 0; i < liveBatchCount; i++)
+        {
+            SpriteBatch &spriteBatch = *spriteBatches[i];
+            spriteBatch.Clear();
+
+            for (uint32_t j = 0; j < spritesPerBatch; j++)
+            {
+                uint32_t k = (frame + i) * spritesPerBatch + j;
+                spriteBatch.Add(CalcNoise(k * 2) * benchmarkViewWidth, CalcNoise(k * 2 + 1) * benchmarkViewHeight,
+                                0.0f, sprite);
+            }
+
+            rend.DrawSpriteBatch(spriteBatch);
+        }
+    }
+
+  private:
+    static const uint32_t liveBatchCount = 16;
+    static const uint32_t spritesPerBatch = 256;
+
+    uint32_t oldestBatch = 0;
+};
+
+// Totals over every measured frame, divided by the frame count when written.
+struct BenchmarkStats
+{
+    uint64_t spritesSubmitted = 0;
+    uint64_t spritesCulled = 0;
+    uint64_t drawCalls = 0;
+    uint64_t pipelineBinds = 0;
+    uint64_t textureBinds = 0;
+    uint64_t bytesUploaded = 0;
+    uint64_t buffersAllocated = 0;
+    uint64_t heapAllocations = 0;
+    uint64_t heapAllocatedBytes = 0;
+
+    void Add(const FrameStats &frameStats)
+    {
+        spritesSubmitted += frameStats.spritesSubmitted;
+        spritesCulled += frameStats.spritesCulled;
+        drawCalls += frameStats.drawCalls;
+        pipelineBinds += frameStats.pipelineBinds;
+        textureBinds += frameStats.textureBinds;
+        bytesUploaded += frameStats.bytesUploaded;
+        buffersAllocated += frameStats.buffersAllocated;
+        heapAllocations += frameStats.heapAllocations;
+        heapAllocatedBytes += frameStats.heapAllocatedBytes;
+    }
+};
+
+enum BenchmarkTimeKind
+{
+    // Wall time of the whole frame, from BeginDrawing to BeginDrawing.
+    BenchmarkTimeKindFrame,
+    // Same as FrameTimeKindCpu.
+    BenchmarkTimeKindCpu,
+    // Same as FrameTimeKindGpu.
+    BenchmarkTimeKindGpu,
+};
+
+const uint32_t benchmarkTimeKindCount = 3;
+const char *benchmarkTimeKindNames[benchmarkTimeKindCount] = {"frame", "cpu", "gpu"};
+
+struct BenchmarkResult
+{
+    std::string name;
+    float totalMs = 0.0f;
+    std::vector<FrameTimePercentiles> percentiles;
+    BenchmarkStats stats;
+    MemoryReport memoryReport;
+};
+
+static float CalcElapsedMs(std::chrono::steady_clock::time_point startTime)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+static bool PollQuit()
+{
+    // The window still has to pump events, even when nobody can see it.
+    bool hasQuit = false;
+
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        if (event.type == SDL_QUIT)
+        {
+            hasQuit = true;
+        }
+    }
+
+    return hasQuit;
+}
+
+static BenchmarkResult RunScenario(Renderer &rend, BenchmarkScenario &scenario, const BenchmarkOptions &options)
+{
+    BenchmarkResult result;
+    result.name = scenario.GetName();
+
+    // Sized to hold every measured frame, so the percentiles cover the whole run rather than a rolling window.
+    std::vector<FrameTimeHistogram> histograms(benchmarkTimeKindCount, FrameTimeHistogram(options.frameCount));
+
+    scenario.Create(rend);
+
+    uint32_t totalFrameCount = options.warmupFrameCount + options.frameCount;
+    uint64_t lastGpuFrame = rend.GetGpuTimings().frame;
+    auto runStartTime = std::chrono::steady_clock::now();
+
+    for (uint32_t frame = 0; frame < totalFrameCount; frame++)
+    {
+        if (PollQuit())
+        {
+            break;
+        }
+
+        bool isMeasured = frame >= options.warmupFrameCount;
+
+        if (frame == options.warmupFrameCount)
+        {
+            runStartTime = std::chrono::steady_clock::now();
+        }
+
+        auto frameStartTime = std::chrono::steady_clock::now();
+
+        rend.BeginDrawing();
+        scenario.Draw(rend, frame);
+        rend.EndDrawing();
+
+        float frameMs = CalcElapsedMs(frameStartTime);
+
+        if (!isMeasured)
+        {
+            lastGpuFrame = rend.GetGpuTimings().frame;
+            continue;
+        }
+
+        const FrameStats &frameStats = rend.GetFrameStats();
+        float blockedMs = frameStats.fenceWaitMs + frameStats.acquireMs + frameStats.presentMs;
+
+        histograms[BenchmarkTimeKindFrame].Add(frameMs);
+        histograms[BenchmarkTimeKindCpu].Add(frameMs - blockedMs);
+        result.stats.Add(frameStats);
+
+        // GPU timings lag behind, so only new ones are counted, and only if they were recorded after warming up.
+        const GpuTimings &gpuTimings = rend.GetGpuTimings();
+        if (gpuTimings.valid && gpuTimings.frame != lastGpuFrame)
+        {
+            histograms[BenchmarkTimeKindGpu].Add(gpuTimings.viewPassMs + gpuTimings.compositePassMs);
+            lastGpuFrame = gpuTimings.frame;
+        }
+    }
+
+    result.totalMs = CalcElapsedMs(runStartTime);
+
+    for (FrameTimeHistogram &histogram : histograms)
+    {
+        result.percentiles.push_back(histogram.CalcPercentiles());
+    }
+
+    result.memoryReport = rend.GetMemoryReport();
+
+    scenario.Destroy(rend);
+
+    return result;
+}
+
+// The backend is the one that was created, which can differ from the requested one if it had to fall back.
+static void WriteJson(std::ostream &out, const BenchmarkOptions &options, RendererBackend backend,
+                      const PresentStatus &presentStatus, const std::vector<BenchmarkResult> &results)
+{
+    const char *presentModeNames[] = {"fifo", "fifo_relaxed", "mailbox", "immediate"};
+
+    out << "{\n";
+    out << "  \"backend\": \"" << PxlIO::GetBackendName(backend) << "\",\n";
+    out << "  \"headless\": " << (options.headless ? "true" : "false") << ",\n";
+    out << "  \"presentMode\": \"" << presentModeNames[presentStatus.presentMode] << "\",\n";
+    out << "  \"frameCount\": " << options.frameCount << ",\n";
+    out << "  \"warmupFrameCount\": " << options.warmupFrameCount << ",\n";
+    out << "  \"allocationsTracked\": " << (AllocationTracker::GetEnabled() ? "true" : "false") << ",\n";
+    out << "  \"scenarios\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &result = results[i];
+        const BenchmarkStats &stats = result.stats;
+        uint64_t frameCount = result.percentiles[BenchmarkTimeKindFrame].sampleCount;
+        double frameDivisor = frameCount > 0 ? static_cast<double>(frameCount) : 1.0;
+
+        out << "    {\n";
+        out << "      \"name\": \"" << result.name << "\",\n";
+        out << "      \"measuredFrames\": " << frameCount << ",\n";
+        out << "      \"totalMs\": " << result.totalMs << ",\n";
+
+        for (uint32_t kind = 0; kind < benchmarkTimeKindCount; kind++)
+        {
+            const FrameTimePercentiles &percentiles = result.percentiles[kind];
+
+            out << "      \"" << benchmarkTimeKindNames[kind] << "\": {\"samples\": " << percentiles.sampleCount
+                << ", \"p50Ms\": " << percentiles.p50Ms << ", \"p95Ms\": " << percentiles.p95Ms
+                << ", \"p99Ms\": " << percentiles.p99Ms << ", \"maxMs\": " << percentiles.maxMs
+                << ", \"hitches\": " << percentiles.hitchCount << "},\n";
+        }
+
+        out << "      \"averageStats\": {\"spritesSubmitted\": " << stats.spritesSubmitted / frameDivisor
+            << ", \"spritesCulled\": " << stats.spritesCulled / frameDivisor
+            << ", \"drawCalls\": " << stats.drawCalls / frameDivisor
+            << ", \"pipelineBinds\": " << stats.pipelineBinds / frameDivisor
+            << ", \"textureBinds\": " << stats.textureBinds / frameDivisor
+            << ", \"bytesUploaded\": " << stats.bytesUploaded / frameDivisor
+            << ", \"buffersAllocated\": " << stats.buffersAllocated / frameDivisor
+            << ", \"heapAllocations\": " << stats.heapAllocations / frameDivisor
+            << ", \"heapAllocatedBytes\": " << stats.heapAllocatedBytes / frameDivisor << "},\n";
+        out << "      \"memory\": {\"allocatedBytes\": " << result.memoryReport.allocatedBytes
+            << ", \"reservedBytes\": " << result.memoryReport.reservedBytes
+            << ", \"allocationCount\": " << result.memoryReport.allocationCount
+            << ", \"estimated\": " << (result.memoryReport.estimated ? "true" : "false") << "}\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n";
+    out << "}\n";
+}
+
+static void PrintUsage()
+{
+    std::cout << "Usage: PxlIOBenchmark [--backend default|vulkan|opengl|software|null] [--frames n] [--warmup n]\n"
+                 "                      [--scenario name] [--output path] [--headless] [--require-zero-allocations]\n"
+                 "Scenarios: static_tiles, moving_sprites, blended_particles, small_batches, batch_churn\n";
+}
+
+static BenchmarkOptions ParseOptions(int argc, char **argv)
+{
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--backend" && hasValue)
+        {
+            std::string backend = argv[++i];
+
+            if (!PxlIO::ParseBackend(backend, options.backend))
+            {
+                RUNTIME_ERROR("Unknown backend: " << backend);
+            }
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            options.frameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--warmup" && hasValue)
+        {
+            options.warmupFrameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--scenario" && hasValue)
+        {
+            options.scenarioName = argv[++i];
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            options.outputPath = argv[++i];
+        }
+        else if (arg == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (arg == "--require-zero-allocations")
+        {
+            options.requireZeroAllocations = true;
+        }
+        else
+        {
+            PrintUsage();
+            exit(1);
+        }
+    }
+
+    if (options.frameCount == 0)
+    {
+        RUNTIME_ERROR("Benchmarks need at least one measured frame!");
+    }
+
+    if (options.requireZeroAllocations && !AllocationTracker::GetEnabled())
+    {
+        RUNTIME_ERROR("Checking for allocations needs a build with PXLIO_TRACK_ALLOCATIONS!");
+    }
+
+    return options;
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options = ParseOptions(argc, argv);
+
+    if (options.headless)
+    {
+        // Has to be set before the renderer initializes SDL. The offscreen driver creates its GL contexts through
+        // EGL, so GL runs without a display, for example on Mesa's llvmpipe with EGL_PLATFORM=surfaceless. SDL's
+        // offscreen driver can't create Vulkan surfaces, so Vulkan needs a virtual display instead. The software
+        // backend presents to the offscreen driver's window surfaces, and the null backend never needs a display.
+        if (options.backend == RendererBackendVulkan)
+        {
+            RUNTIME_ERROR("Headless mode doesn't support Vulkan, run it under a virtual display instead!");
+        }
+
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+    }
+
+    std::vector<std::unique_ptr<BenchmarkScenario>> scenarios;
+    scenarios.push_back(std::make_unique<StaticTilesScenario>());
+    scenarios.push_back(std::make_unique<MovingSpritesScenario>());
+    scenarios.push_back(std::make_unique<BlendedParticlesScenario>());
+    scenarios.push_back(std::make_unique<SmallBatchesScenario>());
+    scenarios.push_back(std::make_unique<BatchChurnScenario>());
+
+    bool hasScenario = options.scenarioName.empty();
+    for (auto &scenario : scenarios)
+    {
+        hasScenario = hasScenario || options.scenarioName == scenario->GetName();
+    }
+
+    if (!hasScenario)
+    {
+        RUNTIME_ERROR("Unknown scenario: " << options.scenarioName);
+    }
+
+    PresentConfig presentConfig;
+    presentConfig.presentMode = PresentModeImmediate;
+    presentConfig.targetFps = 0;
+
+    std::unique_ptr<Renderer> rend = PxlIO::Create(options.backend, "PxlIO Benchmark", benchmarkWindowWidth,
+                                                   benchmarkWindowHeight, benchmarkViewWidth, benchmarkViewHeight,
+                                                   presentConfig);
+
+    rend->SetBackgroundColor(0, 0, 0.2f);
+    rend->SetScreenBackgroundColor(0, 0, 0);
+
+    std::vector<BenchmarkResult> results;
+
+    for (auto &scenario : scenarios)
+    {
+        if (!options.scenarioName.empty() && options.scenarioName != scenario->GetName())
+        {
+            continue;
+        }
+
+        std::cerr << "Running " << scenario->GetName() << "...\n";
+        results.push_back(RunScenario(*rend, *scenario, options));
+    }
+
+    PresentStatus presentStatus = rend->GetPresentStatus();
+
+    if (options.outputPath.empty())
+    {
+        WriteJson(std::cout, options, rend->GetBackend(), presentStatus, results);
+    }
+    else
+    {
+        std::ofstream file(options.outputPath);
+
+        if (!file.is_open())
+        {
+            RUNTIME_ERROR("Failed to open benchmark output: " << options.outputPath);
+        }
+
+        WriteJson(file, options, rend->GetBackend(), presentStatus, results);
+    }
+
+    // Warmup frames aren't measured, so only steady state frames are checked.
+    bool hasAllocated = false;
+
+    for (const BenchmarkResult &result : results)
+    {
+        if (options.requireZeroAllocations && result.stats.heapAllocations > 0)
+        {
+            std::cerr << result.name << " made " << result.stats.heapAllocations << " heap allocations ("
+                      << result.stats.heapAllocatedBytes << " bytes) in its measured frames\n";
+            hasAllocated = true;
+        }
+    }
+
+    return hasAllocated ? 1 : 0;
+}
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../ImageLoader.hpp"
+#include "../Input.hpp"
+#include "../Renderer.hpp"
+#include "../SpriteBatch.hpp"
+#include "../SpriteBatchPool.hpp"
+
+// Times CPU side hot paths in isolation, without a window or GPU. Each benchmark runs a number of samples, each
+// sample calls the operation enough times to take roughly microbenchmarkSampleMs, and the results are reported as
+// nanoseconds per operation with their spread across samples.
+
+const float microbenchmarkSampleMs = 10.0f;
+const uint32_t microbenchmarkSpriteCount = 4096;
+const char *microbenchmarkImagePath = "res/tiles.png";
+
+struct MicrobenchmarkOptions
+{
+    uint32_t sampleCount = 20;
+    // Samples run and thrown away first, so that caches and branch predictors are warm.
+    uint32_t warmupSampleCount = 3;
+    // Calls per sample, zero picks a count that takes roughly microbenchmarkSampleMs.
+    uint64_t iterationCount = 0;
+    // Only benchmarks with names containing this are run.
+    std::string filter;
+};
+
+struct MicrobenchmarkResult
+{
+    uint64_t iterationCount = 0;
+    double meanNs = 0.0;
+    double stdDevNs = 0.0;
+    double minNs = 0.0;
+    double medianNs = 0.0;
+};
+
+// Makes the compiler treat the value as used, so that the work producing it can't be optimized away.
+template <typename T> static void KeepValue(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "m"(value) : "memory");
+#else
+    static const void *volatile sink;
+    sink = &value;
+#endif
+}
+
+template <typename F> static double CalcSampleNs(F &operation, uint64_t iterationCount)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < iterationCount; i++)
+    {
+        operation(i);
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+template <typename F>
+static MicrobenchmarkResult RunMicrobenchmark(const MicrobenchmarkOptions &options, F operation)
+{
+    MicrobenchmarkResult result;
+    result.iterationCount = options.iterationCount;
+
+    if (result.iterationCount == 0)
+    {
+        // Doubles the count until one sample is long enough for the clock's resolution not to matter.
+        result.iterationCount = 1;
+
+        while (result.iterationCount < (1ull << 32))
+        {
+            double sampleNs = CalcSampleNs(operation, result.iterationCount);
+
+            if (sampleNs >= microbenchmarkSampleMs * 1000000.0 * 0.5)
+            {
+                result.iterationCount = std::max<uint64_t>(
+                    1, static_cast<uint64_t>(result.iterationCount * microbenchmarkSampleMs * 1000000.0 / sampleNs));
+                break;
+            }
+
+            result.iterationCount *= 2;
+        }
+    }
+
+    for (uint32_t i = 0; i < options.warmupSampleCount; i++)
+    {
+        CalcSampleNs(operation, result.iterationCount);
+    }
+
+    std::vector<double> samples(options.sampleCount);
+
+    for (uint32_t i = 0; i < options.sampleCount; i++)
+    {
+        samples[i] = CalcSampleNs(operation, result.iterationCount) / result.iterationCount;
+        result.meanNs += samples[i];
+    }
+
+    result.meanNs /= options.sampleCount;
+
+    for (double sample : samples)
+    {
+        result.stdDevNs += (sample - result.meanNs) * (sample - result.meanNs);
+    }
+
+    result.stdDevNs = std::sqrt(result.stdDevNs / options.sampleCount);
+
+    std::sort(samples.begin(), samples.end());
+    result.minNs = samples[0];
+    result.medianNs = samples[samples.size() / 2];
+
+    return result;
+}
+
+class MicrobenchmarkRunner
+{
+  public:
+    MicrobenchmarkRunner(const MicrobenchmarkOptions &options) : options(options)
+    {
+        std::cout << std::left << std::setw(40) << "Benchmark" << std::right << std::setw(12) << "ns/op"
+                  << std::setw(12) << "stddev" << std::setw(10) << "cv" << std::setw(12) << "min" << std::setw(12)
+                  << "median" << std::setw(14) << "iterations" << "\n";
+    }
+
+    template <typename F> void Run(const std::string &name, F operation)
+    {
+        if (name.find(options.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        MicrobenchmarkResult result = RunMicrobenchmark(options, operation);
+        double cv = result.meanNs > 0.0 ? result.stdDevNs / result.meanNs * 100.0 : 0.0;
+
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << result.meanNs << std::setw(12) << result.stdDevNs << std::setw(9) << cv << "%"
+                  << std::setw(12) << result.minNs << std::setw(12) << result.medianNs << std::setw(14)
+                  << result.iterationCount << "\n";
+    }
+
+  private:
+    MicrobenchmarkOptions options;
+};
+
+static Sprite CreateSprite()
+{
+    Sprite sprite;
+    sprite.width = sprite.height = 16.0f;
+    sprite.texWidth = sprite.texHeight = 16.0f;
+
+    return sprite;
+}
+
+static void RunSpriteBatchBenchmarks(MicrobenchmarkRunner &runner)
+{
+    SpriteBatch spriteBatch(0, 256, 256, microbenchmarkSpriteCount);
+
+    auto addSprite = [&](uint64_t i, const Sprite &sprite) {
+        if (spriteBatch.GetSpriteCount() == microbenchmarkSpriteCount)
+        {
+            spriteBatch.Clear();
+        }
+
+        spriteBatch.Add(static_cast<float>(i % 320), static_cast<float>(i % 240), 0.0f, sprite);
+        KeepValue(spriteBatch.GetVertices()[0]);
+    };
+
+    Sprite unrotatedSprite = CreateSprite();
+    runner.Run("SpriteBatch::Add unrotated", [&](uint64_t i) { addSprite(i, unrotatedSprite); });
+
+    Sprite rotatedSprite = CreateSprite();
+    rotatedSprite.originX = rotatedSprite.originY = 0.5f;
+    rotatedSprite.rotation = 30.0f;
+    runner.Run("SpriteBatch::Add rotated", [&](uint64_t i) { addSprite(i, rotatedSprite); });
+
+    Sprite tintedSprite = CreateSprite();
+    tintedSprite.r = 1.0f;
+    tintedSprite.g = 0.5f;
+    tintedSprite.b = 0.0f;
+    tintedSprite.a = 0.75f;
+    tintedSprite.tint = 0.5f;
+    runner.Run("SpriteBatch::Add tinted", [&](uint64_t i) { addSprite(i, tintedSprite); });
+}
+
+static void RunViewTransformBenchmarks(MicrobenchmarkRunner &runner)
+{
+    runner.Run("Renderer::CalcViewTransform", [](uint64_t i) {
+        // Varies the window size so that the result can't be computed once and reused.
+        int32_t windowWidth = 640 + static_cast<int32_t>(i % 1024);
+        int32_t windowHeight = 480 + static_cast<int32_t>(i % 768);
+
+        ViewTransform viewTransform = Renderer::CalcViewTransform(windowWidth, windowHeight, 320, 240);
+        KeepValue(viewTransform);
+    });
+}
+
+static void RunInputBenchmarks(MicrobenchmarkRunner &runner)
+{
+    const KeyCode keyCodes[] = {KeyW, KeyA, KeyS, KeyD, KeySpace, KeyEscape, KeyUp, KeyDown};
+    const uint32_t keyCodeCount = sizeof(keyCodes) / sizeof(keyCodes[0]);
+
+    Input input;
+    // Half of the keys are held, so that queries hit both the found and the missing path.
+    for (uint32_t i = 0; i < keyCodeCount; i += 2)
+    {
+        input.UpdateStateKeyDown(keyCodes[i]);
+    }
+
+    input.UpdateStateMouseDown(MouseButtonLeft);
+
+    runner.Run("Input::IsKeyHeld", [&](uint64_t i) { KeepValue(input.IsKeyHeld(keyCodes[i % keyCodeCount])); });
+    runner.Run("Input::WasKeyPressed",
+               [&](uint64_t i) { KeepValue(input.WasKeyPressed(keyCodes[i % keyCodeCount])); });
+    runner.Run("Input::IsMouseButtonHeld", [&](uint64_t i) {
+        KeepValue(input.IsMouseButtonHeld(i % 2 == 0 ? MouseButtonLeft : MouseButtonRight));
+    });
+
+    // A typical frame, a couple of keys change state and then the per frame state is cleared.
+    runner.Run("Input frame update", [&](uint64_t i) {
+        KeyCode keyCode = keyCodes[i % keyCodeCount];
+
+        input.UpdateStateKeyDown(keyCode);
+        input.UpdateStateKeyUp(keyCode);
+        input.Update();
+    });
+}
+
+static void RunImageBenchmarks(MicrobenchmarkRunner &runner)
+{
+    if (!std::ifstream(microbenchmarkImagePath).good())
+    {
+        std::cout << "Skipping LoadSurface, " << microbenchmarkImagePath << " wasn't found\n";
+        return;
+    }
+
+    runner.Run("LoadSurface", [](uint64_t i) {
+        SDL_Surface *surface = LoadSurface(microbenchmarkImagePath);
+        KeepValue(surface->pixels);
+        SDL_FreeSurface(surface);
+    });
+}
+
+// Mirrors pxlio_sprite_batch_add in the Haxe bindings, which looks up the batch by id in the renderer's pool and
+// unpacks every field of the sprite from its own argument.
+static SpriteBatchPool<uint32_t> bindingSpriteBatches;
+
+static void SimulateBindingSpriteBatchAdd(int32_t id, float x, float y, float z, float width, float height,
+                                          float texX, float texY, float texWidth, float texHeight, float originX,
+                                          float originY, float rotation, float r, float g, float b, float a,
+                                          float tint)
+{
+    SpriteBatch *spriteBatch = bindingSpriteBatches.GetSpriteBatch(static_cast<uint32_t>(id));
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    auto sprite = Sprite{};
+    sprite.width = width;
+    sprite.height = height;
+    sprite.texX = texX;
+    sprite.texY = texY;
+    sprite.texWidth = texWidth;
+    sprite.texHeight = texHeight;
+    sprite.originX = originX;
+    sprite.originY = originY;
+    sprite.rotation = rotation;
+    sprite.r = r;
+    sprite.g = g;
+    sprite.b = b;
+    sprite.a = a;
+    sprite.tint = tint;
+
+    spriteBatch->Add(x, y, z, sprite);
+}
+
+// Mirrors pxlio_sprite_batch_add_many, which takes a buffer of packed sprites instead of one call per sprite.
+static void SimulateBindingSpriteBatchAddMany(int32_t id, uint8_t *records, int32_t count)
+{
+    SpriteBatch *spriteBatch = bindingSpriteBatches.GetSpriteBatch(static_cast<uint32_t>(id));
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    spriteBatch->AddPacked(records, static_cast<uint32_t>(count));
+}
+
+// Mirrors pxlio_get_pressed_keys, which fills a buffer that is reused between calls.
+static int32_t *SimulateBindingGetPressedKeys(Input &input)
+{
+    static std::vector<int32_t> buffer;
+    auto &pressedKeys = input.GetPressedKeys();
+
+    buffer.resize(pressedKeys.size() + 1);
+    buffer[0] = static_cast<int32_t>(pressedKeys.size());
+    for (size_t i = 0; i < pressedKeys.size(); i++)
+    {
+        buffer[i + 1] = pressedKeys[i];
+    }
+
+    return buffer.data();
+}
+
+// Mirrors pxlio_get_input_snapshot, which copies into a buffer owned by the caller instead of allocating one.
+static bool SimulateBindingGetInputSnapshot(Input &input, uint8_t *buffer, int32_t size)
+{
+    if (size < static_cast<int32_t>(sizeof(InputSnapshot)))
+    {
+        return false;
+    }
+
+    InputSnapshot snapshot;
+    input.GetSnapshot(snapshot);
+    std::memcpy(buffer, &snapshot, sizeof(InputSnapshot));
+
+    return true;
+}
+
+static void RunBindingBenchmarks(MicrobenchmarkRunner &runner)
+{
+    SpriteBatch &bindingSpriteBatch = bindingSpriteBatches.Create(256, 256, microbenchmarkSpriteCount, false, 0);
+    const int32_t spriteBatchId = static_cast<int32_t>(bindingSpriteBatch.GetId());
+
+    // HashLink calls natives through a function pointer, so this one is too, which also stops it being inlined.
+    auto *volatile spriteBatchAdd = &SimulateBindingSpriteBatchAdd;
+
+    runner.Run("Binding sprite_batch_add", [&](uint64_t i) {
+        if (bindingSpriteBatch.GetSpriteCount() == microbenchmarkSpriteCount)
+        {
+            bindingSpriteBatch.Clear();
+        }
+
+        spriteBatchAdd(spriteBatchId, static_cast<float>(i % 320), static_cast<float>(i % 240), 0.0f, 16.0f, 16.0f,
+                       0.0f, 0.0f, 16.0f, 16.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f);
+    });
+
+    // Divide by the group size to compare with sprite_batch_add, which adds one sprite per call.
+    const uint32_t packedGroupSize = 64;
+    std::vector<uint8_t> packedSprites(packedGroupSize * packedSpriteSize);
+
+    for (uint32_t i = 0; i < packedGroupSize; i++)
+    {
+        CapturedSprite packedSprite{static_cast<float>(i % 320), static_cast<float>(i % 240), 0.0f, Sprite{}};
+        packedSprite.sprite.width = 16.0f;
+        packedSprite.sprite.height = 16.0f;
+        packedSprite.sprite.texWidth = 16.0f;
+        packedSprite.sprite.texHeight = 16.0f;
+        std::memcpy(&packedSprites[i * packedSpriteSize], &packedSprite, packedSpriteSize);
+    }
+
+    auto *volatile spriteBatchAddMany = &SimulateBindingSpriteBatchAddMany;
+
+    runner.Run("Binding sprite_batch_add_many, 64 sprites", [&](uint64_t i) {
+        if (bindingSpriteBatch.GetSpriteCount() + packedGroupSize > microbenchmarkSpriteCount)
+        {
+            bindingSpriteBatch.Clear();
+        }
+
+        spriteBatchAddMany(spriteBatchId, packedSprites.data(), static_cast<int32_t>(packedGroupSize));
+    });
+
+    Input input;
+    input.UpdateStateKeyDown(KeyW);
+    input.UpdateStateKeyDown(KeyA);
+    input.UpdateStateKeyDown(KeySpace);
+
+    auto *volatile getPressedKeys = &SimulateBindingGetPressedKeys;
+
+    runner.Run("Binding get_pressed_keys", [&](uint64_t i) {
+        int32_t *buffer = getPressedKeys(input);
+        KeepValue(buffer[0]);
+    });
+
+    auto *volatile getInputSnapshot = &SimulateBindingGetInputSnapshot;
+    std::vector<uint8_t> snapshotBuffer(sizeof(InputSnapshot));
+
+    runner.Run("Binding get_input_snapshot", [&](uint64_t i) {
+        getInputSnapshot(input, snapshotBuffer.data(), static_cast<int32_t>(snapshotBuffer.size()));
+        KeepValue(snapshotBuffer[0]);
+    });
+
+    bindingSpriteBatches.Destroy(bindingSpriteBatch);
+}
+
+static void PrintUsage()
+{
+    std::cout << "Usage: PxlIOMicrobenchmark [--samples n] [--warmup n] [--iterations n] [--filter text]\n";
+}
+
+static MicrobenchmarkOptions ParseOptions(int argc, char **argv)
+{
+    MicrobenchmarkOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--samples" && hasValue)
+        {
+            options.sampleCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--warmup" && hasValue)
+        {
+            options.warmupSampleCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--iterations" && hasValue)
+        {
+            options.iterationCount = std::stoull(argv[++i]);
+        }
+        else if (arg == "--filter" && hasValue)
+        {
+            options.filter = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            exit(1);
+        }
+    }
+
+    if (options.sampleCount == 0)
+    {
+        RUNTIME_ERROR("Microbenchmarks need at least one sample!");
+    }
+
+    return options;
+}
+
+int main(int argc, char **argv)
+{
+    MicrobenchmarkOptions options = ParseOptions(argc, argv);
+    MicrobenchmarkRunner runner(options);
+
+    RunSpriteBatchBenchmarks(runner);
+    RunViewTransformBenchmarks(runner);
+    RunInputBenchmarks(runner);
+    RunImageBenchmarks(runner);
+    RunBindingBenchmarks(runner);
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cinttypes>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../Capture.hpp"
+#include "../PxlIO.hpp"
+
+// Replays a file recorded by CaptureRenderer as fast as the backend allows, then prints frame time percentiles, so
+// that backend changes can be compared on a real game's frames without the game itself.
+
+struct ReplayOptions
+{
+    std::string capturePath;
+    RendererBackend backend = RendererBackendOpenGL;
+    // Times to play the whole capture while measuring, after one unmeasured pass that warms up the backend.
+    uint32_t loopCount = 1;
+    bool headless = false;
+};
+
+static void PrintUsage()
+{
+    std::cout << "Usage: PxlIOReplay capture.pxlc [--backend default|vulkan|opengl|software|null] [--loops n]\n"
+                 "                   [--headless]\n";
+}
+
+static ReplayOptions ParseOptions(int argc, char **argv)
+{
+    ReplayOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--backend" && hasValue)
+        {
+            std::string backend = argv[++i];
+
+            if (!PxlIO::ParseBackend(backend, options.backend))
+            {
+                RUNTIME_ERROR("Unknown backend: " << backend);
+            }
+        }
+        else if (arg == "--loops" && hasValue)
+        {
+            options.loopCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (options.capturePath.empty() && arg.rfind("--", 0) != 0)
+        {
+            options.capturePath = arg;
+        }
+        else
+        {
+            PrintUsage();
+            exit(1);
+        }
+    }
+
+    if (options.capturePath.empty() || options.loopCount == 0)
+    {
+        PrintUsage();
+        exit(1);
+    }
+
+    return options;
+}
+
+static void PrintPercentiles(const char *name, FrameTimeHistogram &histogram)
+{
+    FrameTimePercentiles percentiles = histogram.CalcPercentiles();
+
+    std::cout << name << ": p50 " << percentiles.p50Ms << "ms, p95 " << percentiles.p95Ms << "ms, p99 "
+              << percentiles.p99Ms << "ms, max " << percentiles.maxMs << "ms, " << percentiles.hitchCount
+              << " hitches in " << percentiles.sampleCount << " frames\n";
+}
+
+int main(int argc, char **argv)
+{
+    ReplayOptions options = ParseOptions(argc, argv);
+    CaptureReplay replay(options.capturePath);
+
+    if (options.headless)
+    {
+        // See PxlIOBenchmark, Vulkan can't run on SDL's offscreen driver.
+        if (options.backend == RendererBackendVulkan)
+        {
+            RUNTIME_ERROR("Headless mode doesn't support Vulkan, run it under a virtual display instead!");
+        }
+
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+    }
+
+    PresentConfig presentConfig;
+    presentConfig.presentMode = PresentModeImmediate;
+
+    std::unique_ptr<Renderer> rend =
+        PxlIO::Create(options.backend, "PxlIO Replay", replay.GetWindowWidth(), replay.GetWindowHeight(),
+                      replay.GetViewWidth(), replay.GetViewHeight(), presentConfig);
+
+    // The warmup pass also counts the frames, so that the histograms can hold every measured one.
+    uint32_t frameCount = 0;
+    while (replay.ReplayFrame(*rend))
+    {
+        ++frameCount;
+    }
+
+    if (frameCount == 0)
+    {
+        RUNTIME_ERROR("The capture doesn't contain any frames!");
+    }
+
+    FrameTimeHistogram frameTimes(frameCount * options.loopCount);
+    FrameTimeHistogram cpuTimes(frameCount * options.loopCount);
+    FrameTimeHistogram gpuTimes(frameCount * options.loopCount);
+    uint64_t lastGpuFrame = rend->GetGpuTimings().frame;
+
+    for (uint32_t loop = 0; loop < options.loopCount; loop++)
+    {
+        replay.Restart(*rend);
+
+        while (true)
+        {
+            SDL_Event event;
+            while (SDL_PollEvent(&event))
+            {
+            }
+
+            auto frameStartTime = std::chrono::steady_clock::now();
+
+            if (!replay.ReplayFrame(*rend))
+            {
+                break;
+            }
+
+            float frameMs =
+                std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStartTime).count();
+            const FrameStats &frameStats = rend->GetFrameStats();
+
+            frameTimes.Add(frameMs);
+            cpuTimes.Add(frameMs - frameStats.fenceWaitMs - frameStats.acquireMs - frameStats.presentMs);
+
+            const GpuTimings &gpuTimings = rend->GetGpuTimings();
+            if (gpuTimings.valid && gpuTimings.frame != lastGpuFrame)
+            {
+                gpuTimes.Add(gpuTimings.viewPassMs + gpuTimings.compositePassMs);
+                lastGpuFrame = gpuTimings.frame;
+            }
+        }
+    }
+
+    replay.Restart(*rend);
+
+    std::cout << options.capturePath << ": " << frameCount << " frames, " << options.loopCount
+              << " measured loops on the " << PxlIO::GetBackendName(rend->GetBackend()) << " backend\n";
+    PrintPercentiles("Frame", frameTimes);
+    PrintPercentiles("CPU", cpuTimes);
+    PrintPercentiles("GPU", gpuTimes);
+
+    return 0;
+}
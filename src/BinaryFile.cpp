@@ -0,0 +1,70 @@
+#include "BinaryFile.hpp"
+
+void WriteBinaryHeader(std::ofstream &file, const char (&magic)[4], uint32_t version)
+{
+    file.write(magic, sizeof(magic));
+    WriteBinary(file, version);
+}
+
+BinaryReader::BinaryReader(const std::string &path, const char *fileKind, const char (&magic)[4], uint32_t version)
+    : fileKind(fileKind)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    if (!file.is_open())
+    {
+        RUNTIME_ERROR("Failed to open " << fileKind << ": " << path);
+    }
+
+    data = std::vector<uint8_t>(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(data.data()), data.size());
+
+    CheckRemaining(sizeof(magic));
+
+    if (std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+    {
+        RUNTIME_ERROR("Not a " << fileKind << ": " << path);
+    }
+
+    offset = sizeof(magic);
+
+    uint32_t fileVersion = Read<uint32_t>();
+    if (fileVersion != version)
+    {
+        RUNTIME_ERROR("Unsupported " << fileKind << " version " << fileVersion << ", expected " << version);
+    }
+}
+
+std::string BinaryReader::ReadString(uint32_t length)
+{
+    CheckRemaining(length);
+
+    std::string string(reinterpret_cast<const char *>(data.data() + offset), length);
+    offset += length;
+
+    return string;
+}
+
+bool BinaryReader::IsAtEnd()
+{
+    return offset >= data.size();
+}
+
+size_t BinaryReader::GetOffset()
+{
+    return offset;
+}
+
+void BinaryReader::SetOffset(size_t offset)
+{
+    this->offset = offset;
+}
+
+void BinaryReader::CheckRemaining(size_t size)
+{
+    if (offset + size > data.size())
+    {
+        RUNTIME_ERROR("The " << fileKind << " ended in the middle of a value!");
+    }
+}
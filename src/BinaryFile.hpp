@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Error.hpp"
+
+// Captures and input recordings are binary files that start with a four character magic and a uint32 version. Values
+// are written as their raw bytes, in the byte order of the machine that wrote them.
+
+template <typename T> void WriteBinary(std::ofstream &file, const T &value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void WriteBinaryHeader(std::ofstream &file, const char (&magic)[4], uint32_t version);
+
+// Loads a whole binary file into memory and reads its values in order, so that replaying one never waits on the disk.
+class BinaryReader
+{
+  public:
+    // Exits with an error if the file can't be opened or its header doesn't match. fileKind names the file in errors,
+    // for example "capture file".
+    BinaryReader(const std::string &path, const char *fileKind, const char (&magic)[4], uint32_t version);
+
+    template <typename T> T Read()
+    {
+        CheckRemaining(sizeof(T));
+
+        T value;
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+
+        return value;
+    }
+
+    std::string ReadString(uint32_t length);
+
+    bool IsAtEnd();
+    size_t GetOffset();
+    void SetOffset(size_t offset);
+
+  private:
+    void CheckRemaining(size_t size);
+
+    std::vector<uint8_t> data;
+    size_t offset = 0;
+    std::string fileKind;
+};
@@ -0,0 +1,581 @@
+#include "Capture.hpp"
+
+void CapturedSpriteToValues(const CapturedSprite &capturedSprite, float *values)
+{
+    values[0] = capturedSprite.x;
+    values[1] = capturedSprite.y;
+    values[2] = capturedSprite.depth;
+
+    const Sprite &sprite = capturedSprite.sprite;
+    values[3] = sprite.width;
+    values[4] = sprite.height;
+    values[5] = sprite.texX;
+    values[6] = sprite.texY;
+    values[7] = sprite.texWidth;
+    values[8] = sprite.texHeight;
+    values[9] = sprite.originX;
+    values[10] = sprite.originY;
+    values[11] = sprite.rotation;
+    values[12] = sprite.r;
+    values[13] = sprite.g;
+    values[14] = sprite.b;
+    values[15] = sprite.a;
+    values[16] = sprite.tint;
+}
+
+CapturedSprite ValuesToCapturedSprite(const float *values)
+{
+    CapturedSprite capturedSprite;
+    capturedSprite.x = values[0];
+    capturedSprite.y = values[1];
+    capturedSprite.depth = values[2];
+
+    Sprite &sprite = capturedSprite.sprite;
+    sprite.width = values[3];
+    sprite.height = values[4];
+    sprite.texX = values[5];
+    sprite.texY = values[6];
+    sprite.texWidth = values[7];
+    sprite.texHeight = values[8];
+    sprite.originX = values[9];
+    sprite.originY = values[10];
+    sprite.rotation = values[11];
+    sprite.r = values[12];
+    sprite.g = values[13];
+    sprite.b = values[14];
+    sprite.a = values[15];
+    sprite.tint = values[16];
+
+    return capturedSprite;
+}
+
+CaptureRenderer::CaptureRenderer(std::unique_ptr<Renderer> renderer, int32_t viewWidth, int32_t viewHeight)
+    : renderer(std::move(renderer)), viewWidth(viewWidth), viewHeight(viewHeight)
+{
+}
+
+CaptureRenderer::~CaptureRenderer()
+{
+    StopCapture();
+}
+
+void CaptureRenderer::StartCapture(const std::string &path, uint32_t frameCount)
+{
+    if (frameCount == 0)
+    {
+        RUNTIME_ERROR("Captures need at least one frame!");
+    }
+
+    StopCapture();
+
+    pendingCapturePath = path;
+    isCapturePending = true;
+    remainingFrameCount = frameCount;
+
+    // Enabled straight away, so that batches filled before the next BeginDrawing are still recorded.
+    SpriteBatch::SetCaptureEnabled(true);
+}
+
+void CaptureRenderer::StopCapture()
+{
+    if (file.is_open())
+    {
+        file.close();
+    }
+
+    isCapturePending = false;
+    remainingFrameCount = 0;
+    SpriteBatch::SetCaptureEnabled(false);
+}
+
+bool CaptureRenderer::IsCapturing()
+{
+    return isCapturePending || file.is_open();
+}
+
+void CaptureRenderer::ResizeWindow(int32_t windowWidth, int32_t windowHeight)
+{
+    renderer->ResizeWindow(windowWidth, windowHeight);
+
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    WriteCommand(CaptureCommandResizeWindow);
+    WriteBinary(file, windowWidth);
+    WriteBinary(file, windowHeight);
+}
+
+SDL_Window *CaptureRenderer::GetWindowPtr()
+{
+    return renderer->GetWindowPtr();
+}
+
+RendererBackend CaptureRenderer::GetBackend()
+{
+    return renderer->GetBackend();
+}
+
+void CaptureRenderer::SetBackgroundColor(float r, float g, float b)
+{
+    renderer->SetBackgroundColor(r, g, b);
+
+    backgroundColor[0] = r;
+    backgroundColor[1] = g;
+    backgroundColor[2] = b;
+    hasBackgroundColor = true;
+
+    if (file.is_open())
+    {
+        WriteColor(CaptureCommandSetBackgroundColor, backgroundColor);
+    }
+}
+
+void CaptureRenderer::SetScreenBackgroundColor(float r, float g, float b)
+{
+    renderer->SetScreenBackgroundColor(r, g, b);
+
+    screenBackgroundColor[0] = r;
+    screenBackgroundColor[1] = g;
+    screenBackgroundColor[2] = b;
+    hasScreenBackgroundColor = true;
+
+    if (file.is_open())
+    {
+        WriteColor(CaptureCommandSetScreenBackgroundColor, screenBackgroundColor);
+    }
+}
+
+void CaptureRenderer::BeginDrawing()
+{
+    if (isCapturePending)
+    {
+        OpenCapture();
+    }
+
+    if (file.is_open())
+    {
+        WriteCommand(CaptureCommandBeginDrawing);
+    }
+
+    renderer->BeginDrawing();
+}
+
+void CaptureRenderer::EndDrawing()
+{
+    renderer->EndDrawing();
+
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    WriteCommand(CaptureCommandEndDrawing);
+
+    if (--remainingFrameCount == 0)
+    {
+        StopCapture();
+    }
+}
+
+PresentStatus CaptureRenderer::GetPresentStatus()
+{
+    return renderer->GetPresentStatus();
+}
+
+const FrameStats &CaptureRenderer::GetFrameStats()
+{
+    return renderer->GetFrameStats();
+}
+
+const GpuTimings &CaptureRenderer::GetGpuTimings()
+{
+    return renderer->GetGpuTimings();
+}
+
+void CaptureRenderer::SetGpuTimingsCsvPath(const std::string &path)
+{
+    renderer->SetGpuTimingsCsvPath(path);
+}
+
+MemoryReport CaptureRenderer::GetMemoryReport()
+{
+    return renderer->GetMemoryReport();
+}
+
+FrameTimeHistogram &CaptureRenderer::GetFrameTimeHistogram(FrameTimeKind kind)
+{
+    return renderer->GetFrameTimeHistogram(kind);
+}
+
+SpriteBatch &CaptureRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
+                                                bool enableBlending)
+{
+    SpriteBatch &spriteBatch = renderer->CreateSpriteBatch(texturePath, maxSprites, smooth, enableBlending);
+
+    CapturedSpriteBatch capturedSpriteBatch = CapturedSpriteBatch{texturePath, maxSprites, smooth, enableBlending};
+    spriteBatches.insert(std::make_pair(spriteBatch.GetId(), capturedSpriteBatch));
+
+    if (file.is_open())
+    {
+        WriteCreateSpriteBatch(spriteBatch.GetId(), capturedSpriteBatch);
+    }
+
+    return spriteBatch;
+}
+
+void CaptureRenderer::DrawSpriteBatch(SpriteBatch &spriteBatch)
+{
+    if (file.is_open())
+    {
+        PXLIO_TRACE_ZONE("CaptureRenderer::DrawSpriteBatch");
+
+        const std::vector<CapturedSprite> &capturedSprites = spriteBatch.GetCapturedSprites();
+        const std::vector<CapturedVertexRun> &capturedVertexRuns = spriteBatch.GetCapturedVertexRuns();
+        const float *capturedVertices = spriteBatch.GetCapturedVertices().data();
+
+        size_t capturedSpriteCount = capturedSprites.size();
+
+        for (const CapturedVertexRun &run : capturedVertexRuns)
+        {
+            capturedSpriteCount += run.spriteCount;
+        }
+
+        // Sprites dropped by MapVertices were never committed, so they aren't counted against the capture.
+        if (spriteBatch.GetSpriteCount() > capturedSpriteCount && !hasWarnedAboutMissingSprites)
+        {
+            std::cout << "Sprite batch " << spriteBatch.GetId()
+                      << " had sprites added before the capture started, they will be missing from the capture\n";
+            hasWarnedAboutMissingSprites = true;
+        }
+
+        for (const CapturedVertexRun &run : capturedVertexRuns)
+        {
+            size_t valueCount = static_cast<size_t>(run.spriteCount) * vertexValuesPerSprite;
+
+            WriteCommand(CaptureCommandAddVertices);
+            WriteBinary(file, spriteBatch.GetId());
+            WriteBinary(file, run.spriteIndex);
+            WriteBinary(file, run.spriteCount);
+            file.write(reinterpret_cast<const char *>(capturedVertices), valueCount * sizeof(float));
+
+            capturedVertices += valueCount;
+        }
+
+        WriteCommand(CaptureCommandDrawSpriteBatch);
+        WriteBinary(file, spriteBatch.GetId());
+        WriteBinary(file, static_cast<uint32_t>(capturedSprites.size()));
+
+        float previousValues[capturedSpriteValueCount];
+        CapturedSpriteToValues(CapturedSprite{}, previousValues);
+
+        for (const CapturedSprite &capturedSprite : capturedSprites)
+        {
+            float values[capturedSpriteValueCount];
+            CapturedSpriteToValues(capturedSprite, values);
+
+            // Compared bitwise, so that changes between values that compare equal, like 0 and -0, aren't lost.
+            uint32_t mask = 0;
+            for (uint32_t i = 0; i < capturedSpriteValueCount; i++)
+            {
+                if (std::memcmp(&values[i], &previousValues[i], sizeof(float)) != 0)
+                {
+                    mask |= 1 << i;
+                }
+            }
+
+            WriteBinary(file, mask);
+
+            for (uint32_t i = 0; i < capturedSpriteValueCount; i++)
+            {
+                if (mask & (1 << i))
+                {
+                    WriteBinary(file, values[i]);
+                }
+            }
+
+            std::memcpy(previousValues, values, sizeof(values));
+        }
+    }
+
+    renderer->DrawSpriteBatch(spriteBatch);
+}
+
+void CaptureRenderer::DestroySpriteBatch(SpriteBatch &spriteBatch)
+{
+    if (file.is_open())
+    {
+        WriteCommand(CaptureCommandDestroySpriteBatch);
+        WriteBinary(file, spriteBatch.GetId());
+    }
+
+    spriteBatches.erase(spriteBatch.GetId());
+    renderer->DestroySpriteBatch(spriteBatch);
+}
+
+SpriteBatch *CaptureRenderer::GetSpriteBatch(uint32_t id)
+{
+    return renderer->GetSpriteBatch(id);
+}
+
+void CaptureRenderer::OpenCapture()
+{
+    isCapturePending = false;
+    hasWarnedAboutMissingSprites = false;
+
+    file.open(pendingCapturePath, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        std::cout << "Failed to open capture file: " << pendingCapturePath << "\n";
+        StopCapture();
+        return;
+    }
+
+    int32_t windowWidth = 0;
+    int32_t windowHeight = 0;
+    SDL_GetWindowSize(renderer->GetWindowPtr(), &windowWidth, &windowHeight);
+
+    WriteBinaryHeader(file, captureMagic, captureVersion);
+    WriteBinary(file, windowWidth);
+    WriteBinary(file, windowHeight);
+    WriteBinary(file, viewWidth);
+    WriteBinary(file, viewHeight);
+
+    if (hasBackgroundColor)
+    {
+        WriteColor(CaptureCommandSetBackgroundColor, backgroundColor);
+    }
+
+    if (hasScreenBackgroundColor)
+    {
+        WriteColor(CaptureCommandSetScreenBackgroundColor, screenBackgroundColor);
+    }
+
+    for (auto &[id, spriteBatch] : spriteBatches)
+    {
+        WriteCreateSpriteBatch(id, spriteBatch);
+    }
+}
+
+void CaptureRenderer::WriteCommand(CaptureCommand command)
+{
+    WriteBinary(file, static_cast<uint8_t>(command));
+}
+
+void CaptureRenderer::WriteCreateSpriteBatch(uint32_t id, const CapturedSpriteBatch &spriteBatch)
+{
+    WriteCommand(CaptureCommandCreateSpriteBatch);
+    WriteBinary(file, id);
+    WriteBinary(file, static_cast<uint32_t>(spriteBatch.texturePath.size()));
+    file.write(spriteBatch.texturePath.data(), spriteBatch.texturePath.size());
+    WriteBinary(file, spriteBatch.maxSprites);
+    WriteBinary(file, static_cast<uint8_t>(spriteBatch.smooth));
+    WriteBinary(file, static_cast<uint8_t>(spriteBatch.enableBlending));
+}
+
+void CaptureRenderer::WriteColor(CaptureCommand command, const float *color)
+{
+    WriteCommand(command);
+    WriteBinary(file, color[0]);
+    WriteBinary(file, color[1]);
+    WriteBinary(file, color[2]);
+}
+
+CaptureReplay::CaptureReplay(const std::string &path) : reader(path, "capture file", captureMagic, captureVersion)
+{
+    windowWidth = reader.Read<int32_t>();
+    windowHeight = reader.Read<int32_t>();
+    viewWidth = reader.Read<int32_t>();
+    viewHeight = reader.Read<int32_t>();
+
+    firstCommandOffset = reader.GetOffset();
+}
+
+int32_t CaptureReplay::GetWindowWidth()
+{
+    return windowWidth;
+}
+
+int32_t CaptureReplay::GetWindowHeight()
+{
+    return windowHeight;
+}
+
+int32_t CaptureReplay::GetViewWidth()
+{
+    return viewWidth;
+}
+
+int32_t CaptureReplay::GetViewHeight()
+{
+    return viewHeight;
+}
+
+bool CaptureReplay::ReplayFrame(Renderer &rend)
+{
+    PXLIO_TRACE_ZONE("CaptureReplay::ReplayFrame");
+
+    while (!reader.IsAtEnd())
+    {
+        CaptureCommand command = static_cast<CaptureCommand>(reader.Read<uint8_t>());
+
+        switch (command)
+        {
+        case CaptureCommandBeginDrawing:
+            rend.BeginDrawing();
+            break;
+        case CaptureCommandEndDrawing:
+            rend.EndDrawing();
+            return true;
+        case CaptureCommandResizeWindow: {
+            int32_t width = reader.Read<int32_t>();
+            int32_t height = reader.Read<int32_t>();
+            SDL_SetWindowSize(rend.GetWindowPtr(), width, height);
+            rend.ResizeWindow(width, height);
+            break;
+        }
+        case CaptureCommandSetBackgroundColor:
+        case CaptureCommandSetScreenBackgroundColor: {
+            float r = reader.Read<float>();
+            float g = reader.Read<float>();
+            float b = reader.Read<float>();
+
+            if (command == CaptureCommandSetBackgroundColor)
+            {
+                rend.SetBackgroundColor(r, g, b);
+            }
+            else
+            {
+                rend.SetScreenBackgroundColor(r, g, b);
+            }
+            break;
+        }
+        case CaptureCommandCreateSpriteBatch: {
+            uint32_t id = reader.Read<uint32_t>();
+            std::string texturePath = reader.ReadString(reader.Read<uint32_t>());
+
+            uint32_t maxSprites = reader.Read<uint32_t>();
+            bool smooth = reader.Read<uint8_t>() != 0;
+            bool enableBlending = reader.Read<uint8_t>() != 0;
+
+            SpriteBatch &spriteBatch = rend.CreateSpriteBatch(texturePath, maxSprites, smooth, enableBlending);
+            spriteBatches.insert_or_assign(id, &spriteBatch);
+            break;
+        }
+        case CaptureCommandDestroySpriteBatch: {
+            uint32_t id = reader.Read<uint32_t>();
+            rend.DestroySpriteBatch(*spriteBatches.at(id));
+            spriteBatches.erase(id);
+            break;
+        }
+        case CaptureCommandAddVertices:
+            ReplayAddVertices();
+            break;
+        case CaptureCommandDrawSpriteBatch:
+            ReplayDrawSpriteBatch(rend);
+            break;
+        default:
+            RUNTIME_ERROR("Unknown capture command: " << static_cast<uint32_t>(command));
+        }
+    }
+
+    return false;
+}
+
+void CaptureReplay::Restart(Renderer &rend)
+{
+    for (auto &[id, spriteBatch] : spriteBatches)
+    {
+        rend.DestroySpriteBatch(*spriteBatch);
+    }
+
+    spriteBatches.clear();
+    pendingVertexRuns.clear();
+    pendingVertices.clear();
+    pendingVertexRunIndex = 0;
+    pendingVertexValueIndex = 0;
+    reader.SetOffset(firstCommandOffset);
+}
+
+void CaptureReplay::ReplayDrawSpriteBatch(Renderer &rend)
+{
+    uint32_t id = reader.Read<uint32_t>();
+    uint32_t spriteCount = reader.Read<uint32_t>();
+
+    SpriteBatch &spriteBatch = *spriteBatches.at(id);
+    spriteBatch.Clear();
+
+    float values[capturedSpriteValueCount];
+    CapturedSpriteToValues(CapturedSprite{}, values);
+
+    for (uint32_t i = 0; i < spriteCount; i++)
+    {
+        uint32_t mask = reader.Read<uint32_t>();
+
+        for (uint32_t j = 0; j < capturedSpriteValueCount; j++)
+        {
+            if (mask & (1 << j))
+            {
+                values[j] = reader.Read<float>();
+            }
+        }
+
+        CommitPendingVertices(spriteBatch, i);
+
+        CapturedSprite capturedSprite = ValuesToCapturedSprite(values);
+        spriteBatch.Add(capturedSprite.x, capturedSprite.y, capturedSprite.depth, capturedSprite.sprite);
+    }
+
+    CommitPendingVertices(spriteBatch, spriteCount);
+
+    pendingVertexRuns.clear();
+    pendingVertices.clear();
+    pendingVertexRunIndex = 0;
+    pendingVertexValueIndex = 0;
+
+    rend.DrawSpriteBatch(spriteBatch);
+}
+
+void CaptureReplay::CommitPendingVertices(SpriteBatch &spriteBatch, uint32_t spriteIndex)
+{
+    while (pendingVertexRunIndex < pendingVertexRuns.size() &&
+           pendingVertexRuns[pendingVertexRunIndex].spriteIndex <= spriteIndex)
+    {
+        const CapturedVertexRun &run = pendingVertexRuns[pendingVertexRunIndex];
+
+        // The replayed batch has the same maxSprites, so it drops the same sprites the recorded one did.
+        float *mappedVertices = spriteBatch.MapVertices(run.spriteCount);
+
+        if (mappedVertices)
+        {
+            uint32_t mappedSpriteCount = spriteBatch.GetMappedSpriteCount();
+            std::memcpy(mappedVertices, pendingVertices.data() + pendingVertexValueIndex,
+                        static_cast<size_t>(mappedSpriteCount) * vertexValuesPerSprite * sizeof(float));
+            spriteBatch.CommitVertices(mappedSpriteCount);
+        }
+
+        pendingVertexRunIndex++;
+        pendingVertexValueIndex += static_cast<size_t>(run.spriteCount) * vertexValuesPerSprite;
+    }
+}
+
+void CaptureReplay::ReplayAddVertices()
+{
+    // Runs are always written just before their batch's draw, which is what they're added to.
+    reader.Read<uint32_t>();
+    uint32_t spriteIndex = reader.Read<uint32_t>();
+    uint32_t spriteCount = reader.Read<uint32_t>();
+
+    pendingVertexRuns.push_back(CapturedVertexRun{spriteIndex, spriteCount});
+
+    size_t valueCount = static_cast<size_t>(spriteCount) * vertexValuesPerSprite;
+    size_t firstValue = pendingVertices.size();
+    pendingVertices.resize(firstValue + valueCount);
+
+    for (size_t i = 0; i < valueCount; i++)
+    {
+        pendingVertices[firstValue + i] = reader.Read<float>();
+    }
+}
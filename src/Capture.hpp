@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cinttypes>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BinaryFile.hpp"
+#include "Renderer.hpp"
+
+// After the header with captureMagic, see BinaryFile.hpp, capture files hold the window and view sizes as int32s. Each
+// command follows as a uint8_t and its arguments.
+const char captureMagic[4] = {'P', 'X', 'L', 'C'};
+const uint32_t captureVersion = 2;
+
+enum CaptureCommand
+{
+    CaptureCommandBeginDrawing,
+    CaptureCommandEndDrawing,
+    // int32 width and height.
+    CaptureCommandResizeWindow,
+    // float32 r, g and b.
+    CaptureCommandSetBackgroundColor,
+    CaptureCommandSetScreenBackgroundColor,
+    // uint32 id, uint32 path length, the path, uint32 max sprites, uint8 smooth and uint8 enable blending.
+    CaptureCommandCreateSpriteBatch,
+    // uint32 id.
+    CaptureCommandDestroySpriteBatch,
+    // uint32 id and uint32 sprite count, then each sprite added since the batch was last cleared. Sprites are a
+    // uint32 mask of which capturedSpriteValueCount values differ from the previous sprite, followed by only those
+    // values as float32s. The first sprite is compared against a default sprite at zero.
+    CaptureCommandDrawSpriteBatch,
+    // uint32 id, uint32 sprite index and uint32 sprite count, then vertexValuesPerSprite float32s for each sprite that
+    // was committed through SpriteBatch::CommitVertices. Written just before the batch's DrawSpriteBatch, which adds
+    // them after the first sprite index of its own sprites.
+    CaptureCommandAddVertices,
+};
+
+// x, y and depth followed by every field of Sprite.
+const uint32_t capturedSpriteValueCount = 17;
+
+void CapturedSpriteToValues(const CapturedSprite &capturedSprite, float *values);
+CapturedSprite ValuesToCapturedSprite(const float *values);
+
+struct CapturedSpriteBatch
+{
+    std::string texturePath;
+    uint32_t maxSprites;
+    bool smooth;
+    bool enableBlending;
+};
+
+// Wraps another renderer and forwards every call to it, recording the call stream to a file while capturing so that
+// a real game's frames can be replayed on any backend with CaptureReplay.
+class CaptureRenderer : public Renderer
+{
+  public:
+    CaptureRenderer(std::unique_ptr<Renderer> renderer, int32_t viewWidth, int32_t viewHeight);
+    ~CaptureRenderer();
+
+    // Records the next frameCount frames, starting at the next call to BeginDrawing, so it should be called between
+    // frames. Sprite batches that already exist are recorded first. Sprites added to a batch before the call are
+    // missing from the capture, so batches that aren't cleared every frame should be refilled after starting.
+    void StartCapture(const std::string &path, uint32_t frameCount);
+    void StopCapture();
+    bool IsCapturing();
+
+    void ResizeWindow(int32_t windowWidth, int32_t windowHeight) override;
+    SDL_Window *GetWindowPtr() override;
+    RendererBackend GetBackend() override;
+
+    void SetBackgroundColor(float r, float g, float b) override;
+    void SetScreenBackgroundColor(float r, float g, float b) override;
+    void BeginDrawing() override;
+    void EndDrawing() override;
+
+    PresentStatus GetPresentStatus() override;
+    const FrameStats &GetFrameStats() override;
+    const GpuTimings &GetGpuTimings() override;
+    void SetGpuTimingsCsvPath(const std::string &path) override;
+    MemoryReport GetMemoryReport() override;
+    FrameTimeHistogram &GetFrameTimeHistogram(FrameTimeKind kind) override;
+
+    SpriteBatch &CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
+                                   bool enableBlending = false) override;
+    void DrawSpriteBatch(SpriteBatch &spriteBatch) override;
+    void DestroySpriteBatch(SpriteBatch &spriteBatch) override;
+    SpriteBatch *GetSpriteBatch(uint32_t id) override;
+
+  private:
+    void OpenCapture();
+    void WriteCommand(CaptureCommand command);
+    void WriteCreateSpriteBatch(uint32_t id, const CapturedSpriteBatch &spriteBatch);
+    void WriteColor(CaptureCommand command, const float *color);
+
+    std::unique_ptr<Renderer> renderer;
+    int32_t viewWidth;
+    int32_t viewHeight;
+
+    // Every live batch, so that captures started after they were created can still recreate them.
+    std::unordered_map<uint32_t, CapturedSpriteBatch> spriteBatches;
+    float backgroundColor[3] = {};
+    float screenBackgroundColor[3] = {};
+    bool hasBackgroundColor = false;
+    bool hasScreenBackgroundColor = false;
+
+    std::ofstream file;
+    std::string pendingCapturePath;
+    bool isCapturePending = false;
+    uint32_t remainingFrameCount = 0;
+    bool hasWarnedAboutMissingSprites = false;
+};
+
+// Plays a capture file back on a renderer, which doesn't need to be the backend it was recorded on.
+class CaptureReplay
+{
+  public:
+    CaptureReplay(const std::string &path);
+
+    int32_t GetWindowWidth();
+    int32_t GetWindowHeight();
+    int32_t GetViewWidth();
+    int32_t GetViewHeight();
+
+    // Replays commands up to and including the next EndDrawing, returns false once the capture has ended.
+    bool ReplayFrame(Renderer &rend);
+    // Destroys every batch created by the replay and starts again from the first command.
+    void Restart(Renderer &rend);
+
+  private:
+    void ReplayAddVertices();
+    void ReplayDrawSpriteBatch(Renderer &rend);
+    // Maps and commits the pending vertex runs that were committed before the given number of the draw's sprites.
+    void CommitPendingVertices(SpriteBatch &spriteBatch, uint32_t spriteIndex);
+
+    BinaryReader reader;
+    size_t firstCommandOffset = 0;
+    int32_t windowWidth = 0;
+    int32_t windowHeight = 0;
+    int32_t viewWidth = 0;
+    int32_t viewHeight = 0;
+
+    // Indexed by the ids the batches had when they were recorded.
+    std::unordered_map<uint32_t, SpriteBatch *> spriteBatches;
+
+    // Read by AddVertices and held until the draw that follows them.
+    std::vector<CapturedVertexRun> pendingVertexRuns;
+    std::vector<float> pendingVertices;
+    // The first run and value that haven't been committed to the batch being drawn.
+    size_t pendingVertexRunIndex = 0;
+    size_t pendingVertexValueIndex = 0;
+};
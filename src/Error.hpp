@@ -1,9 +1,40 @@
 #pragma once
 
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 #define RUNTIME_ERROR(message)                                                                                         \
     std::cout << "Error in " << std::string(__FILE__).substr(SOURCE_PATH_SIZE) << "@" << __LINE__ << ": " << message   \
               << "\n";                                                                                                 \
-    exit(1)
\ No newline at end of file
+    exit(1)
+
+// Thrown instead of exiting when a renderer fails to initialize, so that another backend can be tried instead.
+class RendererInitError : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+#define INIT_ERROR(message)                                                                                            \
+    {                                                                                                                  \
+        std::ostringstream initErrorStream;                                                                            \
+        initErrorStream << "Error in " << std::string(__FILE__).substr(SOURCE_PATH_SIZE) << "@" << __LINE__ << ": "    \
+                        << message;                                                                                    \
+        throw RendererInitError(initErrorStream.str());                                                               \
+    }
+
+// Set while a renderer is being constructed, see RENDERER_ERROR.
+inline bool isRendererInitializing = false;
+
+// For failures in code that runs both while a renderer is being constructed and afterwards, like creating a swapchain
+// or a pipeline. Acts like INIT_ERROR during construction, so that another backend can be tried, and like
+// RUNTIME_ERROR once the renderer is in use.
+#define RENDERER_ERROR(message)                                                                                        \
+    if (isRendererInitializing)                                                                                        \
+        INIT_ERROR(message)                                                                                            \
+    else                                                                                                               \
+    {                                                                                                                  \
+        RUNTIME_ERROR(message);                                                                                        \
+    }
@@ -0,0 +1,59 @@
+#include "FramePacer.hpp"
+
+#ifdef EMSCRIPTEN
+#include <emscripten.h>
+#else
+#include <thread>
+#endif
+
+#ifndef EMSCRIPTEN
+// Sleeping is only precise to around a millisecond on most platforms, so the rest of the wait is spent spinning.
+const std::chrono::microseconds spinDuration(1500);
+#endif
+
+void FramePacer::SetTargetFps(uint32_t targetFps)
+{
+    if (targetFps == 0)
+    {
+        frameDuration = std::chrono::steady_clock::duration::zero();
+        return;
+    }
+
+    frameDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / targetFps));
+    nextFrameTime = std::chrono::steady_clock::now() + frameDuration;
+}
+
+void FramePacer::Wait()
+{
+    if (frameDuration == std::chrono::steady_clock::duration::zero())
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    // Frames that run late restart the schedule instead of being followed by a burst of catch up frames.
+    if (now >= nextFrameTime)
+    {
+        nextFrameTime = now + frameDuration;
+        return;
+    }
+
+#ifdef EMSCRIPTEN
+    // Yields to the browser while waiting, the same way the end of every frame does.
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(nextFrameTime - now);
+    emscripten_sleep(static_cast<uint32_t>(remaining.count()));
+#else
+    if (nextFrameTime - now > spinDuration)
+    {
+        std::this_thread::sleep_until(nextFrameTime - spinDuration);
+    }
+
+    while (std::chrono::steady_clock::now() < nextFrameTime)
+    {
+    }
+#endif
+
+    nextFrameTime += frameDuration;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+
+// Caps the frame rate independently of the present mode, so uncapped modes can still be limited to a target.
+class FramePacer
+{
+  public:
+    void SetTargetFps(uint32_t targetFps);
+    // Called once per frame after presenting, sleeps until the next frame is due.
+    void Wait();
+
+  private:
+    std::chrono::steady_clock::duration frameDuration = std::chrono::steady_clock::duration::zero();
+    std::chrono::steady_clock::time_point nextFrameTime;
+};
@@ -0,0 +1,190 @@
+#include "FrameTimeHistogram.hpp"
+
+FrameTimeHistogram::FrameTimeHistogram(uint32_t windowSize)
+{
+    if (windowSize == 0)
+    {
+        RUNTIME_ERROR("Frame time histograms need room for at least one sample!");
+    }
+
+    samples = std::vector<uint32_t>(windowSize);
+}
+
+void FrameTimeHistogram::Add(float ms)
+{
+    float us = ms * 1000.0f;
+    uint32_t sample = frameTimeMaxUs;
+
+    if (us < 0.0f)
+    {
+        sample = 0;
+    }
+    else if (us < frameTimeMaxUs)
+    {
+        sample = static_cast<uint32_t>(us);
+    }
+
+    if (sampleCount == samples.size())
+    {
+        --buckets[CalcBucketIndex(samples[nextSample])];
+    }
+    else
+    {
+        ++sampleCount;
+    }
+
+    samples[nextSample] = sample;
+    ++buckets[CalcBucketIndex(sample)];
+    nextSample = (nextSample + 1) % samples.size();
+}
+
+void FrameTimeHistogram::Reset()
+{
+    buckets.fill(0);
+    sampleCount = 0;
+    nextSample = 0;
+}
+
+FrameTimePercentiles FrameTimeHistogram::CalcPercentiles()
+{
+    FrameTimePercentiles percentiles;
+    percentiles.sampleCount = sampleCount;
+
+    if (sampleCount == 0)
+    {
+        return percentiles;
+    }
+
+    // The smallest number of samples that each percentile has to cover, rounded up so that p99 of fewer than a
+    // hundred samples is the slowest one rather than the one before it.
+    uint32_t p50Rank = (sampleCount * 50 + 99) / 100;
+    uint32_t p95Rank = (sampleCount * 95 + 99) / 100;
+    uint32_t p99Rank = (sampleCount * 99 + 99) / 100;
+
+    uint32_t coveredCount = 0;
+    for (uint32_t i = 0; i < frameTimeBucketCount && coveredCount < p99Rank; i++)
+    {
+        uint32_t previousCoveredCount = coveredCount;
+        coveredCount += buckets[i];
+
+        if (previousCoveredCount < p50Rank && coveredCount >= p50Rank)
+        {
+            percentiles.p50Ms = CalcBucketMs(i);
+        }
+
+        if (previousCoveredCount < p95Rank && coveredCount >= p95Rank)
+        {
+            percentiles.p95Ms = CalcBucketMs(i);
+        }
+
+        if (coveredCount >= p99Rank)
+        {
+            percentiles.p99Ms = CalcBucketMs(i);
+        }
+    }
+
+    uint32_t maxUs = 0;
+    float hitchUs = percentiles.p50Ms * 1000.0f * hitchFactor;
+
+    for (uint32_t i = 0; i < sampleCount; i++)
+    {
+        if (samples[i] > maxUs)
+        {
+            maxUs = samples[i];
+        }
+
+        if (samples[i] > hitchUs)
+        {
+            ++percentiles.hitchCount;
+        }
+    }
+
+    percentiles.maxMs = maxUs / 1000.0f;
+
+    // Keeps the percentiles ordered, the middle of the slowest bucket can be above the slowest sample.
+    percentiles.p50Ms = std::min(percentiles.p50Ms, percentiles.maxMs);
+    percentiles.p95Ms = std::min(percentiles.p95Ms, percentiles.maxMs);
+    percentiles.p99Ms = std::min(percentiles.p99Ms, percentiles.maxMs);
+
+    return percentiles;
+}
+
+void FrameTimeHistogram::AddGraph(SpriteBatch &spriteBatch, float x, float y, float depth, uint32_t barCount,
+                                  float height, float maxMs, Sprite sprite)
+{
+    float hitchUs = CalcPercentiles().p50Ms * 1000.0f * hitchFactor;
+    float heightPerUs = height / (maxMs * 1000.0f);
+    uint32_t drawnBarCount = std::min(barCount, sampleCount);
+
+    sprite.width = 1.0f;
+    sprite.tint = 1.0f;
+
+    for (uint32_t i = 0; i < drawnBarCount; i++)
+    {
+        uint32_t sample = GetRecentSample(i);
+
+        sprite.height = std::min(sample * heightPerUs, height);
+
+        if (sample > hitchUs)
+        {
+            sprite.r = 1.0f;
+            sprite.g = 0.0f;
+            sprite.b = 0.0f;
+        }
+        else
+        {
+            sprite.r = 0.0f;
+            sprite.g = 1.0f;
+            sprite.b = 0.0f;
+        }
+
+        spriteBatch.Add(x + (barCount - 1 - i), y, depth, sprite);
+    }
+}
+
+uint32_t FrameTimeHistogram::GetWindowSize()
+{
+    return static_cast<uint32_t>(samples.size());
+}
+
+uint32_t FrameTimeHistogram::CalcBucketIndex(uint32_t us)
+{
+    if (us < frameTimeSubBucketCount)
+    {
+        return us;
+    }
+
+    uint32_t magnitude = frameTimeSubBucketBits;
+    while ((us >> (magnitude + 1)) != 0)
+    {
+        ++magnitude;
+    }
+
+    uint32_t shift = magnitude - frameTimeSubBucketBits + 1;
+    uint32_t subBucket = (us >> shift) - frameTimeHalfSubBucketCount;
+
+    return frameTimeSubBucketCount + (magnitude - frameTimeSubBucketBits) * frameTimeHalfSubBucketCount + subBucket;
+}
+
+float FrameTimeHistogram::CalcBucketMs(uint32_t bucketIndex)
+{
+    if (bucketIndex < frameTimeSubBucketCount)
+    {
+        return (bucketIndex + 0.5f) / 1000.0f;
+    }
+
+    uint32_t offset = bucketIndex - frameTimeSubBucketCount;
+    uint32_t magnitude = frameTimeSubBucketBits + offset / frameTimeHalfSubBucketCount;
+    uint32_t shift = magnitude - frameTimeSubBucketBits + 1;
+    uint32_t subBucket = offset % frameTimeHalfSubBucketCount + frameTimeHalfSubBucketCount;
+    uint32_t lowestUs = subBucket << shift;
+
+    return (lowestUs + (1 << shift) * 0.5f) / 1000.0f;
+}
+
+uint32_t FrameTimeHistogram::GetRecentSample(uint32_t i)
+{
+    uint32_t windowSize = static_cast<uint32_t>(samples.size());
+
+    return samples[(nextSample + windowSize - 1 - i) % windowSize];
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <vector>
+
+#include "Error.hpp"
+#include "SpriteBatch.hpp"
+
+struct FrameTimePercentiles
+{
+    uint32_t sampleCount = 0;
+    // Frames in the window that took more than hitchFactor times the median.
+    uint32_t hitchCount = 0;
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    // Exact, unlike the percentiles which are rounded to the middle of their bucket.
+    float maxMs = 0.0f;
+};
+
+// Keeps a rolling window of frame times in an HDR style histogram. Times are stored in microseconds, each power of two
+// above frameTimeSubBucketCount is split into the same number of linear buckets, so every percentile is within 1% of
+// the real value from a microsecond up to frameTimeMaxUs while memory stays constant.
+const uint32_t frameTimeSubBucketBits = 7;
+const uint32_t frameTimeSubBucketCount = 1 << frameTimeSubBucketBits;
+const uint32_t frameTimeHalfSubBucketCount = frameTimeSubBucketCount / 2;
+const uint32_t frameTimeMaxBits = 24;
+const uint32_t frameTimeMaxUs = (1 << frameTimeMaxBits) - 1;
+const uint32_t frameTimeBucketCount =
+    frameTimeSubBucketCount + (frameTimeMaxBits - frameTimeSubBucketBits) * frameTimeHalfSubBucketCount;
+
+const float hitchFactor = 2.0f;
+
+class FrameTimeHistogram
+{
+  public:
+    // The window defaults to ten seconds at 60 fps.
+    FrameTimeHistogram(uint32_t windowSize = 600);
+
+    // Replaces the oldest sample once the window is full.
+    void Add(float ms);
+    void Reset();
+
+    FrameTimePercentiles CalcPercentiles();
+    // Adds one bar per sample for the most recent barCount samples, oldest on the left and scaled so that maxMs
+    // fills the height. Hitches are drawn red. The sprite's texture region has to cover an opaque texel, its color
+    // is replaced by the bar's.
+    void AddGraph(SpriteBatch &spriteBatch, float x, float y, float depth, uint32_t barCount, float height,
+                  float maxMs, Sprite sprite);
+
+    uint32_t GetWindowSize();
+
+  private:
+    static uint32_t CalcBucketIndex(uint32_t us);
+    // The middle of the bucket, which halves the worst case error compared to either of its edges.
+    static float CalcBucketMs(uint32_t bucketIndex);
+
+    // Newest sample first, i must be less than the sample count.
+    uint32_t GetRecentSample(uint32_t i);
+
+    std::array<uint32_t, frameTimeBucketCount> buckets{};
+    std::vector<uint32_t> samples;
+    uint32_t sampleCount = 0;
+    uint32_t nextSample = 0;
+};
@@ -0,0 +1,76 @@
+#include "GpuTimings.hpp"
+
+static float CalcElapsedMs(const std::vector<std::optional<uint64_t>> &timestamps, double nsPerTimestamp,
+                           uint32_t begin, uint32_t end)
+{
+    if (end >= timestamps.size() || !timestamps[begin].has_value() || !timestamps[end].has_value() ||
+        timestamps[end].value() < timestamps[begin].value())
+    {
+        return 0.0f;
+    }
+
+    // Converted after subtracting, large timestamps lose precision when they are converted to floating point.
+    return static_cast<float>((timestamps[end].value() - timestamps[begin].value()) * nsPerTimestamp / 1000000.0);
+}
+
+void ResolveGpuTimings(const GpuTimestampFrame &timestampFrame, const std::vector<std::optional<uint64_t>> &timestamps,
+                       double nsPerTimestamp, GpuTimings &timings)
+{
+    timings.frame = timestampFrame.frame;
+    timings.valid = true;
+    timings.viewPassMs = CalcElapsedMs(timestamps, nsPerTimestamp, GpuTimestampViewBegin, GpuTimestampViewEnd);
+    timings.compositePassMs =
+        CalcElapsedMs(timestamps, nsPerTimestamp, GpuTimestampCompositeBegin, GpuTimestampCompositeEnd);
+
+    timings.spriteBatches.clear();
+
+    for (size_t i = 0; i < timestampFrame.spriteBatchIds.size(); i++)
+    {
+        uint32_t begin = GpuTimestampFirstSpriteBatch + static_cast<uint32_t>(i) * 2;
+        float ms = CalcElapsedMs(timestamps, nsPerTimestamp, begin, begin + 1);
+        timings.spriteBatches.push_back(SpriteBatchGpuTiming{timestampFrame.spriteBatchIds[i], ms});
+    }
+}
+
+void GpuTimingsCsv::Open(const std::string &path)
+{
+    Close();
+
+    file.open(path, std::ios::out | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        RUNTIME_ERROR(std::string("Failed to open: ") + path);
+    }
+
+    file << "frame,pass,spriteBatchId,ms\n";
+}
+
+void GpuTimingsCsv::Close()
+{
+    if (file.is_open())
+    {
+        file.close();
+    }
+}
+
+void GpuTimingsCsv::Write(const GpuTimings &timings)
+{
+    if (!file.is_open() || !timings.valid)
+    {
+        return;
+    }
+
+    file << timings.frame << ",view,," << timings.viewPassMs << "\n";
+    file << timings.frame << ",composite,," << timings.compositePassMs << "\n";
+
+    for (const SpriteBatchGpuTiming &spriteBatch : timings.spriteBatches)
+    {
+        file << timings.frame << ",spriteBatch," << spriteBatch.spriteBatchId << "," << spriteBatch.ms << "\n";
+    }
+}
+
+bool GpuTimingsCsv::IsOpen()
+{
+    return file.is_open();
+}
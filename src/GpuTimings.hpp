@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cinttypes>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Error.hpp"
+
+struct SpriteBatchGpuTiming
+{
+    uint32_t spriteBatchId;
+    float ms;
+};
+
+struct GpuTimings
+{
+    // The frame the timings were recorded on, results are only read back once the GPU has finished with them so
+    // they lag a few frames behind.
+    uint64_t frame = 0;
+    // False when the backend doesn't support timer queries.
+    bool valid = false;
+    // Drawing the view, including every sprite batch.
+    float viewPassMs = 0.0f;
+    // Copying or drawing the view onto the window, zero when the view was drawn into the window directly.
+    float compositePassMs = 0.0f;
+    // In the order that the batches were drawn. Passes overlap on the GPU, so these are upper bounds.
+    std::vector<SpriteBatchGpuTiming> spriteBatches;
+};
+
+// The timestamps written by each frame, sprite batches follow as pairs of begin and end timestamps.
+enum GpuTimestamp
+{
+    GpuTimestampViewBegin,
+    GpuTimestampViewEnd,
+    GpuTimestampCompositeBegin,
+    GpuTimestampCompositeEnd,
+    GpuTimestampFirstSpriteBatch,
+};
+
+// Batches drawn after this many in a frame aren't timed individually, but are still part of the view pass.
+const uint32_t maxTimedSpriteBatches = 64;
+const uint32_t gpuTimestampsPerFrame = GpuTimestampFirstSpriteBatch + maxTimedSpriteBatches * 2;
+
+// What a frame in flight recorded, so that its results can be matched up once they are read back.
+struct GpuTimestampFrame
+{
+    uint64_t frame = 0;
+    bool pending = false;
+    std::vector<uint32_t> spriteBatchIds;
+};
+
+// Converts timestamps to timings, pairs with a missing timestamp are reported as zero. Overwrites the timings in
+// place, so that reading them back every frame doesn't allocate once their vector has grown.
+void ResolveGpuTimings(const GpuTimestampFrame &timestampFrame, const std::vector<std::optional<uint64_t>> &timestamps,
+                       double nsPerTimestamp, GpuTimings &timings);
+
+// Writes one row per pass per frame, so frames with different numbers of batches share the same columns.
+class GpuTimingsCsv
+{
+  public:
+    void Open(const std::string &path);
+    void Close();
+    void Write(const GpuTimings &timings);
+    bool IsOpen();
+
+  private:
+    std::ofstream file;
+};
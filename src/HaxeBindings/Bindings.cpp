@@ -2,25 +2,34 @@
 #define HL_NAME(n) PxlIO_##n
 
 #include <codecvt>
+#include <cstring>
 #include <hl.h>
 #include <locale>
 #include "../PxlIO.hpp"
+#include "../Capture.hpp"
 #include "../Input.hpp"
+#include "../InputRecording.hpp"
 #include "../Audio.hpp"
+#include "../SlotMap.hpp"
 
 static std::unique_ptr<Renderer> rend = nullptr;
+// The same renderer as rend, every call goes through it so that captures can be started at any time.
+static CaptureRenderer *captureRenderer = nullptr;
 static bool isRunning = false;
 
 static Input input;
+static InputRecorder inputRecorder;
+// Replaces real input while it exists.
+static std::unique_ptr<InputReplay> inputReplay = nullptr;
+// The events handled by the last pxlio_poll_events, kept between frames so that they don't need reallocating.
+static std::vector<InputEvent> inputEvents;
 
 static auto lastTime = std::chrono::high_resolution_clock::now();
 static float deltaTime = 0.0f;
+// Used instead of the measured time between frames when above zero.
+static float fixedDeltaTime = 0.0f;
 
-static std::unordered_map<int32_t, SpriteBatch> spriteBatches;
-static int32_t lastSpriteBatchId = 0;
-
-static std::unordered_map<int32_t, Audio> audios;
-static int32_t lastAudioId = 0;
+static SlotMap<Audio> audios;
 
 std::string GetHaxeString(vstring *haxeString)
 {
@@ -31,8 +40,17 @@ std::string GetHaxeString(vstring *haxeString)
     return string;
 }
 
+// Any recording in progress is stopped, and input starts again from a fresh state.
+static void StartInputReplay(const std::string &path)
+{
+    inputRecorder.Stop();
+    inputReplay = std::make_unique<InputReplay>(path);
+    input = Input();
+    input.SetMouseReplayed(true);
+}
+
 HL_PRIM void HL_NAME(pxlio_create)(vstring *windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
-                                    int32_t viewHeight, bool enableVsync)
+                                    int32_t viewHeight, bool enableVsync, int32_t backend)
 {
     if (rend)
     {
@@ -40,13 +58,89 @@ HL_PRIM void HL_NAME(pxlio_create)(vstring *windowName, int32_t windowWidth, int
         return;
     }
 
+    const char *inputRecordPath = std::getenv(inputRecordEnvironmentVariable);
+    const char *inputReplayPath = std::getenv(inputReplayEnvironmentVariable);
+
+    PresentConfig presentConfig;
+    // Replays run as fast as possible, so that they can be used as benchmarks.
+    presentConfig.presentMode = enableVsync && !inputReplayPath ? PresentModeFifo : PresentModeImmediate;
+
     std::string name = GetHaxeString(windowName);
-    rend = PxlIO::Create(name.c_str(), windowWidth, windowHeight, viewWidth, viewHeight, enableVsync);
+    auto capture = std::make_unique<CaptureRenderer>(PxlIO::Create(static_cast<RendererBackend>(backend), name,
+                                                                   windowWidth, windowHeight, viewWidth, viewHeight,
+                                                                   presentConfig),
+                                                     viewWidth, viewHeight);
+    captureRenderer = capture.get();
+    rend = std::move(capture);
     isRunning = true;
+
+    if (inputReplayPath)
+    {
+        StartInputReplay(inputReplayPath);
+    }
+    else if (inputRecordPath)
+    {
+        inputRecorder.Start(inputRecordPath);
+    }
+}
+
+HL_PRIM int32_t HL_NAME(pxlio_get_backend)()
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return RendererBackendDefault;
+    }
+
+    return rend->GetBackend();
+}
+
+static void HandleInputEvent(const InputEvent &event, uint32_t timestamp, bool isReplayed)
+{
+    switch (event.type)
+    {
+    case InputEventKeyDown:
+        input.UpdateStateKeyDown((KeyCode)event.code, timestamp);
+        break;
+    case InputEventKeyUp:
+        input.UpdateStateKeyUp((KeyCode)event.code, timestamp);
+        break;
+    case InputEventMouseDown:
+        input.UpdateStateMouseDown((MouseButton)event.code, timestamp);
+        break;
+    case InputEventMouseUp:
+        input.UpdateStateMouseUp((MouseButton)event.code, timestamp);
+        break;
+    case InputEventMouseMove:
+        input.UpdateStateMouseMove(event.x, event.y);
+        break;
+    case InputEventResizeWindow:
+        // Replayed sizes are applied to the real window first, the renderer follows whatever size it ends up with in
+        // case the window manager doesn't allow that one.
+        if (isReplayed)
+        {
+            SDL_Window *window = rend->GetWindowPtr();
+            int32_t windowWidth = 0;
+            int32_t windowHeight = 0;
+            SDL_SetWindowSize(window, event.x, event.y);
+            SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+            rend->ResizeWindow(windowWidth, windowHeight);
+        }
+        else
+        {
+            rend->ResizeWindow(event.x, event.y);
+        }
+        break;
+    case InputEventQuit:
+        isRunning = false;
+        break;
+    }
 }
 
 HL_PRIM bool HL_NAME(pxlio_poll_events)()
 {
+    PXLIO_TRACE_ZONE("pxlio_poll_events");
+
     if (!rend)
     {
         hl_error("The renderer isn't active!");
@@ -54,45 +148,71 @@ HL_PRIM bool HL_NAME(pxlio_poll_events)()
     }
 
     auto currentTime = std::chrono::high_resolution_clock::now();
-    deltaTime = static_cast<float>((currentTime - lastTime).count()) * 0.000000001f;
+    deltaTime = fixedDeltaTime > 0.0f ? fixedDeltaTime
+                                      : static_cast<float>((currentTime - lastTime).count()) * 0.000000001f;
     lastTime = currentTime;
 
     input.Update();
+    inputEvents.clear();
 
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
+    SDL_Event sdlEvent;
+
+    if (inputReplay)
     {
-        if (event.type == SDL_WINDOWEVENT)
+        // Real input is ignored while replaying, but the window can still be resized or closed.
+        while (SDL_PollEvent(&sdlEvent))
         {
-            if (event.window.event == SDL_WINDOWEVENT_RESIZED)
+            InputEvent event;
+
+            if (ToInputEvent(sdlEvent, event) &&
+                (event.type == InputEventResizeWindow || event.type == InputEventQuit))
             {
-                rend->ResizeWindow(event.window.data1, event.window.data2);
+                HandleInputEvent(event, sdlEvent.common.timestamp, false);
             }
         }
 
-        switch (event.type)
+        // Replays use the recorded delta times, so that the game steps exactly as it did while recording. The game
+        // ends with the recording, the same as if it had been closed.
+        if (!inputReplay->ReadFrame(deltaTime, inputEvents))
         {
-        case SDL_KEYDOWN:
-            input.UpdateStateKeyDown((KeyCode)event.key.keysym.sym);
-            break;
-        case SDL_KEYUP:
-            input.UpdateStateKeyUp((KeyCode)event.key.keysym.sym);
-            break;
-        case SDL_MOUSEBUTTONDOWN:
-            input.UpdateStateMouseDown((MouseButton)event.button.button);
-            break;
-        case SDL_MOUSEBUTTONUP:
-            input.UpdateStateMouseUp((MouseButton)event.button.button);
-            break;
-        case SDL_QUIT:
             isRunning = false;
-            break;
+        }
+
+        uint32_t timestamp = SDL_GetTicks();
+
+        for (const InputEvent &event : inputEvents)
+        {
+            HandleInputEvent(event, timestamp, true);
         }
     }
+    else
+    {
+        while (SDL_PollEvent(&sdlEvent))
+        {
+            InputEvent event;
+
+            if (!ToInputEvent(sdlEvent, event))
+            {
+                continue;
+            }
+
+            HandleInputEvent(event, sdlEvent.common.timestamp, false);
+
+            if (inputRecorder.IsRecording())
+            {
+                inputEvents.push_back(event);
+            }
+        }
+
+        inputRecorder.RecordFrame(deltaTime, inputEvents, input.GetMouseX(), input.GetMouseY());
+    }
 
     if (!isRunning)
     {
         rend.reset();
+        captureRenderer = nullptr;
+        inputRecorder.Stop();
+        inputReplay.reset();
     }
 
     return isRunning;
@@ -131,6 +251,130 @@ HL_PRIM void HL_NAME(pxlio_end_drawing)()
     rend->EndDrawing();
 }
 
+// Layout: six int32 counters, three float32 timings, heap allocations as an int32, then bytes uploaded and heap
+// allocated bytes as float64s, 56 bytes in total.
+HL_PRIM vbyte *HL_NAME(pxlio_get_frame_stats)()
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return nullptr;
+    }
+
+    const FrameStats &frameStats = rend->GetFrameStats();
+
+    vbyte *buffer = hl_alloc_bytes(56);
+    int32_t *intBuffer = reinterpret_cast<int32_t *>(buffer);
+    intBuffer[0] = static_cast<int32_t>(frameStats.spritesSubmitted);
+    intBuffer[1] = static_cast<int32_t>(frameStats.spritesCulled);
+    intBuffer[2] = static_cast<int32_t>(frameStats.drawCalls);
+    intBuffer[3] = static_cast<int32_t>(frameStats.pipelineBinds);
+    intBuffer[4] = static_cast<int32_t>(frameStats.textureBinds);
+    intBuffer[5] = static_cast<int32_t>(frameStats.buffersAllocated);
+
+    float *floatBuffer = reinterpret_cast<float *>(buffer + 24);
+    floatBuffer[0] = frameStats.fenceWaitMs;
+    floatBuffer[1] = frameStats.acquireMs;
+    floatBuffer[2] = frameStats.presentMs;
+
+    intBuffer[9] = static_cast<int32_t>(frameStats.heapAllocations);
+
+    double *doubleBuffer = reinterpret_cast<double *>(buffer + 40);
+    doubleBuffer[0] = static_cast<double>(frameStats.bytesUploaded);
+    doubleBuffer[1] = static_cast<double>(frameStats.heapAllocatedBytes);
+
+    return buffer;
+}
+
+HL_PRIM vbyte *HL_NAME(pxlio_get_frame_time_percentiles)(int32_t kind)
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return nullptr;
+    }
+
+    if (kind < 0 || kind >= static_cast<int32_t>(frameTimeKindCount))
+    {
+        hl_error("Invalid frame time kind!");
+        return nullptr;
+    }
+
+    FrameTimePercentiles percentiles = rend->GetFrameTimeHistogram(static_cast<FrameTimeKind>(kind)).CalcPercentiles();
+
+    vbyte *buffer = hl_alloc_bytes(24);
+    int32_t *intBuffer = reinterpret_cast<int32_t *>(buffer);
+    intBuffer[0] = static_cast<int32_t>(percentiles.sampleCount);
+    intBuffer[1] = static_cast<int32_t>(percentiles.hitchCount);
+
+    float *floatBuffer = reinterpret_cast<float *>(buffer + 8);
+    floatBuffer[0] = percentiles.p50Ms;
+    floatBuffer[1] = percentiles.p95Ms;
+    floatBuffer[2] = percentiles.p99Ms;
+    floatBuffer[3] = percentiles.maxMs;
+
+    return buffer;
+}
+
+// Heaps and sprite batches follow the header, their counts are stored in it.
+const size_t memoryReportHeaderSize = 40;
+const size_t memoryReportHeapSize = 16;
+const size_t memoryReportSpriteBatchSize = 48;
+
+HL_PRIM vbyte *HL_NAME(pxlio_get_memory_report)()
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return nullptr;
+    }
+
+    MemoryReport report = rend->GetMemoryReport();
+
+    vbyte *buffer = hl_alloc_bytes(static_cast<int32_t>(memoryReportHeaderSize +
+                                                        report.heaps.size() * memoryReportHeapSize +
+                                                        report.spriteBatches.size() * memoryReportSpriteBatchSize));
+
+    double *headerDoubles = reinterpret_cast<double *>(buffer);
+    headerDoubles[0] = static_cast<double>(report.allocatedBytes);
+    headerDoubles[1] = static_cast<double>(report.reservedBytes);
+
+    int32_t *headerInts = reinterpret_cast<int32_t *>(buffer + 16);
+    headerInts[0] = static_cast<int32_t>(report.allocationCount);
+    headerInts[1] = report.estimated ? 1 : 0;
+    headerInts[2] = report.budgetsFromDriver ? 1 : 0;
+    headerInts[3] = static_cast<int32_t>(report.heaps.size());
+    headerInts[4] = static_cast<int32_t>(report.spriteBatches.size());
+
+    vbyte *heapBuffer = buffer + memoryReportHeaderSize;
+    for (size_t i = 0; i < report.heaps.size(); i++)
+    {
+        double *heapDoubles = reinterpret_cast<double *>(heapBuffer + i * memoryReportHeapSize);
+        heapDoubles[0] = static_cast<double>(report.heaps[i].usageBytes);
+        heapDoubles[1] = static_cast<double>(report.heaps[i].budgetBytes);
+    }
+
+    vbyte *spriteBatchBuffer = heapBuffer + report.heaps.size() * memoryReportHeapSize;
+    for (size_t i = 0; i < report.spriteBatches.size(); i++)
+    {
+        const SpriteBatchMemory &memory = report.spriteBatches[i];
+
+        int32_t *spriteBatchInts = reinterpret_cast<int32_t *>(spriteBatchBuffer + i * memoryReportSpriteBatchSize);
+        spriteBatchInts[0] = static_cast<int32_t>(memory.spriteBatchId);
+        spriteBatchInts[1] = static_cast<int32_t>(memory.maxSprites);
+        spriteBatchInts[2] = static_cast<int32_t>(memory.peakSprites);
+        spriteBatchInts[3] = static_cast<int32_t>(memory.capacity);
+
+        double *spriteBatchDoubles = reinterpret_cast<double *>(spriteBatchInts + 4);
+        spriteBatchDoubles[0] = static_cast<double>(memory.cpuVertexBytes);
+        spriteBatchDoubles[1] = static_cast<double>(memory.cpuIndexBytes);
+        spriteBatchDoubles[2] = static_cast<double>(memory.gpuBufferBytes);
+        spriteBatchDoubles[3] = static_cast<double>(memory.textureBytes);
+    }
+
+    return buffer;
+}
+
 HL_PRIM void HL_NAME(pxlio_set_background_color)(float r, float g, float b)
 {
     if (!rend)
@@ -153,6 +397,26 @@ HL_PRIM void HL_NAME(pxlio_set_screen_background_color)(float r, float g, float
     rend->SetScreenBackgroundColor(static_cast<float>(r), static_cast<float>(g), static_cast<float>(b));
 }
 
+// Sprite batch handles are the renderer's ids for them, so stale handles to destroyed batches are caught instead of
+// reaching whichever batch reused their slot.
+static SpriteBatch *GetSpriteBatch(int32_t id)
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return nullptr;
+    }
+
+    SpriteBatch *spriteBatch = rend->GetSpriteBatch(static_cast<uint32_t>(id));
+
+    if (!spriteBatch)
+    {
+        hl_error("Invalid sprite batch!");
+    }
+
+    return spriteBatch;
+}
+
 HL_PRIM int32_t HL_NAME(pxlio_create_sprite_batch)(vstring *texturePath, int32_t maxSprites, bool smooth,
                                                     bool enableBlending)
 {
@@ -163,30 +427,57 @@ HL_PRIM int32_t HL_NAME(pxlio_create_sprite_batch)(vstring *texturePath, int32_t
     }
 
     std::string texturePathString = GetHaxeString(texturePath);
-    SpriteBatch spriteBatch = rend->CreateSpriteBatch(texturePathString, maxSprites, smooth, enableBlending);
-    int32_t id = lastSpriteBatchId++;
-    spriteBatches.insert(std::make_pair(id, spriteBatch));
+    SpriteBatch &spriteBatch = rend->CreateSpriteBatch(texturePathString, maxSprites, smooth, enableBlending);
 
-    return id;
+    return static_cast<int32_t>(spriteBatch.GetId());
 }
 
 HL_PRIM void HL_NAME(pxlio_destroy_sprite_batch)(int32_t id)
 {
-    if (!rend)
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
     {
-        hl_error("The renderer isn't active!");
         return;
     }
 
-    SpriteBatch &spriteBatch = spriteBatches.at(id);
-    rend->DestroySpriteBatch(spriteBatch);
-    spriteBatches.erase(id);
+    rend->DestroySpriteBatch(*spriteBatch);
 }
 
 HL_PRIM void HL_NAME(pxlio_sprite_batch_clear)(int32_t id)
 {
-    SpriteBatch &spriteBatch = spriteBatches.at(id);
-    spriteBatch.Clear();
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    spriteBatch->Clear();
+}
+
+HL_PRIM int32_t HL_NAME(pxlio_sprite_batch_get_overflow_count)(int32_t id)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return 0;
+    }
+
+    return static_cast<int32_t>(spriteBatch->GetOverflowCount());
+}
+
+HL_PRIM void HL_NAME(pxlio_sprite_batch_set_shrink_enabled)(int32_t id, bool enabled)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    spriteBatch->SetShrinkEnabled(enabled);
 }
 
 HL_PRIM void HL_NAME(pxlio_sprite_batch_add)(int32_t id, float x, float y, float z, float width, float height,
@@ -194,7 +485,12 @@ HL_PRIM void HL_NAME(pxlio_sprite_batch_add)(int32_t id, float x, float y, float
                                               float originY, float rotation, float r, float g, float b, float a,
                                               float tint)
 {
-    SpriteBatch &spriteBatch = spriteBatches.at(id);
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
 
     auto sprite = Sprite{};
     sprite.width = width;
@@ -212,10 +508,106 @@ HL_PRIM void HL_NAME(pxlio_sprite_batch_add)(int32_t id, float x, float y, float
     sprite.a = a;
     sprite.tint = tint;
 
-    spriteBatch.Add(x, y, z, sprite);
+    spriteBatch->Add(x, y, z, sprite);
 }
 
-HL_PRIM void HL_NAME(pxlio_draw_sprite_batch)(int32_t id)
+// Takes a buffer of count sprites laid out as described by packedSpriteSize, little endian on every platform that
+// HashLink supports, so that a whole batch costs one call from Haxe instead of one per sprite.
+HL_PRIM void HL_NAME(pxlio_sprite_batch_add_many)(int32_t id, vbyte *records, int32_t count)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    if (count < 0)
+    {
+        hl_error("Invalid sprite count!");
+        return;
+    }
+
+    spriteBatch->AddPacked(records, static_cast<uint32_t>(count));
+}
+
+// Returns the batch's own vertex memory rather than a copy, so that Haxe can write sprites straight into it, see
+// SpriteBatch::MapVertices. HashLink's GC ignores it since it isn't on the GC's heap.
+HL_PRIM vbyte *HL_NAME(pxlio_sprite_batch_map_vertices)(int32_t id, int32_t count)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return nullptr;
+    }
+
+    if (count < 0)
+    {
+        hl_error("Invalid sprite count!");
+        return nullptr;
+    }
+
+    return reinterpret_cast<vbyte *>(spriteBatch->MapVertices(static_cast<uint32_t>(count)));
+}
+
+HL_PRIM int32_t HL_NAME(pxlio_sprite_batch_get_mapped_sprite_count)(int32_t id)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return 0;
+    }
+
+    return static_cast<int32_t>(spriteBatch->GetMappedSpriteCount());
+}
+
+HL_PRIM void HL_NAME(pxlio_sprite_batch_commit_vertices)(int32_t id, int32_t count)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    if (count < 0)
+    {
+        hl_error("Invalid sprite count!");
+        return;
+    }
+
+    spriteBatch->CommitVertices(static_cast<uint32_t>(count));
+}
+
+HL_PRIM int32_t HL_NAME(pxlio_sprite_batch_get_texture_width)(int32_t id)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return 0;
+    }
+
+    return spriteBatch->GetTextureWidth();
+}
+
+HL_PRIM int32_t HL_NAME(pxlio_sprite_batch_get_texture_height)(int32_t id)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return 0;
+    }
+
+    return spriteBatch->GetTextureHeight();
+}
+
+HL_PRIM void HL_NAME(pxlio_sprite_batch_add_frame_time_graph)(int32_t id, int32_t kind, float x, float y, float z,
+                                                              int32_t barCount, float height, float maxMs, float texX,
+                                                              float texY)
 {
     if (!rend)
     {
@@ -223,8 +615,37 @@ HL_PRIM void HL_NAME(pxlio_draw_sprite_batch)(int32_t id)
         return;
     }
 
-    SpriteBatch &spriteBatch = spriteBatches.at(id);
-    rend->DrawSpriteBatch(spriteBatch);
+    if (kind < 0 || kind >= static_cast<int32_t>(frameTimeKindCount) || barCount < 0)
+    {
+        hl_error("Invalid frame time graph!");
+        return;
+    }
+
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    auto sprite = Sprite{};
+    sprite.texX = texX;
+    sprite.texY = texY;
+
+    rend->GetFrameTimeHistogram(static_cast<FrameTimeKind>(kind))
+        .AddGraph(*spriteBatch, x, y, z, static_cast<uint32_t>(barCount), height, maxMs, sprite);
+}
+
+HL_PRIM void HL_NAME(pxlio_draw_sprite_batch)(int32_t id)
+{
+    SpriteBatch *spriteBatch = GetSpriteBatch(id);
+
+    if (!spriteBatch)
+    {
+        return;
+    }
+
+    rend->DrawSpriteBatch(*spriteBatch);
 }
 
 HL_PRIM bool HL_NAME(pxlio_is_key_held)(int32_t keyNumber)
@@ -242,19 +663,57 @@ HL_PRIM bool HL_NAME(pxlio_was_key_released)(int32_t keyNumber)
     return input.WasKeyReleased((KeyCode)keyNumber);
 }
 
+HL_PRIM int32_t HL_NAME(pxlio_get_key_pressed_time)(int32_t keyNumber)
+{
+    return static_cast<int32_t>(input.GetKeyPressedTime((KeyCode)keyNumber));
+}
+
+// The oldest input event handled by the last pxlio_poll_events, subtract it from pxlio_get_ticks to find how long
+// that input waited to reach the game.
+HL_PRIM int32_t HL_NAME(pxlio_get_first_input_time)()
+{
+    return static_cast<int32_t>(input.GetFirstEventTime());
+}
+
+HL_PRIM int32_t HL_NAME(pxlio_get_ticks)()
+{
+    return static_cast<int32_t>(SDL_GetTicks());
+}
+
+// Reused between calls, so that reading the pressed keys stops allocating once the buffer has grown to fit them.
+static std::vector<int32_t> pressedKeyBuffer;
+
+// The count followed by the keys, only valid until the next call.
 HL_PRIM vbyte *HL_NAME(pxlio_get_pressed_keys)()
 {
     auto &pressedKeys = input.GetPressedKeys();
 
-    vbyte *buffer = hl_alloc_bytes(sizeof(int32_t) * static_cast<int32_t>(pressedKeys.size() + 1));
-    int32_t *intBuffer = reinterpret_cast<int32_t *>(buffer);
-    intBuffer[0] = static_cast<int32_t>(pressedKeys.size());
-    for (int32_t i = 0; i < pressedKeys.size(); i++)
+    pressedKeyBuffer.resize(pressedKeys.size() + 1);
+    pressedKeyBuffer[0] = static_cast<int32_t>(pressedKeys.size());
+    for (size_t i = 0; i < pressedKeys.size(); i++)
     {
-        intBuffer[i + 1] = pressedKeys[i];
+        pressedKeyBuffer[i + 1] = pressedKeys[i];
     }
 
-    return buffer;
+    return reinterpret_cast<vbyte *>(pressedKeyBuffer.data());
+}
+
+static_assert(sizeof(InputSnapshot) == 532, "InputSnapshot.hx needs to match InputSnapshot's layout");
+
+// Fills a buffer that the caller keeps between frames with an InputSnapshot, so that reading all of a frame's input
+// costs one call and no allocations. Returns false without writing anything if the buffer is too small.
+HL_PRIM bool HL_NAME(pxlio_get_input_snapshot)(vbyte *buffer, int32_t size)
+{
+    if (size < static_cast<int32_t>(sizeof(InputSnapshot)))
+    {
+        return false;
+    }
+
+    InputSnapshot snapshot;
+    input.GetSnapshot(snapshot);
+    std::memcpy(buffer, &snapshot, sizeof(InputSnapshot));
+
+    return true;
 }
 
 HL_PRIM int32_t HL_NAME(pxlio_get_mouse_x)()
@@ -287,58 +746,172 @@ HL_PRIM void HL_NAME(pxlio_close)()
     isRunning = false;
 }
 
+HL_PRIM int32_t HL_NAME(pxlio_get_trace_frame)()
+{
+    return static_cast<int32_t>(Trace::GetFrame());
+}
+
+// Does nothing unless the library was built with tracing enabled.
+HL_PRIM void HL_NAME(pxlio_write_trace)(vstring *path, int32_t firstFrame, int32_t lastFrame)
+{
+    Trace::WriteChromeJson(GetHaxeString(path), firstFrame, lastFrame);
+}
+
+HL_PRIM void HL_NAME(pxlio_start_capture)(vstring *path, int32_t frameCount)
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return;
+    }
+
+    captureRenderer->StartCapture(GetHaxeString(path), frameCount);
+}
+
+HL_PRIM void HL_NAME(pxlio_stop_capture)()
+{
+    if (!rend)
+    {
+        hl_error("The renderer isn't active!");
+        return;
+    }
+
+    captureRenderer->StopCapture();
+}
+
+// Records the input of every following frame until stopped, returns false if the file couldn't be opened.
+HL_PRIM bool HL_NAME(pxlio_start_input_recording)(vstring *path)
+{
+    return inputRecorder.Start(GetHaxeString(path));
+}
+
+HL_PRIM void HL_NAME(pxlio_stop_input_recording)()
+{
+    inputRecorder.Stop();
+}
+
+// Feeds a recording back instead of real input, pxlio_poll_events returns false once the replay ends.
+HL_PRIM void HL_NAME(pxlio_start_input_replay)(vstring *path)
+{
+    StartInputReplay(GetHaxeString(path));
+}
+
+HL_PRIM bool HL_NAME(pxlio_is_replaying_input)()
+{
+    return inputReplay != nullptr;
+}
+
+// Zero goes back to measuring the time between frames. Replays always use the delta times they recorded.
+HL_PRIM void HL_NAME(pxlio_set_fixed_delta_time)(float seconds)
+{
+    fixedDeltaTime = seconds;
+}
+
+static Audio *GetAudio(int32_t id)
+{
+    Audio *audio = audios.Get(static_cast<uint32_t>(id));
+
+    if (!audio)
+    {
+        hl_error("Invalid audio!");
+    }
+
+    return audio;
+}
+
 HL_PRIM int32_t HL_NAME(pxlio_audio_constructor)(vstring *path)
 {
     std::string pathString = GetHaxeString(path);
-    Audio audio = Audio(pathString);
-    int32_t id = lastAudioId++;
-    audios.insert(std::make_pair(id, audio));
 
-    return id;
+    return static_cast<int32_t>(audios.Insert(Audio(pathString)));
 }
 
 HL_PRIM void HL_NAME(pxlio_audio_set_volume)(int32_t id, float volume)
 {
-    Audio &audio = audios.at(id);
-    audio.SetVolume(volume);
+    Audio *audio = GetAudio(id);
+
+    if (!audio)
+    {
+        return;
+    }
+
+    audio->SetVolume(volume);
 }
 
 HL_PRIM void HL_NAME(pxlio_audio_play)(int32_t id)
 {
-    Audio &audio = audios.at(id);
-    audio.Play();
+    Audio *audio = GetAudio(id);
+
+    if (!audio)
+    {
+        return;
+    }
+
+    audio->Play();
 }
 
 HL_PRIM void HL_NAME(pxlio_audio_destroy)(int32_t id)
 {
-    Audio &audio = audios.at(id);
-    audio.Destroy();
-    audios.erase(id);
+    Audio *audio = GetAudio(id);
+
+    if (!audio)
+    {
+        return;
+    }
+
+    audio->Destroy();
+    audios.Remove(static_cast<uint32_t>(id));
 }
 
-DEFINE_PRIM(_VOID, pxlio_create, _STRING _I32 _I32 _I32 _I32 _BOOL);
+DEFINE_PRIM(_VOID, pxlio_create, _STRING _I32 _I32 _I32 _I32 _BOOL _I32);
+DEFINE_PRIM(_I32, pxlio_get_backend, _NO_ARG);
 DEFINE_PRIM(_BOOL, pxlio_poll_events, _NO_ARG);
 DEFINE_PRIM(_F32, pxlio_get_delta_time, _NO_ARG);
 DEFINE_PRIM(_VOID, pxlio_begin_drawing, _NO_ARG);
 DEFINE_PRIM(_VOID, pxlio_end_drawing, _NO_ARG);
+DEFINE_PRIM(_BYTES, pxlio_get_frame_stats, _NO_ARG);
+DEFINE_PRIM(_BYTES, pxlio_get_frame_time_percentiles, _I32);
+DEFINE_PRIM(_BYTES, pxlio_get_memory_report, _NO_ARG);
 DEFINE_PRIM(_VOID, pxlio_set_background_color, _F32 _F32 _F32);
 DEFINE_PRIM(_VOID, pxlio_set_screen_background_color, _F32 _F32 _F32);
 DEFINE_PRIM(_I32, pxlio_create_sprite_batch, _STRING _I32 _BOOL _BOOL);
 DEFINE_PRIM(_VOID, pxlio_destroy_sprite_batch, _I32);
 DEFINE_PRIM(_VOID, pxlio_sprite_batch_clear, _I32);
+DEFINE_PRIM(_I32, pxlio_sprite_batch_get_overflow_count, _I32);
+DEFINE_PRIM(_VOID, pxlio_sprite_batch_set_shrink_enabled, _I32 _BOOL);
 DEFINE_PRIM(_VOID, pxlio_sprite_batch_add,
             _I32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32 _F32);
+DEFINE_PRIM(_VOID, pxlio_sprite_batch_add_many, _I32 _BYTES _I32);
+DEFINE_PRIM(_BYTES, pxlio_sprite_batch_map_vertices, _I32 _I32);
+DEFINE_PRIM(_I32, pxlio_sprite_batch_get_mapped_sprite_count, _I32);
+DEFINE_PRIM(_VOID, pxlio_sprite_batch_commit_vertices, _I32 _I32);
+DEFINE_PRIM(_I32, pxlio_sprite_batch_get_texture_width, _I32);
+DEFINE_PRIM(_I32, pxlio_sprite_batch_get_texture_height, _I32);
+DEFINE_PRIM(_VOID, pxlio_sprite_batch_add_frame_time_graph, _I32 _I32 _F32 _F32 _F32 _I32 _F32 _F32 _F32 _F32);
 DEFINE_PRIM(_VOID, pxlio_draw_sprite_batch, _I32);
 DEFINE_PRIM(_BOOL, pxlio_is_key_held, _I32);
 DEFINE_PRIM(_BOOL, pxlio_was_key_pressed, _I32);
 DEFINE_PRIM(_BOOL, pxlio_was_key_released, _I32);
+DEFINE_PRIM(_I32, pxlio_get_key_pressed_time, _I32);
+DEFINE_PRIM(_I32, pxlio_get_first_input_time, _NO_ARG);
+DEFINE_PRIM(_I32, pxlio_get_ticks, _NO_ARG);
 DEFINE_PRIM(_BYTES, pxlio_get_pressed_keys, _NO_ARG);
+DEFINE_PRIM(_BOOL, pxlio_get_input_snapshot, _BYTES _I32);
 DEFINE_PRIM(_I32, pxlio_get_mouse_x, _NO_ARG);
 DEFINE_PRIM(_I32, pxlio_get_mouse_y, _NO_ARG);
 DEFINE_PRIM(_BOOL, pxlio_is_mouse_button_held, _I32);
 DEFINE_PRIM(_BOOL, pxlio_was_mouse_button_pressed, _I32);
 DEFINE_PRIM(_BOOL, pxlio_was_mouse_button_released, _I32);
 DEFINE_PRIM(_VOID, pxlio_close, _NO_ARG);
+DEFINE_PRIM(_I32, pxlio_get_trace_frame, _NO_ARG);
+DEFINE_PRIM(_VOID, pxlio_write_trace, _STRING _I32 _I32);
+DEFINE_PRIM(_VOID, pxlio_start_capture, _STRING _I32);
+DEFINE_PRIM(_VOID, pxlio_stop_capture, _NO_ARG);
+DEFINE_PRIM(_BOOL, pxlio_start_input_recording, _STRING);
+DEFINE_PRIM(_VOID, pxlio_stop_input_recording, _NO_ARG);
+DEFINE_PRIM(_VOID, pxlio_start_input_replay, _STRING);
+DEFINE_PRIM(_BOOL, pxlio_is_replaying_input, _NO_ARG);
+DEFINE_PRIM(_VOID, pxlio_set_fixed_delta_time, _F32);
 DEFINE_PRIM(_I32, pxlio_audio_constructor, _STRING);
 DEFINE_PRIM(_VOID, pxlio_audio_set_volume, _I32 _F32);
 DEFINE_PRIM(_VOID, pxlio_audio_play, _I32);
@@ -2,6 +2,8 @@
 
 SDL_Surface *LoadSurface(const std::string &path)
 {
+    PXLIO_TRACE_ZONE("LoadSurface");
+
     SDL_Surface *loadedSurface = IMG_Load(path.c_str());
 
     if (!loadedSurface)
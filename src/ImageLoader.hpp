@@ -4,5 +4,6 @@
 #include <SDL2/SDL_image.h>
 
 #include "Error.hpp"
+#include "Trace.hpp"
 
 SDL_Surface *LoadSurface(const std::string &path);
\ No newline at end of file
@@ -1,45 +1,157 @@
 #include "Input.hpp"
 
-void Input::UpdateStateKeyDown(KeyCode keyCode)
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+bool Input::GetBit(const uint32_t *bitset, uint32_t index)
+{
+    return (bitset[index / 32] >> (index % 32)) & 1;
+}
+
+void Input::SetBit(uint32_t *bitset, uint32_t index)
+{
+    bitset[index / 32] |= 1u << (index % 32);
+}
+
+void Input::ClearBit(uint32_t *bitset, uint32_t index)
+{
+    bitset[index / 32] &= ~(1u << (index % 32));
+}
+
+void Input::UpdateFirstEventTime(uint32_t timestamp)
+{
+    if (firstEventTime == 0 || timestamp < firstEventTime)
+    {
+        firstEventTime = timestamp;
+    }
+}
+
+uint32_t Input::GetKeyIndex(KeyCode keyCode)
+{
+    uint32_t value = static_cast<uint32_t>(keyCode);
+
+    if (value < 128)
+    {
+        return value;
+    }
+
+    if (value & SDLK_SCANCODE_MASK)
+    {
+        uint32_t scancode = value & ~SDLK_SCANCODE_MASK;
+
+        return scancode < SDL_NUM_SCANCODES ? 128 + scancode : keyIndexCount;
+    }
+
+    for (uint32_t i = 0; i < overflowKeyCount; i++)
+    {
+        if (overflowKeys[i] == keyCode)
+        {
+            return overflowKeyIndexStart + i;
+        }
+    }
+
+    return keyIndexCount;
+}
+
+uint32_t Input::AddKeyIndex(KeyCode keyCode)
+{
+    uint32_t keyIndex = GetKeyIndex(keyCode);
+    uint32_t value = static_cast<uint32_t>(keyCode);
+
+    if (keyIndex != keyIndexCount || value & SDLK_SCANCODE_MASK)
+    {
+        return keyIndex;
+    }
+
+    if (overflowKeyCount == maxOverflowKeys)
+    {
+        if (!hasWarnedAboutOverflowKeys)
+        {
+            std::cout << "More than " << maxOverflowKeys << " keys with unusual keycodes were used, key " << value
+                      << " and any others after it will be ignored!\n";
+            hasWarnedAboutOverflowKeys = true;
+        }
+
+        return keyIndexCount;
+    }
+
+    overflowKeys[overflowKeyCount] = keyCode;
+
+    return overflowKeyIndexStart + overflowKeyCount++;
+}
+
+void Input::UpdateStateKeyDown(KeyCode keyCode, uint32_t timestamp)
 {
-    if (heldKeys.find(keyCode) == heldKeys.end())
+    uint32_t keyIndex = AddKeyIndex(keyCode);
+
+    if (keyIndex == keyIndexCount)
     {
-        pressedKeys.insert(keyCode);
+        return;
+    }
+
+    // Repeats of a held key aren't presses.
+    if (!GetBit(heldKeys.data(), keyIndex))
+    {
+        SetBit(pressedKeys.data(), keyIndex);
+        keyPressedTimes[keyIndex] = timestamp;
         allPressedKeys.push_back(keyCode);
+        UpdateFirstEventTime(timestamp);
     }
 
-    heldKeys.insert(keyCode);
+    SetBit(heldKeys.data(), keyIndex);
 }
 
-void Input::UpdateStateKeyUp(KeyCode keyCode)
+void Input::UpdateStateKeyUp(KeyCode keyCode, uint32_t timestamp)
 {
-    releasedKeys.insert(keyCode);
-    heldKeys.erase(keyCode);
+    uint32_t keyIndex = AddKeyIndex(keyCode);
+
+    if (keyIndex == keyIndexCount)
+    {
+        return;
+    }
+
+    SetBit(releasedKeys.data(), keyIndex);
+    ClearBit(heldKeys.data(), keyIndex);
+    keyReleasedTimes[keyIndex] = timestamp;
+    UpdateFirstEventTime(timestamp);
 }
 
 void Input::Update()
 {
-    pressedKeys.clear();
-    releasedKeys.clear();
+    pressedKeys.fill(0);
+    releasedKeys.fill(0);
     allPressedKeys.clear();
 
-    pressedMouseButtons.clear();
-    releasedMouseButtons.clear();
+    pressedMouseButtons = 0;
+    releasedMouseButtons = 0;
+
+    firstEventTime = 0;
 }
 
 bool Input::IsKeyHeld(KeyCode keyCode)
 {
-    return heldKeys.find(keyCode) != heldKeys.end();
+    return GetBit(heldKeys.data(), GetKeyIndex(keyCode));
 }
 
 bool Input::WasKeyPressed(KeyCode keyCode)
 {
-    return pressedKeys.find(keyCode) != pressedKeys.end();
+    return GetBit(pressedKeys.data(), GetKeyIndex(keyCode));
 }
 
 bool Input::WasKeyReleased(KeyCode keyCode)
 {
-    return releasedKeys.find(keyCode) != releasedKeys.end();
+    return GetBit(releasedKeys.data(), GetKeyIndex(keyCode));
+}
+
+uint32_t Input::GetKeyPressedTime(KeyCode keyCode)
+{
+    return keyPressedTimes[GetKeyIndex(keyCode)];
+}
+
+uint32_t Input::GetKeyReleasedTime(KeyCode keyCode)
+{
+    return keyReleasedTimes[GetKeyIndex(keyCode)];
 }
 
 const std::vector<KeyCode> &Input::GetPressedKeys()
@@ -47,8 +159,24 @@ const std::vector<KeyCode> &Input::GetPressedKeys()
     return allPressedKeys;
 }
 
+void Input::SetMouseReplayed(bool isReplayed)
+{
+    isMouseReplayed = isReplayed;
+}
+
+void Input::UpdateStateMouseMove(int32_t x, int32_t y)
+{
+    mouseX = x;
+    mouseY = y;
+}
+
 int32_t Input::GetMouseX()
 {
+    if (isMouseReplayed)
+    {
+        return mouseX;
+    }
+
     int32_t x;
     SDL_GetMouseState(&x, nullptr);
 
@@ -57,39 +185,84 @@ int32_t Input::GetMouseX()
 
 int32_t Input::GetMouseY()
 {
+    if (isMouseReplayed)
+    {
+        return mouseY;
+    }
+
     int32_t y;
     SDL_GetMouseState(nullptr, &y);
 
     return y;
 }
 
-void Input::UpdateStateMouseDown(MouseButton mouseButton)
+void Input::UpdateStateMouseDown(MouseButton mouseButton, uint32_t timestamp)
 {
-    if (heldMouseButtons.find(mouseButton) == heldMouseButtons.end())
+    uint32_t bit = 1u << (mouseButton % mouseButtonCount);
+
+    if (!(heldMouseButtons & bit))
     {
-        pressedMouseButtons.insert(mouseButton);
+        pressedMouseButtons |= bit;
+        mouseButtonPressedTimes[mouseButton % mouseButtonCount] = timestamp;
+        UpdateFirstEventTime(timestamp);
     }
 
-    heldMouseButtons.insert(mouseButton);
+    heldMouseButtons |= bit;
 }
 
-void Input::UpdateStateMouseUp(MouseButton mouseButton)
+void Input::UpdateStateMouseUp(MouseButton mouseButton, uint32_t timestamp)
 {
-    releasedMouseButtons.insert(mouseButton);
-    heldMouseButtons.erase(mouseButton);
+    uint32_t bit = 1u << (mouseButton % mouseButtonCount);
+
+    releasedMouseButtons |= bit;
+    heldMouseButtons &= ~bit;
+    UpdateFirstEventTime(timestamp);
 }
 
 bool Input::IsMouseButtonHeld(MouseButton mouseButton)
 {
-    return heldMouseButtons.find(mouseButton) != heldMouseButtons.end();
+    return (heldMouseButtons >> (mouseButton % mouseButtonCount)) & 1;
 }
 
 bool Input::WasMouseButtonPressed(MouseButton mouseButton)
 {
-    return pressedMouseButtons.find(mouseButton) != pressedMouseButtons.end();
+    return (pressedMouseButtons >> (mouseButton % mouseButtonCount)) & 1;
 }
 
 bool Input::WasMouseButtonReleased(MouseButton mouseButton)
 {
-    return releasedMouseButtons.find(mouseButton) != releasedMouseButtons.end();
-}
\ No newline at end of file
+    return (releasedMouseButtons >> (mouseButton % mouseButtonCount)) & 1;
+}
+
+uint32_t Input::GetMouseButtonPressedTime(MouseButton mouseButton)
+{
+    return mouseButtonPressedTimes[mouseButton % mouseButtonCount];
+}
+
+uint32_t Input::GetFirstEventTime()
+{
+    return firstEventTime;
+}
+
+void Input::GetSnapshot(InputSnapshot &snapshot)
+{
+    snapshot.mouseX = GetMouseX();
+    snapshot.mouseY = GetMouseY();
+
+    snapshot.heldMouseButtons = heldMouseButtons;
+    snapshot.pressedMouseButtons = pressedMouseButtons;
+    snapshot.releasedMouseButtons = releasedMouseButtons;
+
+    std::memcpy(snapshot.heldKeys, heldKeys.data(), sizeof(snapshot.heldKeys));
+    std::memcpy(snapshot.pressedKeys, pressedKeys.data(), sizeof(snapshot.pressedKeys));
+    std::memcpy(snapshot.releasedKeys, releasedKeys.data(), sizeof(snapshot.releasedKeys));
+
+    snapshot.pressedKeyCount = static_cast<uint32_t>(std::min<size_t>(allPressedKeys.size(), maxSnapshotPressedKeys));
+
+    for (uint32_t i = 0; i < maxSnapshotPressedKeys; i++)
+    {
+        snapshot.pressedKeyList[i] = i < snapshot.pressedKeyCount ? allPressedKeys[i] : 0;
+    }
+
+    std::memcpy(snapshot.overflowKeys, overflowKeys.data(), sizeof(snapshot.overflowKeys));
+}
@@ -3,7 +3,8 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
 
-#include <unordered_set>
+#include <array>
+#include <cinttypes>
 #include <vector>
 
 enum KeyCode
@@ -211,36 +212,108 @@ enum MouseButton {
     MouseButtonX2 = SDL_BUTTON_X2,
 };
 
+// Keys are numbered densely for bitsets, keycodes below 128 are characters and keep their values, scancodes with
+// SDLK_SCANCODE_MASK set are numbered after them. Any other keycode, such as the Unicode characters that SDL gives keys
+// on non-US layouts, takes one of the overflow indices after the scancodes the first time it's seen.
+const uint32_t overflowKeyIndexStart = 128 + SDL_NUM_SCANCODES;
+const uint32_t maxOverflowKeys = 32;
+const uint32_t keyIndexCount = overflowKeyIndexStart + maxOverflowKeys;
+const uint32_t keyBitsetWordCount = keyIndexCount / 32;
+// Keys pressed after this many in one frame are left out of InputSnapshot::pressedKeys.
+const uint32_t maxSnapshotPressedKeys = 32;
+
+// All of a frame's input in one block, so that bindings can copy it out in a single call. Only made of 32 bit
+// integers, so it has no padding and the layout is the same on every platform. Bit i of a key bitset is word i / 32,
+// bit i % 32, with i from Input::GetKeyIndex. Bit n of a mouse button mask is the MouseButton with value n.
+struct InputSnapshot
+{
+    int32_t mouseX;
+    int32_t mouseY;
+    uint32_t heldMouseButtons;
+    uint32_t pressedMouseButtons;
+    uint32_t releasedMouseButtons;
+    uint32_t pressedKeyCount;
+    uint32_t heldKeys[keyBitsetWordCount];
+    uint32_t pressedKeys[keyBitsetWordCount];
+    uint32_t releasedKeys[keyBitsetWordCount];
+    // In the order they were pressed.
+    int32_t pressedKeyList[maxSnapshotPressedKeys];
+    // The keycode given each overflow index, zero for indices that haven't been given out.
+    int32_t overflowKeys[maxOverflowKeys];
+};
+
+// Mouse buttons are bits of a 32 bit mask, SDL's button numbers are all well below that.
+const uint32_t mouseButtonCount = 32;
+
+// Key and mouse button states are bitsets indexed by GetKeyIndex and button number, with the edges of the current
+// frame in their own bitsets, so queries are a shift and a mask and starting a frame is clearing a few words.
 class Input
 {
 public:
-    void UpdateStateKeyDown(KeyCode keyCode);
-    void UpdateStateKeyUp(KeyCode keyCode);
+    // Timestamps are SDL's milliseconds since initialization, from the event that caused the change.
+    void UpdateStateKeyDown(KeyCode keyCode, uint32_t timestamp = 0);
+    void UpdateStateKeyUp(KeyCode keyCode, uint32_t timestamp = 0);
     void Update();
 
     bool IsKeyHeld(KeyCode keyCode);
     bool WasKeyPressed(KeyCode keyCode);
     bool WasKeyReleased(KeyCode keyCode);
+    // When the key was last pressed or released, compare with SDL_GetTicks to find how long input waited for a frame.
+    uint32_t GetKeyPressedTime(KeyCode keyCode);
+    uint32_t GetKeyReleasedTime(KeyCode keyCode);
 
     const std::vector<KeyCode> &GetPressedKeys();
 
+    // The position is asked of SDL, unless the mouse is replayed, then it's the last one given to UpdateStateMouseMove.
+    void SetMouseReplayed(bool isReplayed);
+    void UpdateStateMouseMove(int32_t x, int32_t y);
     int32_t GetMouseX();
     int32_t GetMouseY();
 
-    void UpdateStateMouseDown(MouseButton mouseButton);
-    void UpdateStateMouseUp(MouseButton mouseButton);
+    void UpdateStateMouseDown(MouseButton mouseButton, uint32_t timestamp = 0);
+    void UpdateStateMouseUp(MouseButton mouseButton, uint32_t timestamp = 0);
 
     bool IsMouseButtonHeld(MouseButton mouseButton);
     bool WasMouseButtonPressed(MouseButton mouseButton);
     bool WasMouseButtonReleased(MouseButton mouseButton);
+    uint32_t GetMouseButtonPressedTime(MouseButton mouseButton);
+
+    // The oldest event handled since the last Update, or zero if there were none.
+    uint32_t GetFirstEventTime();
+
+    void GetSnapshot(InputSnapshot &snapshot);
+
+    // Returns keyIndexCount for keycodes that don't map to any key, including ones that haven't been seen yet and would
+    // need an overflow index.
+    uint32_t GetKeyIndex(KeyCode keyCode);
 
   private:
-    std::unordered_set<KeyCode> heldKeys;
-    std::unordered_set<KeyCode> pressedKeys;
-    std::unordered_set<KeyCode> releasedKeys;
+    static bool GetBit(const uint32_t *bitset, uint32_t index);
+    static void SetBit(uint32_t *bitset, uint32_t index);
+    static void ClearBit(uint32_t *bitset, uint32_t index);
+    void UpdateFirstEventTime(uint32_t timestamp);
+    // Like GetKeyIndex, but gives keycodes that need an overflow index one if there are any left.
+    uint32_t AddKeyIndex(KeyCode keyCode);
+
+    // The extra word holds keyIndexCount, which GetKeyIndex returns for unknown keys and is never set, so queries
+    // for them don't need a bounds check.
+    std::array<uint32_t, keyBitsetWordCount + 1> heldKeys{};
+    std::array<uint32_t, keyBitsetWordCount + 1> pressedKeys{};
+    std::array<uint32_t, keyBitsetWordCount + 1> releasedKeys{};
+    std::array<uint32_t, keyIndexCount + 1> keyPressedTimes{};
+    std::array<uint32_t, keyIndexCount + 1> keyReleasedTimes{};
     std::vector<KeyCode> allPressedKeys;
+    std::array<int32_t, maxOverflowKeys> overflowKeys{};
+    uint32_t overflowKeyCount = 0;
+    bool hasWarnedAboutOverflowKeys = false;
 
-    std::unordered_set<MouseButton> heldMouseButtons;
-    std::unordered_set<MouseButton> pressedMouseButtons;
-    std::unordered_set<MouseButton> releasedMouseButtons;
-};
\ No newline at end of file
+    bool isMouseReplayed = false;
+    int32_t mouseX = 0;
+    int32_t mouseY = 0;
+    uint32_t heldMouseButtons = 0;
+    uint32_t pressedMouseButtons = 0;
+    uint32_t releasedMouseButtons = 0;
+    std::array<uint32_t, mouseButtonCount> mouseButtonPressedTimes{};
+
+    uint32_t firstEventTime = 0;
+};
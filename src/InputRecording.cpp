@@ -0,0 +1,140 @@
+#include "InputRecording.hpp"
+
+bool ToInputEvent(const SDL_Event &sdlEvent, InputEvent &event)
+{
+    switch (sdlEvent.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        event.type = sdlEvent.type == SDL_KEYDOWN ? InputEventKeyDown : InputEventKeyUp;
+        event.code = sdlEvent.key.keysym.sym;
+        return true;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        event.type = sdlEvent.type == SDL_MOUSEBUTTONDOWN ? InputEventMouseDown : InputEventMouseUp;
+        event.code = sdlEvent.button.button;
+        return true;
+    case SDL_WINDOWEVENT:
+        if (sdlEvent.window.event != SDL_WINDOWEVENT_RESIZED)
+        {
+            return false;
+        }
+
+        event.type = InputEventResizeWindow;
+        event.x = sdlEvent.window.data1;
+        event.y = sdlEvent.window.data2;
+        return true;
+    case SDL_QUIT:
+        event.type = InputEventQuit;
+        return true;
+    }
+
+    return false;
+}
+
+InputRecorder::~InputRecorder()
+{
+    Stop();
+}
+
+bool InputRecorder::Start(const std::string &path)
+{
+    Stop();
+
+    file.open(path, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        std::cout << "Failed to open input recording: " << path << "\n";
+        return false;
+    }
+
+    WriteBinaryHeader(file, inputRecordingMagic, inputRecordingVersion);
+    hasMousePosition = false;
+
+    return true;
+}
+
+void InputRecorder::Stop()
+{
+    if (file.is_open())
+    {
+        file.close();
+    }
+}
+
+bool InputRecorder::IsRecording()
+{
+    return file.is_open();
+}
+
+void InputRecorder::RecordFrame(float deltaTime, const std::vector<InputEvent> &events, int32_t mouseX,
+                                int32_t mouseY)
+{
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    bool hasMouseMoved = !hasMousePosition || mouseX != lastMouseX || mouseY != lastMouseY;
+    hasMousePosition = true;
+    lastMouseX = mouseX;
+    lastMouseY = mouseY;
+
+    WriteBinary(file, deltaTime);
+    WriteBinary(file, static_cast<uint32_t>(events.size() + (hasMouseMoved ? 1 : 0)));
+
+    // Before the other events, so that clicks are replayed at the position they happened at.
+    if (hasMouseMoved)
+    {
+        WriteBinary(file, static_cast<uint8_t>(InputEventMouseMove));
+        WriteBinary(file, int32_t{0});
+        WriteBinary(file, mouseX);
+        WriteBinary(file, mouseY);
+    }
+
+    for (const InputEvent &event : events)
+    {
+        WriteBinary(file, static_cast<uint8_t>(event.type));
+        WriteBinary(file, event.code);
+        WriteBinary(file, event.x);
+        WriteBinary(file, event.y);
+    }
+}
+
+InputReplay::InputReplay(const std::string &path)
+    : reader(path, "input recording", inputRecordingMagic, inputRecordingVersion)
+{
+}
+
+bool InputReplay::ReadFrame(float &deltaTime, std::vector<InputEvent> &events)
+{
+    events.clear();
+
+    if (reader.IsAtEnd())
+    {
+        return false;
+    }
+
+    deltaTime = reader.Read<float>();
+    uint32_t eventCount = reader.Read<uint32_t>();
+
+    for (uint32_t i = 0; i < eventCount; i++)
+    {
+        uint8_t type = reader.Read<uint8_t>();
+
+        if (type > InputEventQuit)
+        {
+            RUNTIME_ERROR("Unknown input event type: " << static_cast<uint32_t>(type));
+        }
+
+        InputEvent event;
+        event.type = static_cast<InputEventType>(type);
+        event.code = reader.Read<int32_t>();
+        event.x = reader.Read<int32_t>();
+        event.y = reader.Read<int32_t>();
+        events.push_back(event);
+    }
+
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cinttypes>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BinaryFile.hpp"
+#include "Input.hpp"
+
+// After the header with inputRecordingMagic, see BinaryFile.hpp, each frame follows as its float32 delta time and
+// uint32 event count, then each event as a uint8 InputEventType and int32 code, x and y.
+const char inputRecordingMagic[4] = {'P', 'X', 'L', 'I'};
+const uint32_t inputRecordingVersion = 1;
+
+// Set to a path to record input from the first frame, or to replay a recording instead of reading real input.
+const char *const inputRecordEnvironmentVariable = "PXLIO_INPUT_RECORD";
+const char *const inputReplayEnvironmentVariable = "PXLIO_INPUT_REPLAY";
+
+enum InputEventType
+{
+    // code is the KeyCode.
+    InputEventKeyDown,
+    InputEventKeyUp,
+    // code is the MouseButton.
+    InputEventMouseDown,
+    InputEventMouseUp,
+    // x and y are the mouse position.
+    InputEventMouseMove,
+    // x and y are the window size.
+    InputEventResizeWindow,
+    InputEventQuit,
+};
+
+// The parts of an SDL event that input and the window depend on. Timestamps aren't kept, so replayed events are
+// stamped with the time they were replayed at instead.
+struct InputEvent
+{
+    InputEventType type;
+    int32_t code = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+};
+
+// Returns false for events that don't affect input or the window. Mouse motion is left out, the position is
+// recorded once per frame instead, see InputRecorder::RecordFrame.
+bool ToInputEvent(const SDL_Event &sdlEvent, InputEvent &event);
+
+// Writes the events handled each frame, along with the delta time the game was given.
+class InputRecorder
+{
+  public:
+    ~InputRecorder();
+
+    // Returns false if the file couldn't be opened. Keys and buttons held before the call are missing from the
+    // recording, so it should be started before the first frame that handles input.
+    bool Start(const std::string &path);
+    void Stop();
+    bool IsRecording();
+
+    // The mouse position is recorded as an InputEventMouseMove whenever it differs from the last frame's, including on
+    // the first frame, so that replays start with the cursor where it was.
+    void RecordFrame(float deltaTime, const std::vector<InputEvent> &events, int32_t mouseX, int32_t mouseY);
+
+  private:
+    std::ofstream file;
+    bool hasMousePosition = false;
+    int32_t lastMouseX = 0;
+    int32_t lastMouseY = 0;
+};
+
+// Steps through a file written by InputRecorder, handing back one frame's delta time and events at a time.
+class InputReplay
+{
+  public:
+    InputReplay(const std::string &path);
+
+    // Replaces events with the next frame's, returns false once the recording has ended.
+    bool ReadFrame(float &deltaTime, std::vector<InputEvent> &events);
+
+  private:
+    BinaryReader reader;
+};
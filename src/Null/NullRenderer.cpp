@@ -0,0 +1,207 @@
+#include "NullRenderer.hpp"
+
+NullRenderer::NullRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight,
+                           int32_t viewWidth, int32_t viewHeight, const PresentConfig &presentConfig)
+    : windowWidth(windowWidth), windowHeight(windowHeight), viewWidth(viewWidth), viewHeight(viewHeight),
+      presentConfig(presentConfig)
+{
+    if (presentConfig.maxFramesInFlight < 1)
+    {
+        RUNTIME_ERROR("At least one frame must be allowed in flight!");
+    }
+
+    // Has to be set before SDL initializes its video subsystem.
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        SDL_Quit();
+        INIT_ERROR("Failed to initialize SDL!");
+    }
+
+    // Machines that run without a GPU often have no audio device either, so audio is optional here.
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
+    {
+        std::cout << "Failed to initialize SDL audio, continuing without it\n";
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        SDL_Quit();
+        INIT_ERROR("Failed to initialize SDL Image!");
+    }
+
+    window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, windowWidth,
+                              windowHeight, SDL_WINDOW_HIDDEN);
+
+    if (!window)
+    {
+        SDL_Quit();
+        INIT_ERROR("Failed to create a window!");
+    }
+
+    framePacer.SetTargetFps(presentConfig.targetFps);
+}
+
+NullRenderer::~NullRenderer()
+{
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+void NullRenderer::ResizeWindow(int32_t windowWidth, int32_t windowHeight)
+{
+    this->windowWidth = windowWidth;
+    this->windowHeight = windowHeight;
+}
+
+SDL_Window *NullRenderer::GetWindowPtr()
+{
+    return window;
+}
+
+RendererBackend NullRenderer::GetBackend()
+{
+    return RendererBackendNull;
+}
+
+void NullRenderer::SetBackgroundColor(float r, float g, float b)
+{
+}
+
+void NullRenderer::SetScreenBackgroundColor(float r, float g, float b)
+{
+}
+
+void NullRenderer::BeginDrawing()
+{
+    AllocationTracker::Begin();
+
+    PXLIO_TRACE_ZONE("NullRenderer::BeginDrawing");
+
+    frameStartTime = std::chrono::steady_clock::now();
+    currentFrameStats = FrameStats{};
+}
+
+void NullRenderer::EndDrawing()
+{
+    PXLIO_TRACE_ZONE("NullRenderer::EndDrawing");
+
+    // There is nothing to present, so the present interval is the time between calls to EndDrawing.
+    auto presentTime = std::chrono::steady_clock::now();
+    if (lastPresentTime != std::chrono::steady_clock::time_point())
+    {
+        std::chrono::duration<float, std::milli> presentInterval = presentTime - lastPresentTime;
+        frameTimeHistograms[FrameTimeKindPresent].Add(presentInterval.count());
+    }
+    lastPresentTime = presentTime;
+
+    frameTimeHistograms[FrameTimeKindCpu].Add(CalcElapsedMs(frameStartTime));
+
+    AllocationTracker::End();
+    const AllocationReport &allocationReport = AllocationTracker::GetLastReport();
+    currentFrameStats.heapAllocations = static_cast<uint32_t>(allocationReport.count);
+    currentFrameStats.heapAllocatedBytes = allocationReport.byteSize;
+
+    frameStats = currentFrameStats;
+
+    framePacer.Wait();
+
+    Trace::NextFrame();
+}
+
+PresentStatus NullRenderer::GetPresentStatus()
+{
+    // Nothing ever waits for a display, which is closest to immediate presentation.
+    return PresentStatus{
+        PresentModeImmediate,
+        0,
+        presentConfig.maxFramesInFlight,
+        presentConfig.targetFps,
+        0.0f,
+    };
+}
+
+const FrameStats &NullRenderer::GetFrameStats()
+{
+    return frameStats;
+}
+
+const GpuTimings &NullRenderer::GetGpuTimings()
+{
+    return gpuTimings;
+}
+
+void NullRenderer::SetGpuTimingsCsvPath(const std::string &path)
+{
+    // There are never any GPU timings to write.
+}
+
+MemoryReport NullRenderer::GetMemoryReport()
+{
+    // Only the CPU side of each batch exists, there are no device allocations or heaps.
+    MemoryReport report;
+
+    spriteBatches.ForEach([&](uint32_t id, NullSpriteBatchData &spriteBatchData) {
+        report.spriteBatches.push_back(CalcSpriteBatchMemory(id, spriteBatchData.maxSprites, spriteBatchData.capacity,
+                                                             spriteBatchData.peakSprites));
+    });
+
+    return report;
+}
+
+FrameTimeHistogram &NullRenderer::GetFrameTimeHistogram(FrameTimeKind kind)
+{
+    return frameTimeHistograms[kind];
+}
+
+SpriteBatch &NullRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
+                                             bool enableBlending)
+{
+    PXLIO_TRACE_ZONE("NullRenderer::CreateSpriteBatch");
+
+    // The texture is still decoded, the batch needs its size and missing textures should fail the same way as on
+    // the other backends.
+    SDL_Surface *surface = LoadSurface(texturePath);
+    int32_t textureWidth = surface->w;
+    int32_t textureHeight = surface->h;
+    SDL_FreeSurface(surface);
+
+    NullSpriteBatchData spriteBatchData;
+    spriteBatchData.maxSprites = maxSprites;
+
+    return spriteBatches.Create(textureWidth, textureHeight, maxSprites, enableBlending, spriteBatchData);
+}
+
+void NullRenderer::DrawSpriteBatch(SpriteBatch &spriteBatch)
+{
+    PXLIO_TRACE_ZONE("NullRenderer::DrawSpriteBatch");
+
+    NullSpriteBatchData *spriteBatchData = spriteBatches.Get(spriteBatch);
+
+    if (!spriteBatchData)
+    {
+        return;
+    }
+
+    spriteBatchData->capacity = spriteBatch.GetCapacity();
+    spriteBatchData->peakSprites = std::max(spriteBatchData->peakSprites,
+                                            spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount());
+
+    // Counted as if the batch was drawn, so that batching can be compared without a GPU. Nothing is uploaded.
+    currentFrameStats.spritesSubmitted += spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.spritesCulled += spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.drawCalls++;
+    currentFrameStats.pipelineBinds++;
+    currentFrameStats.textureBinds++;
+}
+
+void NullRenderer::DestroySpriteBatch(SpriteBatch &spriteBatch)
+{
+    spriteBatches.Destroy(spriteBatch);
+}
+
+SpriteBatch *NullRenderer::GetSpriteBatch(uint32_t id)
+{
+    return spriteBatches.GetSpriteBatch(id);
+}
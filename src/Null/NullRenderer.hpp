@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "../FramePacer.hpp"
+#include "../ImageLoader.hpp"
+#include "../Renderer.hpp"
+#include "../SpriteBatchPool.hpp"
+
+struct NullSpriteBatchData
+{
+    uint32_t maxSprites = 0;
+    // The batch's capacity as of its last draw.
+    uint32_t capacity = 0;
+    uint32_t peakSprites = 0;
+};
+
+// Does all of the CPU side work of a renderer and counts stats as if the batches were drawn, but creates no GPU
+// context and draws nothing. The window uses SDL's dummy video driver, so it is never shown and never receives input.
+class NullRenderer : public Renderer
+{
+  public:
+    NullRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
+                 int32_t viewHeight, const PresentConfig &presentConfig = PresentConfig());
+
+    ~NullRenderer() override;
+    void ResizeWindow(int32_t windowWidth, int32_t windowHeight) override;
+    SDL_Window *GetWindowPtr() override;
+    RendererBackend GetBackend() override;
+
+    void SetBackgroundColor(float r, float g, float b) override;
+    void SetScreenBackgroundColor(float r, float g, float b) override;
+    void BeginDrawing() override;
+    void EndDrawing() override;
+
+    PresentStatus GetPresentStatus() override;
+    const FrameStats &GetFrameStats() override;
+    const GpuTimings &GetGpuTimings() override;
+    void SetGpuTimingsCsvPath(const std::string &path) override;
+    MemoryReport GetMemoryReport() override;
+    FrameTimeHistogram &GetFrameTimeHistogram(FrameTimeKind kind) override;
+
+    SpriteBatch &CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
+                                   bool enableBlending = false) override;
+    void DrawSpriteBatch(SpriteBatch &spriteBatch) override;
+    void DestroySpriteBatch(SpriteBatch &spriteBatch) override;
+    SpriteBatch *GetSpriteBatch(uint32_t id) override;
+
+  private:
+    SDL_Window *window = nullptr;
+    int32_t windowWidth = 0;
+    int32_t windowHeight = 0;
+    int32_t viewWidth = 0;
+    int32_t viewHeight = 0;
+
+    PresentConfig presentConfig;
+    FramePacer framePacer;
+    std::chrono::steady_clock::time_point frameStartTime;
+
+    FrameStats frameStats;
+    FrameStats currentFrameStats;
+    // Always invalid, there is no GPU to time.
+    GpuTimings gpuTimings;
+
+    std::array<FrameTimeHistogram, frameTimeKindCount> frameTimeHistograms;
+    std::chrono::steady_clock::time_point lastPresentTime;
+
+    SpriteBatchPool<NullSpriteBatchData> spriteBatches;
+};
@@ -0,0 +1,149 @@
+#include "GLGpuTimer.hpp"
+
+#include <algorithm>
+
+void GLGpuTimer::Create(uint32_t maxFramesInFlight)
+{
+#ifndef EMSCRIPTEN
+    if (!GLAD_GL_VERSION_3_3 && !GLAD_GL_ARB_timer_query)
+    {
+        return;
+    }
+
+    queries.resize(gpuTimestampsPerFrame * maxFramesInFlight);
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    writtenQueries.resize(queries.size(), false);
+
+    frames.resize(maxFramesInFlight);
+    timestamps.resize(gpuTimestampsPerFrame);
+    supported = true;
+#endif
+}
+
+void GLGpuTimer::Cleanup()
+{
+    if (!queries.empty())
+    {
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        queries.clear();
+    }
+}
+
+void GLGpuTimer::BeginFrame(uint32_t frameIndex)
+{
+    if (!supported)
+    {
+        return;
+    }
+
+    currentFrameIndex = frameIndex;
+
+    GpuTimestampFrame &timestampFrame = frames[frameIndex];
+    timestampFrame.frame = frameCount++;
+    timestampFrame.pending = true;
+    timestampFrame.spriteBatchIds.clear();
+
+    std::fill(writtenQueries.begin() + frameIndex * gpuTimestampsPerFrame,
+              writtenQueries.begin() + (frameIndex + 1) * gpuTimestampsPerFrame, false);
+}
+
+void GLGpuTimer::Write(GpuTimestamp timestamp)
+{
+    if (!supported)
+    {
+        return;
+    }
+
+    WriteQuery(timestamp);
+}
+
+void GLGpuTimer::BeginSpriteBatch(uint32_t spriteBatchId)
+{
+    timingSpriteBatch = false;
+
+    if (!supported)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> &spriteBatchIds = frames[currentFrameIndex].spriteBatchIds;
+
+    if (spriteBatchIds.size() >= maxTimedSpriteBatches)
+    {
+        return;
+    }
+
+    WriteQuery(GpuTimestampFirstSpriteBatch + static_cast<uint32_t>(spriteBatchIds.size()) * 2);
+
+    spriteBatchIds.push_back(spriteBatchId);
+    timingSpriteBatch = true;
+}
+
+void GLGpuTimer::EndSpriteBatch()
+{
+    if (!timingSpriteBatch)
+    {
+        return;
+    }
+
+    uint32_t spriteBatchCount = static_cast<uint32_t>(frames[currentFrameIndex].spriteBatchIds.size());
+    WriteQuery(GpuTimestampFirstSpriteBatch + spriteBatchCount * 2 - 1);
+
+    timingSpriteBatch = false;
+}
+
+bool GLGpuTimer::Read(uint32_t frameIndex, GpuTimings &timings)
+{
+    if (!supported || !frames[frameIndex].pending)
+    {
+        return false;
+    }
+
+    GpuTimestampFrame &timestampFrame = frames[frameIndex];
+    timestampFrame.pending = false;
+
+    uint32_t spriteBatchCount = static_cast<uint32_t>(timestampFrame.spriteBatchIds.size());
+    uint32_t queryCount = GpuTimestampFirstSpriteBatch + spriteBatchCount * 2;
+    std::fill(timestamps.begin(), timestamps.begin() + queryCount, std::nullopt);
+
+#ifndef EMSCRIPTEN
+    for (uint32_t i = 0; i < queryCount; i++)
+    {
+        uint32_t query = frameIndex * gpuTimestampsPerFrame + i;
+
+        if (!writtenQueries[query])
+        {
+            continue;
+        }
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available == GL_TRUE)
+        {
+            GLuint64 timestamp;
+            glGetQueryObjectui64v(queries[query], GL_QUERY_RESULT, &timestamp);
+            timestamps[i] = timestamp;
+        }
+    }
+#endif
+
+    // GL timestamps are already in nanoseconds.
+    ResolveGpuTimings(timestampFrame, timestamps, 1.0, timings);
+
+    return true;
+}
+
+const bool GLGpuTimer::GetSupported()
+{
+    return supported;
+}
+
+void GLGpuTimer::WriteQuery(uint32_t query)
+{
+#ifndef EMSCRIPTEN
+    uint32_t index = currentFrameIndex * gpuTimestampsPerFrame + query;
+    glQueryCounter(queries[index], GL_TIMESTAMP);
+    writtenQueries[index] = true;
+#endif
+}
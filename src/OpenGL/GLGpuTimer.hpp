@@ -0,0 +1,47 @@
+#pragma once
+
+#ifdef EMSCRIPTEN
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <optional>
+#include <vector>
+
+#include "../GpuTimings.hpp"
+
+// Timestamp queries are used instead of GL_TIME_ELAPSED because elapsed time queries can't be nested, and the
+// sprite batches are drawn inside of the view pass. Both need ARB_timer_query, which WebGL doesn't expose, so
+// timings are never valid on the web.
+class GLGpuTimer
+{
+  public:
+    void Create(uint32_t maxFramesInFlight);
+    void Cleanup();
+
+    void BeginFrame(uint32_t frameIndex);
+    void Write(GpuTimestamp timestamp);
+    void BeginSpriteBatch(uint32_t spriteBatchId);
+    void EndSpriteBatch();
+    // Reads the results from the last time the frame index was recorded, returns false if there are none. Results
+    // that aren't available yet are skipped rather than waited on.
+    bool Read(uint32_t frameIndex, GpuTimings &timings);
+
+    const bool GetSupported();
+
+  private:
+    void WriteQuery(uint32_t query);
+
+    bool supported = false;
+    std::vector<uint32_t> queries;
+    // Queries that were never issued can't be read from.
+    std::vector<bool> writtenQueries;
+
+    std::vector<GpuTimestampFrame> frames;
+    // Sized for a full frame, so that reading results back never allocates.
+    std::vector<std::optional<uint64_t>> timestamps;
+    uint32_t currentFrameIndex = 0;
+    uint64_t frameCount = 0;
+    bool timingSpriteBatch = false;
+};
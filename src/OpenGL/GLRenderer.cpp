@@ -101,82 +101,35 @@ const std::vector<float> screenVertices = {
 };
 
 GLRenderer::GLRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
-                       int32_t viewHeight, bool enableVsync)
-    : windowWidth(windowWidth), windowHeight(windowHeight), viewWidth(viewWidth), viewHeight(viewHeight)
+                       int32_t viewHeight, const PresentConfig &presentConfig)
+    : windowWidth(windowWidth), windowHeight(windowHeight), viewWidth(viewWidth), viewHeight(viewHeight),
+      presentConfig(presentConfig)
 {
-
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
+    if (presentConfig.maxFramesInFlight < 1)
     {
-        RUNTIME_ERROR("Failed to initialize SDL!");
+        RUNTIME_ERROR("At least one frame must be allowed in flight!");
     }
 
-    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    try
     {
-        RUNTIME_ERROR("Failed to initialize SDL Image!");
+        InitContext(windowName);
+        InitShaders();
     }
-
-    window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth,
-                              windowHeight, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
-
-    if (!window)
+    catch (const RendererInitError &)
     {
-        RUNTIME_ERROR("Failed to create a window!");
+        CleanupFailedInit();
+        throw;
     }
 
-    SDL_GL_LoadLibrary(nullptr);
-
-    SDL_GLContext context = SDL_GL_CreateContext(window);
-    if (!context)
-    {
-        RUNTIME_ERROR("Failed to create GL context!");
-    }
+    presentMode = SetSwapInterval(presentConfig.presentMode);
+    framePacer.SetTargetFps(presentConfig.targetFps);
 
 #ifndef EMSCRIPTEN
-    SDL_GL_MakeCurrent(window, context);
-    if (!gladLoadGLLoader(SDL_GL_GetProcAddress))
-    {
-        RUNTIME_ERROR("Failed to load GL!");
-    }
+    frameFences.resize(presentConfig.maxFramesInFlight, nullptr);
+    frameFenceStartTimes.resize(presentConfig.maxFramesInFlight);
 #endif
 
-    SDL_GL_SetSwapInterval(enableVsync ? 1 : 0);
-
-    // Sprite shader:
-    vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    CheckShaderCompileError(vertexShader);
-
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-    CheckShaderCompileError(fragmentShader);
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    CheckShaderLinkError(shaderProgram);
-
-    glUseProgram(shaderProgram);
-    projLocation = glGetUniformLocation(shaderProgram, "proj");
-
-    // Screen shader:
-    screenVertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(screenVertexShader, 1, &screenVertexShaderSource, nullptr);
-    glCompileShader(screenVertexShader);
-    CheckShaderCompileError(screenVertexShader);
-
-    screenFragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(screenFragmentShader, 1, &screenFragmentShaderSource, nullptr);
-    glCompileShader(screenFragmentShader);
-    CheckShaderCompileError(screenFragmentShader);
-
-    screenShaderProgram = glCreateProgram();
-    glAttachShader(screenShaderProgram, screenVertexShader);
-    glAttachShader(screenShaderProgram, screenFragmentShader);
-    glLinkProgram(screenShaderProgram);
-    CheckShaderLinkError(screenShaderProgram);
+    gpuTimer.Create(presentConfig.maxFramesInFlight);
 
     // Screen model:
     glGenVertexArrays(1, &screenVao);
@@ -249,8 +202,141 @@ GLRenderer::GLRenderer(const std::string &windowName, int32_t windowWidth, int32
     ResizeWindow(windowWidth, windowHeight);
 }
 
+void GLRenderer::InitContext(const std::string &windowName)
+{
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
+    {
+        INIT_ERROR("Failed to initialize SDL!");
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        INIT_ERROR("Failed to initialize SDL Image!");
+    }
+
+    // The default framebuffer needs depth when the view is drawn into it directly.
+    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+
+    window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth,
+                              windowHeight, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+
+    if (!window)
+    {
+        INIT_ERROR("Failed to create a window!");
+    }
+
+    SDL_GL_LoadLibrary(nullptr);
+
+    context = SDL_GL_CreateContext(window);
+    if (!context)
+    {
+        INIT_ERROR("Failed to create GL context!");
+    }
+
+#ifndef EMSCRIPTEN
+    SDL_GL_MakeCurrent(window, context);
+    if (!gladLoadGLLoader(SDL_GL_GetProcAddress))
+    {
+        INIT_ERROR("Failed to load GL!");
+    }
+
+    // Fences need GL 3.2, and the shaders are written for GL ES 3 so that they are shared with the web.
+    if (!GLAD_GL_VERSION_3_2 || !(GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_ES3_compatibility))
+    {
+        INIT_ERROR("GL 3.2 with ES 3 compatibility is required!");
+    }
+#endif
+}
+
+void GLRenderer::InitShaders()
+{
+    // Sprite shader:
+    vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
+    glCompileShader(vertexShader);
+    CheckShaderCompileError(vertexShader);
+
+    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
+    glCompileShader(fragmentShader);
+    CheckShaderCompileError(fragmentShader);
+
+    shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glLinkProgram(shaderProgram);
+    CheckShaderLinkError(shaderProgram);
+
+    glUseProgram(shaderProgram);
+    projLocation = glGetUniformLocation(shaderProgram, "proj");
+
+    // Screen shader:
+    screenVertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(screenVertexShader, 1, &screenVertexShaderSource, nullptr);
+    glCompileShader(screenVertexShader);
+    CheckShaderCompileError(screenVertexShader);
+
+    screenFragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(screenFragmentShader, 1, &screenFragmentShaderSource, nullptr);
+    glCompileShader(screenFragmentShader);
+    CheckShaderCompileError(screenFragmentShader);
+
+    screenShaderProgram = glCreateProgram();
+    glAttachShader(screenShaderProgram, screenVertexShader);
+    glAttachShader(screenShaderProgram, screenFragmentShader);
+    glLinkProgram(screenShaderProgram);
+    CheckShaderLinkError(screenShaderProgram);
+}
+
+bool GLRenderer::IsAvailable()
+{
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0)
+    {
+        return false;
+    }
+
+    bool isAvailable = SDL_GL_LoadLibrary(nullptr) == 0;
+
+    if (isAvailable)
+    {
+        SDL_GL_UnloadLibrary();
+    }
+
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+
+    return isAvailable;
+}
+
+void GLRenderer::CleanupFailedInit()
+{
+    // Deleting the context also deletes any shaders that were created before the failure.
+    if (context)
+    {
+        SDL_GL_DeleteContext(context);
+    }
+
+    if (window)
+    {
+        SDL_DestroyWindow(window);
+    }
+
+    SDL_Quit();
+}
+
 GLRenderer::~GLRenderer()
 {
+    gpuTimer.Cleanup();
+
+#ifndef EMSCRIPTEN
+    for (GLsync fence : frameFences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+    }
+#endif
+
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
     glDeleteProgram(shaderProgram);
@@ -268,7 +354,8 @@ void GLRenderer::ResizeWindow(int32_t windowWidth, int32_t windowHeight)
         glm::ortho<float>(0.0f, static_cast<float>(windowWidth), 0.0f, static_cast<float>(windowHeight), 0.0f, 1.0f);
     glUniformMatrix4fv(screenProjLocation, 1, GL_FALSE, glm::value_ptr(screenProj));
 
-    ViewTransform viewTransform = Renderer::CalcViewTransform(windowWidth, windowHeight, viewWidth, viewHeight);
+    viewTransform = Renderer::CalcViewTransform(windowWidth, windowHeight, viewWidth, viewHeight);
+    compositeMode = Renderer::CalcCompositeMode(viewTransform, viewWidth, viewHeight);
 
     glUniform2f(screenViewSizeLocation, viewTransform.scaledViewWidth, viewTransform.scaledViewHeight);
     glUniform2f(screenOffsetLocation, viewTransform.offsetX, viewTransform.offsetY);
@@ -279,6 +366,11 @@ SDL_Window *GLRenderer::GetWindowPtr()
     return window;
 }
 
+RendererBackend GLRenderer::GetBackend()
+{
+    return RendererBackendOpenGL;
+}
+
 void GLRenderer::SetBackgroundColor(float r, float g, float b)
 {
     backgroundR = r;
@@ -295,6 +387,44 @@ void GLRenderer::SetScreenBackgroundColor(float r, float g, float b)
 
 void GLRenderer::BeginDrawing()
 {
+    AllocationTracker::Begin();
+
+    PXLIO_TRACE_ZONE("GLRenderer::BeginDrawing");
+
+    frameStartTime = std::chrono::steady_clock::now();
+    currentFrameStats = FrameStats{};
+
+#ifndef EMSCRIPTEN
+    // Measured from when the frame that last used this slot began, the same way as the Vulkan backend.
+    if (frameFences[currentFrame])
+    {
+        PXLIO_TRACE_ZONE("GLRenderer::WaitForFence");
+
+        while (glClientWaitSync(frameFences[currentFrame], GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX) ==
+               GL_TIMEOUT_EXPIRED)
+        {
+        }
+
+        glDeleteSync(frameFences[currentFrame]);
+        frameFences[currentFrame] = nullptr;
+
+        currentFrameStats.fenceWaitMs = CalcElapsedMs(frameStartTime);
+
+        std::chrono::duration<float, std::milli> sample =
+            std::chrono::steady_clock::now() - frameFenceStartTimes[currentFrame];
+        latencyMs = SmoothLatency(latencyMs, sample.count());
+    }
+#endif
+
+    if (gpuTimer.Read(currentFrame, gpuTimings))
+    {
+        gpuTimingsCsv.Write(gpuTimings);
+        frameTimeHistograms[FrameTimeKindGpu].Add(gpuTimings.viewPassMs + gpuTimings.compositePassMs);
+    }
+
+    gpuTimer.BeginFrame(currentFrame);
+    gpuTimer.Write(GpuTimestampViewBegin);
+
     glUseProgram(shaderProgram);
 
     float viewWidthFloat = static_cast<float>(viewWidth);
@@ -302,37 +432,237 @@ void GLRenderer::BeginDrawing()
     glm::mat4 proj = glm::ortho<float>(0.0, viewWidthFloat, 0.0f, viewHeightFloat, -zMax, zMax);
     glUniformMatrix4fv(projLocation, 1, GL_FALSE, glm::value_ptr(proj));
 
-    glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
-    glViewport(0, 0, viewWidth, viewHeight);
+    if (compositeMode == CompositeModeDirect)
+    {
+        // The whole window is cleared to the screen background, then the view's area is cleared to its own
+        // background and drawing is restricted to it.
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, windowWidth, windowHeight);
+        glClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        int32_t offsetX = static_cast<int32_t>(viewTransform.offsetX);
+        int32_t offsetY = static_cast<int32_t>(viewTransform.offsetY);
+        glViewport(offsetX, offsetY, viewWidth, viewHeight);
+        glScissor(offsetX, offsetY, viewWidth, viewHeight);
+        glEnable(GL_SCISSOR_TEST);
+    }
+    else
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+        glViewport(0, 0, viewWidth, viewHeight);
+    }
+
     glClearColor(backgroundR, backgroundG, backgroundB, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void GLRenderer::EndDrawing()
 {
+    PXLIO_TRACE_ZONE("GLRenderer::EndDrawing");
+
+    gpuTimer.Write(GpuTimestampViewEnd);
+
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    glViewport(0, 0, windowWidth, windowHeight);
-    glUseProgram(screenShaderProgram);
-    glClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, screenTexture);
-    glBindVertexArray(screenVao);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    if (compositeMode == CompositeModeDirect)
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    else if (compositeMode == CompositeModeBlit)
+    {
+        gpuTimer.Write(GpuTimestampCompositeBegin);
+
+        glViewport(0, 0, windowWidth, windowHeight);
+        glClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        int32_t offsetX = static_cast<int32_t>(viewTransform.offsetX);
+        int32_t offsetY = static_cast<int32_t>(viewTransform.offsetY);
+        int32_t scaledViewWidth = static_cast<int32_t>(viewTransform.scaledViewWidth);
+        int32_t scaledViewHeight = static_cast<int32_t>(viewTransform.scaledViewHeight);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, screenFramebuffer);
+        glBlitFramebuffer(0, 0, viewWidth, viewHeight, offsetX, offsetY, offsetX + scaledViewWidth,
+                          offsetY + scaledViewHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        gpuTimer.Write(GpuTimestampCompositeEnd);
+    }
+    else
+    {
+        gpuTimer.Write(GpuTimestampCompositeBegin);
+
+        glViewport(0, 0, windowWidth, windowHeight);
+        glUseProgram(screenShaderProgram);
+        glClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        glBindVertexArray(screenVao);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        currentFrameStats.drawCalls++;
+        currentFrameStats.pipelineBinds++;
+        currentFrameStats.textureBinds++;
+
+        gpuTimer.Write(GpuTimestampCompositeEnd);
+    }
+
+    {
+        PXLIO_TRACE_ZONE("GLRenderer::Present");
+        auto presentStartTime = std::chrono::steady_clock::now();
+        SDL_GL_SwapWindow(window);
+        currentFrameStats.presentMs = CalcElapsedMs(presentStartTime);
+    }
 
-    SDL_GL_SwapWindow(window);
+    auto presentTime = std::chrono::steady_clock::now();
+    if (lastPresentTime != std::chrono::steady_clock::time_point())
+    {
+        std::chrono::duration<float, std::milli> presentInterval = presentTime - lastPresentTime;
+        frameTimeHistograms[FrameTimeKindPresent].Add(presentInterval.count());
+    }
+    lastPresentTime = presentTime;
+
+    float blockedMs = currentFrameStats.fenceWaitMs + currentFrameStats.acquireMs + currentFrameStats.presentMs;
+    frameTimeHistograms[FrameTimeKindCpu].Add(CalcElapsedMs(frameStartTime) - blockedMs);
 
 #ifdef EMSCRIPTEN
     emscripten_sleep(0);
+#else
+    frameFences[currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frameFenceStartTimes[currentFrame] = frameStartTime;
+#endif
+
+    currentFrame = (currentFrame + 1) % presentConfig.maxFramesInFlight;
+
+    AllocationTracker::End();
+    const AllocationReport &allocationReport = AllocationTracker::GetLastReport();
+    currentFrameStats.heapAllocations = static_cast<uint32_t>(allocationReport.count);
+    currentFrameStats.heapAllocatedBytes = allocationReport.byteSize;
+
+    frameStats = currentFrameStats;
+
+    framePacer.Wait();
+
+    Trace::NextFrame();
+}
+
+PresentStatus GLRenderer::GetPresentStatus()
+{
+    // The number of buffers in the default framebuffer is managed by the driver.
+    return PresentStatus{
+        presentMode,
+        0,
+        presentConfig.maxFramesInFlight,
+        presentConfig.targetFps,
+        latencyMs,
+    };
+}
+
+const FrameStats &GLRenderer::GetFrameStats()
+{
+    return frameStats;
+}
+
+const GpuTimings &GLRenderer::GetGpuTimings()
+{
+    return gpuTimings;
+}
+
+MemoryReport GLRenderer::GetMemoryReport()
+{
+    MemoryReport report;
+    report.estimated = true;
+
+    spriteBatches.ForEach([&](uint32_t id, GLSpriteBatchData &spriteBatchData) {
+        SpriteBatchMemory memory = CalcSpriteBatchMemory(id, spriteBatchData.maxSprites, spriteBatchData.capacity,
+                                                         spriteBatchData.peakSprites);
+        memory.gpuBufferBytes = spriteBatchData.bufferBytes;
+        memory.textureBytes = spriteBatchData.textureBytes;
+        report.spriteBatches.push_back(memory);
+
+        report.allocatedBytes += spriteBatchData.textureBytes;
+        report.allocationCount++;
+    });
+
+    // The view's color texture and depth renderbuffer, the screen quad and the shared sprite buffers.
+    uint64_t viewPixelCount = static_cast<uint64_t>(viewWidth) * viewHeight;
+    report.allocatedBytes += viewPixelCount * 4 + viewPixelCount * 2;
+    report.allocatedBytes += screenVertices.size() * sizeof(float) + spriteBufferBytes;
+    report.allocationCount += 5;
+    report.reservedBytes = report.allocatedBytes;
+
+#ifndef EMSCRIPTEN
+    // Drivers that expose it report memory in kilobytes, as a single heap of dedicated video memory.
+    if (GLAD_GL_NVX_gpu_memory_info)
+    {
+        GLint dedicatedKb = 0;
+        GLint availableKb = 0;
+        glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &dedicatedKb);
+        glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKb);
+
+        MemoryHeapBudget heap;
+        heap.usageBytes = static_cast<uint64_t>(std::max(dedicatedKb - availableKb, 0)) * 1024;
+        heap.budgetBytes = static_cast<uint64_t>(dedicatedKb) * 1024;
+        report.heaps.push_back(heap);
+        report.budgetsFromDriver = true;
+    }
 #endif
+
+    return report;
+}
+
+FrameTimeHistogram &GLRenderer::GetFrameTimeHistogram(FrameTimeKind kind)
+{
+    return frameTimeHistograms[kind];
+}
+
+void GLRenderer::SetGpuTimingsCsvPath(const std::string &path)
+{
+    if (path.empty())
+    {
+        gpuTimingsCsv.Close();
+        return;
+    }
+
+    gpuTimingsCsv.Open(path);
+}
+
+PresentMode GLRenderer::SetSwapInterval(PresentMode presentMode)
+{
+    switch (presentMode)
+    {
+    case PresentModeImmediate:
+        if (SDL_GL_SetSwapInterval(0) == 0)
+        {
+            return PresentModeImmediate;
+        }
+        break;
+    case PresentModeFifoRelaxed:
+        // Adaptive vsync depends on a swap control tear extension, so it may not be available.
+        if (SDL_GL_SetSwapInterval(-1) == 0)
+        {
+            return PresentModeFifoRelaxed;
+        }
+        break;
+    default:
+        // GL has no way to request mailbox presentation, vsync is the closest mode that never tears.
+        break;
+    }
+
+    SDL_GL_SetSwapInterval(1);
+
+    return PresentModeFifo;
 }
 
-SpriteBatch GLRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
-                                          bool enableBlending)
+SpriteBatch &GLRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
+                                           bool enableBlending)
 {
+    PXLIO_TRACE_ZONE("GLRenderer::CreateSpriteBatch");
+
     SDL_Surface *surface = LoadSurface(texturePath);
 
     auto data = reinterpret_cast<uint8_t *>(surface->pixels);
@@ -355,43 +685,63 @@ SpriteBatch GLRenderer::CreateSpriteBatch(const std::string &texturePath, uint32
 
     SDL_FreeSurface(surface);
 
-    auto spriteBatch = SpriteBatch(textureWidth, textureHeight, maxSprites, enableBlending);
-
-    spriteBatchTextures.insert(std::make_pair(spriteBatch.GetId(), texture));
+    GLSpriteBatchData spriteBatchData;
+    spriteBatchData.texture = texture;
+    spriteBatchData.maxSprites = maxSprites;
+    // Every mip level below the first adds up to a third of its size.
+    spriteBatchData.textureBytes = static_cast<uint64_t>(textureWidth) * textureHeight * 4 * 4 / 3;
 
-    return spriteBatch;
+    return spriteBatches.Create(textureWidth, textureHeight, maxSprites, enableBlending, spriteBatchData);
 }
 
 void GLRenderer::DestroySpriteBatch(SpriteBatch &spriteBatch)
 {
-    if (spriteBatchTextures.find(spriteBatch.GetId()) == spriteBatchTextures.end())
+    GLSpriteBatchData *spriteBatchData = spriteBatches.Get(spriteBatch);
+
+    if (!spriteBatchData)
     {
         return;
     }
 
-    auto &textureId = spriteBatchTextures.at(spriteBatch.GetId()).id;
+    glDeleteTextures(1, &spriteBatchData->texture.id);
 
-    glDeleteTextures(1, &textureId);
+    spriteBatches.Destroy(spriteBatch);
+}
 
-    spriteBatchTextures.erase(spriteBatch.GetId());
+SpriteBatch *GLRenderer::GetSpriteBatch(uint32_t id)
+{
+    return spriteBatches.GetSpriteBatch(id);
 }
 
 void GLRenderer::DrawSpriteBatch(SpriteBatch &spriteBatch)
 {
-    if (spriteBatchTextures.find(spriteBatch.GetId()) == spriteBatchTextures.end())
+    PXLIO_TRACE_ZONE("GLRenderer::DrawSpriteBatch");
+
+    GLSpriteBatchData *spriteBatchData = spriteBatches.Get(spriteBatch);
+
+    if (!spriteBatchData)
     {
         return;
     }
 
-    auto &textureId = spriteBatchTextures.at(spriteBatch.GetId()).id;
+    auto &textureId = spriteBatchData->texture.id;
+
+    gpuTimer.BeginSpriteBatch(spriteBatch.GetId());
+
+    uint64_t vertexBytes = spriteBatch.GetSpriteCount() * vertexValuesPerSprite * sizeof(float);
+    uint64_t indexBytes = spriteBatch.GetSpriteCount() * indicesPerSprite * sizeof(uint32_t);
 
     glBindBuffer(GL_ARRAY_BUFFER, spriteModel.vbo);
-    glBufferData(GL_ARRAY_BUFFER, spriteBatch.GetSpriteCount() * vertexValuesPerSprite * sizeof(float),
-                 &spriteBatch.GetVertices()[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, spriteBatch.GetVertices().data(), GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, spriteModel.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, spriteBatch.GetSpriteCount() * indicesPerSprite * sizeof(uint32_t),
-                 &spriteBatch.GetIndices()[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, spriteBatch.GetIndices().data(), GL_STATIC_DRAW);
+
+    spriteBatchData->capacity = spriteBatch.GetCapacity();
+    spriteBatchData->peakSprites = std::max(spriteBatchData->peakSprites,
+                                            spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount());
+    spriteBatchData->bufferBytes = vertexBytes + indexBytes;
+    spriteBufferBytes = vertexBytes + indexBytes;
 
     glUseProgram(shaderProgram);
     glBindTexture(GL_TEXTURE_2D, textureId);
@@ -404,9 +754,21 @@ void GLRenderer::DrawSpriteBatch(SpriteBatch &spriteBatch)
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
 
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(spriteBatch.GetIndices().size()), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(spriteBatch.GetSpriteCount() * indicesPerSprite), GL_UNSIGNED_INT,
+                   0);
+
+    // Both buffers are respecified with glBufferData, which allocates new storage for them.
+    currentFrameStats.spritesSubmitted += spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.spritesCulled += spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.drawCalls++;
+    currentFrameStats.pipelineBinds++;
+    currentFrameStats.textureBinds++;
+    currentFrameStats.buffersAllocated += 2;
+    currentFrameStats.bytesUploaded += vertexBytes + indexBytes;
 
     glDisable(GL_BLEND);
+
+    gpuTimer.EndSpriteBatch();
 }
 
 void GLRenderer::CheckShaderCompileError(uint32_t shader)
@@ -419,7 +781,7 @@ void GLRenderer::CheckShaderCompileError(uint32_t shader)
     {
         char infoLog[maxShaderErrorLen];
         glGetShaderInfoLog(shader, maxShaderErrorLen, nullptr, infoLog);
-        RUNTIME_ERROR(infoLog);
+        INIT_ERROR(infoLog);
     }
 }
 
@@ -433,6 +795,6 @@ void GLRenderer::CheckShaderLinkError(uint32_t program)
     {
         char infoLog[maxShaderErrorLen];
         glGetProgramInfoLog(program, maxShaderErrorLen, nullptr, infoLog);
-        RUNTIME_ERROR(infoLog);
+        INIT_ERROR(infoLog);
     }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
+#include <chrono>
+#include <vector>
 
 #ifdef EMSCRIPTEN
 #include <GLES3/gl3.h>
@@ -10,8 +12,11 @@
 #include <glad/glad.h>
 #endif
 
+#include "../FramePacer.hpp"
 #include "../ImageLoader.hpp"
 #include "../Renderer.hpp"
+#include "../SpriteBatchPool.hpp"
+#include "GLGpuTimer.hpp"
 
 struct GLModel
 {
@@ -26,31 +31,62 @@ struct GLTexture
     uint32_t id;
 };
 
+struct GLSpriteBatchData
+{
+    GLTexture texture;
+    uint32_t maxSprites = 0;
+    // The batch's capacity as of its last draw.
+    uint32_t capacity = 0;
+    uint32_t peakSprites = 0;
+    // GL can't report allocation sizes, so these are estimated from the sizes that were requested.
+    uint64_t textureBytes = 0;
+    // Batches share their buffers, this is what the batch's last draw uploaded into them.
+    uint64_t bufferBytes = 0;
+};
+
 class GLRenderer : public Renderer
 {
   public:
     GLRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
-               int32_t viewHeight, bool enableVsync = true);
+               int32_t viewHeight, const PresentConfig &presentConfig = PresentConfig());
 
     ~GLRenderer() override;
     void ResizeWindow(int32_t windowWidth, int32_t windowHeight) override;
     SDL_Window *GetWindowPtr() override;
+    RendererBackend GetBackend() override;
 
     void SetBackgroundColor(float r, float g, float b) override;
     void SetScreenBackgroundColor(float r, float g, float b) override;
     void BeginDrawing() override;
     void EndDrawing() override;
 
-    SpriteBatch CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
-                                  bool enableBlending = false) override;
+    PresentStatus GetPresentStatus() override;
+    const FrameStats &GetFrameStats() override;
+    const GpuTimings &GetGpuTimings() override;
+    void SetGpuTimingsCsvPath(const std::string &path) override;
+    MemoryReport GetMemoryReport() override;
+    FrameTimeHistogram &GetFrameTimeHistogram(FrameTimeKind kind) override;
+
+    SpriteBatch &CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
+                                   bool enableBlending = false) override;
     void DrawSpriteBatch(SpriteBatch &spriteBatch) override;
     void DestroySpriteBatch(SpriteBatch &spriteBatch) override;
+    SpriteBatch *GetSpriteBatch(uint32_t id) override;
+
+    // Checks that a GL library can be loaded, the version it supports is only known once a context is created.
+    static bool IsAvailable();
 
   private:
+    void InitContext(const std::string &windowName);
+    void InitShaders();
+    // Releases what was created before an init error, since the destructor doesn't run when the constructor throws.
+    void CleanupFailedInit();
     void CheckShaderLinkError(uint32_t program);
     void CheckShaderCompileError(uint32_t shader);
+    PresentMode SetSwapInterval(PresentMode presentMode);
 
     SDL_Window *window = nullptr;
+    SDL_GLContext context = nullptr;
     int32_t windowWidth = 0;
     int32_t windowHeight = 0;
     int32_t viewWidth = 0;
@@ -81,6 +117,34 @@ class GLRenderer : public Renderer
     float screenBackgroundG = 0.0f;
     float screenBackgroundB = 0.0f;
 
+    ViewTransform viewTransform;
+    CompositeMode compositeMode = CompositeModeShader;
+
+    PresentConfig presentConfig;
+    PresentMode presentMode = PresentModeFifo;
+    FramePacer framePacer;
+    std::chrono::steady_clock::time_point frameStartTime;
+    float latencyMs = 0.0f;
+    uint32_t currentFrame = 0;
+
+#ifndef EMSCRIPTEN
+    // Limits how far the CPU can get ahead of the GPU, drivers otherwise queue as many frames as they like.
+    std::vector<GLsync> frameFences;
+    std::vector<std::chrono::steady_clock::time_point> frameFenceStartTimes;
+#endif
+
+    FrameStats frameStats;
+    FrameStats currentFrameStats;
+
+    GLGpuTimer gpuTimer;
+    GpuTimings gpuTimings;
+    GpuTimingsCsv gpuTimingsCsv;
+
+    std::array<FrameTimeHistogram, frameTimeKindCount> frameTimeHistograms;
+    std::chrono::steady_clock::time_point lastPresentTime;
+
     GLModel spriteModel;
-    std::unordered_map<uint32_t, GLTexture> spriteBatchTextures;
+    SpriteBatchPool<GLSpriteBatchData> spriteBatches;
+    // Size of the shared sprite buffers after the last batch was drawn.
+    uint64_t spriteBufferBytes = 0;
 };
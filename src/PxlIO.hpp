@@ -1,23 +1,186 @@
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
+#include <vector>
 
+#include "Null/NullRenderer.hpp"
 #include "OpenGL/GLRenderer.hpp"
+#include "Software/SoftwareRenderer.hpp"
 
 #ifndef EMSCRIPTEN
 #include "Vulkan/VKRenderer.hpp"
 #endif
 
+// Set to vulkan, opengl, software or null to try that backend first whenever the default backend is created, so
+// that backends can be compared on the same build of a game.
+const char *const backendEnvironmentVariable = "PXLIO_BACKEND";
+
 class PxlIO
 {
   public:
+    // The default backend falls back through GetDefaultBackends until one of them initializes, any other backend is
+    // created as requested and exits if it can't be.
+    static std::unique_ptr<Renderer> Create(RendererBackend backend, const std::string &windowName,
+                                            int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
+                                            int32_t viewHeight, const PresentConfig &presentConfig)
+    {
+        std::vector<RendererBackend> backends = {backend};
+
+        if (backend == RendererBackendDefault)
+        {
+            backends = GetDefaultBackends();
+        }
+
+        return Create(backends, windowName, windowWidth, windowHeight, viewWidth, viewHeight, presentConfig);
+    }
+
+    // Tries each backend in order, skipping the ones that aren't available and falling back to the next one when a
+    // backend fails to initialize. Exits if none of them work.
+    static std::unique_ptr<Renderer> Create(const std::vector<RendererBackend> &backends,
+                                            const std::string &windowName, int32_t windowWidth, int32_t windowHeight,
+                                            int32_t viewWidth, int32_t viewHeight, const PresentConfig &presentConfig)
+    {
+        for (RendererBackend backend : backends)
+        {
+            if (!IsBackendAvailable(backend))
+            {
+                std::cout << "The " << GetBackendName(backend) << " backend isn't available\n";
+                continue;
+            }
+
+            try
+            {
+                return CreateBackend(backend, windowName, windowWidth, windowHeight, viewWidth, viewHeight,
+                                     presentConfig);
+            }
+            catch (const RendererInitError &error)
+            {
+                std::cout << error.what() << "\nThe " << GetBackendName(backend) << " backend failed to initialize\n";
+            }
+        }
+
+        RUNTIME_ERROR("None of the renderer backends could be initialized!");
+    }
+
     static std::unique_ptr<Renderer> Create(const std::string &windowName, int32_t windowWidth, int32_t windowHeight,
-                                            int32_t viewWidth, int32_t viewHeight, bool enableVsync = true)
+                                            int32_t viewWidth, int32_t viewHeight, const PresentConfig &presentConfig)
+    {
+        return Create(RendererBackendDefault, windowName, windowWidth, windowHeight, viewWidth, viewHeight,
+                      presentConfig);
+    }
+
+    static std::unique_ptr<Renderer> Create(const std::string &windowName, int32_t windowWidth, int32_t windowHeight,
+                                            int32_t viewWidth, int32_t viewHeight, bool enableVsync = true,
+                                            uint32_t maxFramesInFlight = 2)
+    {
+        PresentConfig presentConfig;
+        presentConfig.presentMode = enableVsync ? PresentModeFifo : PresentModeImmediate;
+        presentConfig.maxFramesInFlight = maxFramesInFlight;
+
+        return Create(windowName, windowWidth, windowHeight, viewWidth, viewHeight, presentConfig);
+    }
+
+    // Fastest first, ending with the software backend so that any machine that can open a window can draw. The null
+    // backend is never picked by default since it draws nothing. A backend named by PXLIO_BACKEND is moved first.
+    static std::vector<RendererBackend> GetDefaultBackends()
     {
 #ifdef EMSCRIPTEN
-        return std::unique_ptr<Renderer>(
-            new GLRenderer(windowName, windowWidth, windowHeight, viewWidth, viewHeight, enableVsync));
+        std::vector<RendererBackend> backends = {RendererBackendOpenGL, RendererBackendSoftware};
 #else
-        return std::unique_ptr<Renderer>(
-            new VKRenderer(windowName, windowWidth, windowHeight, viewWidth, viewHeight, enableVsync));
+        std::vector<RendererBackend> backends = {RendererBackendVulkan, RendererBackendOpenGL, RendererBackendSoftware};
+#endif
+
+        const char *backendOverride = std::getenv(backendEnvironmentVariable);
+        RendererBackend overrideBackend;
+
+        if (!backendOverride || !ParseBackend(backendOverride, overrideBackend) ||
+            overrideBackend == RendererBackendDefault)
+        {
+            return backends;
+        }
+
+        backends.erase(std::remove(backends.begin(), backends.end(), overrideBackend), backends.end());
+        backends.insert(backends.begin(), overrideBackend);
+
+        return backends;
+    }
+
+    // A quick check that doesn't create a window, passing it doesn't guarantee that the backend will initialize.
+    static bool IsBackendAvailable(RendererBackend backend)
+    {
+        switch (backend)
+        {
+        case RendererBackendVulkan:
+#ifdef EMSCRIPTEN
+            return false;
+#else
+            return VKRenderer::IsAvailable();
+#endif
+        case RendererBackendOpenGL:
+            return GLRenderer::IsAvailable();
+        case RendererBackendSoftware:
+        case RendererBackendNull:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Accepts the names that GetBackendName returns, returns false and leaves backend unchanged for anything else.
+    static bool ParseBackend(const std::string &name, RendererBackend &backend)
+    {
+        for (int32_t i = RendererBackendDefault; i <= RendererBackendNull; i++)
+        {
+            if (name == GetBackendName(static_cast<RendererBackend>(i)))
+            {
+                backend = static_cast<RendererBackend>(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static const char *GetBackendName(RendererBackend backend)
+    {
+        switch (backend)
+        {
+        case RendererBackendVulkan:
+            return "vulkan";
+        case RendererBackendOpenGL:
+            return "opengl";
+        case RendererBackendSoftware:
+            return "software";
+        case RendererBackendNull:
+            return "null";
+        default:
+            return "default";
+        }
+    }
+
+  private:
+    static std::unique_ptr<Renderer> CreateBackend(RendererBackend backend, const std::string &windowName,
+                                                   int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
+                                                   int32_t viewHeight, const PresentConfig &presentConfig)
+    {
+        switch (backend)
+        {
+#ifndef EMSCRIPTEN
+        case RendererBackendVulkan:
+            return std::unique_ptr<Renderer>(
+                new VKRenderer(windowName, windowWidth, windowHeight, viewWidth, viewHeight, presentConfig));
 #endif
+        case RendererBackendOpenGL:
+            return std::unique_ptr<Renderer>(
+                new GLRenderer(windowName, windowWidth, windowHeight, viewWidth, viewHeight, presentConfig));
+        case RendererBackendSoftware:
+            return std::unique_ptr<Renderer>(
+                new SoftwareRenderer(windowName, windowWidth, windowHeight, viewWidth, viewHeight, presentConfig));
+        case RendererBackendNull:
+            return std::unique_ptr<Renderer>(
+                new NullRenderer(windowName, windowWidth, windowHeight, viewWidth, viewHeight, presentConfig));
+        default:
+            INIT_ERROR("The " << GetBackendName(backend) << " backend isn't supported on this platform!");
+        }
     }
-};
\ No newline at end of file
+};
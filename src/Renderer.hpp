@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cinttypes>
 #include <iostream>
 #include <string>
@@ -12,7 +13,10 @@
 #include <glm/glm.hpp>
 
 #include "Error.hpp"
+#include "FrameTimeHistogram.hpp"
+#include "GpuTimings.hpp"
 #include "SpriteBatch.hpp"
+#include "Trace.hpp"
 
 const float zMax = 1000.0f;
 
@@ -24,6 +28,143 @@ struct ViewTransform
     float offsetY;
 };
 
+// How the finished view is copied onto the window.
+enum CompositeMode
+{
+    // The view is drawn straight into the window, used when it isn't scaled.
+    CompositeModeDirect,
+    // The view is copied with nearest filtering, used when it is scaled by a whole number.
+    CompositeModeBlit,
+    // The view is drawn onto the window as a textured quad, needed for any other scale.
+    CompositeModeShader,
+};
+
+// How finished frames are handed to the display, modes the backend doesn't support fall back to the closest one
+// that it does.
+enum PresentMode
+{
+    // Waits for vertical blank, never tears. Always supported.
+    PresentModeFifo,
+    // Waits for vertical blank unless the frame is late, in which case it is shown immediately and may tear.
+    // Falls back to PresentModeFifo.
+    PresentModeFifoRelaxed,
+    // Replaces the queued frame with newer ones instead of blocking, never tears. Falls back to PresentModeFifo.
+    PresentModeMailbox,
+    // Shows frames as soon as they are ready, may tear. Falls back to PresentModeMailbox, then PresentModeFifo.
+    PresentModeImmediate,
+};
+
+struct PresentConfig
+{
+    PresentMode presentMode = PresentModeFifo;
+    // Number of swapchain images to request, clamped to what the surface allows. Zero requests one more than the
+    // minimum. Ignored by backends that don't expose their swapchain.
+    uint32_t imageCount = 0;
+    // Number of frames the CPU may record ahead of the GPU, more frames in flight improve throughput at the cost
+    // of latency.
+    uint32_t maxFramesInFlight = 2;
+    // Limits the frame rate by sleeping at the end of each frame, zero leaves it uncapped.
+    uint32_t targetFps = 0;
+};
+
+struct PresentStatus
+{
+    // The mode and image count that were actually selected after falling back, an image count of zero means that
+    // it is managed by the driver.
+    PresentMode presentMode;
+    uint32_t imageCount;
+    uint32_t maxFramesInFlight;
+    uint32_t targetFps;
+    // Smoothed time between a frame beginning on the CPU and its rendering being seen as complete, zero if the
+    // backend can't measure it.
+    float latencyMs;
+};
+
+// Counters for everything recorded between BeginDrawing and EndDrawing.
+struct FrameStats
+{
+    uint32_t spritesSubmitted = 0;
+    // Sprites that were submitted but not drawn, batches don't cull so these are the sprites that didn't fit.
+    uint32_t spritesCulled = 0;
+    uint32_t drawCalls = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t textureBinds = 0;
+    uint64_t bytesUploaded = 0;
+    uint32_t buffersAllocated = 0;
+    float fenceWaitMs = 0.0f;
+    // Zero for backends that don't acquire images explicitly.
+    float acquireMs = 0.0f;
+    float presentMs = 0.0f;
+    // Heap allocations made on the calling thread from BeginDrawing to EndDrawing, including the ones made while
+    // filling sprite batches. Always zero unless building with PXLIO_TRACK_ALLOCATIONS, debug builds also attribute
+    // them to trace zones in AllocationTracker::GetLastReport.
+    uint32_t heapAllocations = 0;
+    uint64_t heapAllocatedBytes = 0;
+};
+
+struct SpriteBatchMemory
+{
+    uint32_t spriteBatchId = 0;
+    uint32_t maxSprites = 0;
+    // Sprites the batch had room for when it was last drawn, it grows towards maxSprites as it's filled.
+    uint32_t capacity = 0;
+    // The most sprites drawn from the batch at once, including any that didn't fit, compare it with maxSprites to
+    // right size the batch.
+    uint32_t peakSprites = 0;
+    uint64_t cpuVertexBytes = 0;
+    uint64_t cpuIndexBytes = 0;
+    // Vertex, index and instance buffers, with a copy of the streaming buffers for every frame in flight.
+    uint64_t gpuBufferBytes = 0;
+    uint64_t textureBytes = 0;
+};
+
+struct MemoryHeapBudget
+{
+    // Usage covers every process using the device when the driver reports budgets, otherwise only this one.
+    uint64_t usageBytes = 0;
+    uint64_t budgetBytes = 0;
+};
+
+struct MemoryReport
+{
+    std::vector<SpriteBatchMemory> spriteBatches;
+    // Bytes used by allocations and bytes reserved from the driver to hold them, for every resource including the
+    // ones that don't belong to a sprite batch.
+    uint64_t allocatedBytes = 0;
+    uint64_t reservedBytes = 0;
+    uint32_t allocationCount = 0;
+    // True when the totals are estimated from the sizes that were requested, because the backend can't query them.
+    bool estimated = false;
+    // Budgets are estimates unless they come from the driver, heaps is empty if the backend can't query them at all.
+    bool budgetsFromDriver = false;
+    std::vector<MemoryHeapBudget> heaps;
+};
+
+enum FrameTimeKind
+{
+    // Time the CPU spent on the frame between BeginDrawing and EndDrawing, not counting time blocked on the fence,
+    // acquiring or presenting.
+    FrameTimeKindCpu,
+    // The view and composite passes, recorded once the GPU has finished the frame. Empty without timer queries.
+    FrameTimeKindGpu,
+    // Time between consecutive presents, which is what players see as stutter.
+    FrameTimeKindPresent,
+};
+
+const uint32_t frameTimeKindCount = 3;
+
+enum RendererBackend
+{
+    // The first backend that initializes, see PxlIO::Create.
+    RendererBackendDefault,
+    RendererBackendVulkan,
+    RendererBackendOpenGL,
+    // Rasterizes on the CPU, for machines with broken GPU drivers and as a reference for the other backends.
+    RendererBackendSoftware,
+    // Draws nothing and needs no GPU, for servers and CI machines.
+    RendererBackendNull,
+};
+
 class Renderer
 {
   public:
@@ -31,16 +172,31 @@ class Renderer
 
     virtual void ResizeWindow(int32_t windowWidth, int32_t windowHeight) = 0;
     virtual SDL_Window *GetWindowPtr() = 0;
+    // The backend that was actually created, never RendererBackendDefault.
+    virtual RendererBackend GetBackend() = 0;
 
     virtual void SetBackgroundColor(float r, float g, float b) = 0;
     virtual void SetScreenBackgroundColor(float r, float g, float b) = 0;
     virtual void BeginDrawing() = 0;
     virtual void EndDrawing() = 0;
 
-    virtual SpriteBatch CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
-                                          bool enableBlending = false) = 0;
+    virtual PresentStatus GetPresentStatus() = 0;
+    // Stats for the last frame that EndDrawing was called for.
+    virtual const FrameStats &GetFrameStats() = 0;
+    // Timings of the most recent frame that the GPU has finished, they lag a few frames behind.
+    virtual const GpuTimings &GetGpuTimings() = 0;
+    // Appends the GPU timings of every frame to a CSV file, an empty path stops writing them.
+    virtual void SetGpuTimingsCsvPath(const std::string &path) = 0;
+    virtual MemoryReport GetMemoryReport() = 0;
+    // Rolling window of recent frame times, these can also be reset or drawn as a graph.
+    virtual FrameTimeHistogram &GetFrameTimeHistogram(FrameTimeKind kind) = 0;
+
+    virtual SpriteBatch &CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
+                                           bool enableBlending = false) = 0;
     virtual void DrawSpriteBatch(SpriteBatch &spriteBatch) = 0;
     virtual void DestroySpriteBatch(SpriteBatch &spriteBatch) = 0;
+    // Finds a batch by its id, returns null if the batch has been destroyed.
+    virtual SpriteBatch *GetSpriteBatch(uint32_t id) = 0;
 
     static ViewTransform CalcViewTransform(int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
                                            int32_t viewHeight)
@@ -71,4 +227,52 @@ class Renderer
             offsetY,
         };
     }
+
+    static CompositeMode CalcCompositeMode(const ViewTransform &viewTransform, int32_t viewWidth, int32_t viewHeight)
+    {
+        float scale = viewTransform.scaledViewWidth / static_cast<float>(viewWidth);
+
+        if (scale < 1.0f || glm::floor(scale) != scale)
+        {
+            return CompositeModeShader;
+        }
+
+        if (scale == 1.0f)
+        {
+            return CompositeModeDirect;
+        }
+
+        return CompositeModeBlit;
+    }
+
+    // The memory a batch allocates on the CPU regardless of backend.
+    static SpriteBatchMemory CalcSpriteBatchMemory(uint32_t spriteBatchId, uint32_t maxSprites, uint32_t capacity,
+                                                   uint32_t peakSprites)
+    {
+        SpriteBatchMemory memory;
+        memory.spriteBatchId = spriteBatchId;
+        memory.maxSprites = maxSprites;
+        memory.capacity = capacity;
+        memory.peakSprites = peakSprites;
+        memory.cpuVertexBytes = static_cast<uint64_t>(capacity) * vertexValuesPerSprite * sizeof(float);
+        memory.cpuIndexBytes = static_cast<uint64_t>(capacity) * indicesPerSprite * sizeof(uint32_t);
+
+        return memory;
+    }
+
+    static float CalcElapsedMs(std::chrono::steady_clock::time_point startTime)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    // Exponential moving average, so reported latency is stable enough to compare between present modes.
+    static float SmoothLatency(float latencyMs, float sampleMs)
+    {
+        if (latencyMs == 0.0f)
+        {
+            return sampleMs;
+        }
+
+        return latencyMs + (sampleMs - latencyMs) * 0.1f;
+    }
 };
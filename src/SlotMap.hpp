@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cinttypes>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Error.hpp"
+
+// The low bits of a handle are its slot's index, the rest are the slot's generation, which changes whenever the slot
+// is reused, so handles to removed values are recognized as stale instead of finding whatever replaced them. Slots
+// are retired instead of letting their generation wrap, so a stale handle can never match again.
+const uint32_t slotMapIndexBits = 16;
+const uint32_t slotMapIndexMask = (1u << slotMapIndexBits) - 1;
+// Kept to 31 bits overall, so handles survive being passed to Haxe as a signed Int32.
+const uint32_t slotMapGenerationMask = (1u << (31 - slotMapIndexBits)) - 1;
+
+// Stores values behind generational handles, finding one is an array access rather than a hash lookup. Slots live in
+// a deque, which never moves existing elements, so references to a value stay valid until it is removed. Removed
+// values' slots are reused.
+template <typename T> class SlotMap
+{
+  public:
+    uint32_t Insert(T value)
+    {
+        return InsertWith([&](uint32_t) { return std::move(value); });
+    }
+
+    // For values that need to know their own handle, create(handle) returns the value to store.
+    template <typename F> uint32_t InsertWith(F create)
+    {
+        uint32_t index = static_cast<uint32_t>(slots.size());
+
+        if (freeIndices.empty())
+        {
+            if (index > slotMapIndexMask)
+            {
+                RUNTIME_ERROR("Too many values in a slot map!");
+            }
+
+            slots.emplace_back();
+        }
+        else
+        {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+
+        Slot &slot = slots[index];
+        uint32_t handle = index | slot.generation << slotMapIndexBits;
+        slot.value.emplace(create(handle));
+
+        return handle;
+    }
+
+    // Null for handles whose value has been removed, or that were never returned by this map.
+    T *Get(uint32_t handle)
+    {
+        uint32_t index = handle & slotMapIndexMask;
+
+        if (index >= slots.size())
+        {
+            return nullptr;
+        }
+
+        Slot &slot = slots[index];
+
+        if (!slot.value || slot.generation != handle >> slotMapIndexBits)
+        {
+            return nullptr;
+        }
+
+        return &*slot.value;
+    }
+
+    // Every reference to the value is invalid afterwards. Returns false if the handle was already stale.
+    bool Remove(uint32_t handle)
+    {
+        if (!Get(handle))
+        {
+            return false;
+        }
+
+        uint32_t index = handle & slotMapIndexMask;
+        Slot &slot = slots[index];
+        slot.value.reset();
+
+        // The slot's last generation, it's retired rather than reused.
+        if (slot.generation == slotMapGenerationMask)
+        {
+            return true;
+        }
+
+        slot.generation++;
+        freeIndices.push_back(index);
+
+        return true;
+    }
+
+    void Clear()
+    {
+        for (uint32_t index = 0; index < slots.size(); index++)
+        {
+            Remove(index | slots[index].generation << slotMapIndexBits);
+        }
+    }
+
+    // Calls function(handle, value) for every value that hasn't been removed.
+    template <typename F> void ForEach(F function)
+    {
+        for (uint32_t index = 0; index < slots.size(); index++)
+        {
+            Slot &slot = slots[index];
+
+            if (slot.value)
+            {
+                function(index | slot.generation << slotMapIndexBits, *slot.value);
+            }
+        }
+    }
+
+  private:
+    struct Slot
+    {
+        std::optional<T> value;
+        uint32_t generation = 0;
+    };
+
+    std::deque<Slot> slots;
+    std::vector<uint32_t> freeIndices;
+};
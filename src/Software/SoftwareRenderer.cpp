@@ -0,0 +1,813 @@
+#include "SoftwareRenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RENDERER_SSE2
+#endif
+
+// Channel positions in ARGB8888 pixels.
+const uint32_t redShift = 16;
+const uint32_t greenShift = 8;
+const uint32_t blueShift = 0;
+const uint32_t alphaShift = 24;
+const uint32_t opaqueAlpha = 0xffu << alphaShift;
+
+// Conversions to and from normalized floats that round the same way as the GPU does for 8 bit color attachments.
+static inline float UnpackChannel(uint32_t color, uint32_t shift)
+{
+    return static_cast<float>((color >> shift) & 0xff) / 255.0f;
+}
+
+static inline uint32_t PackChannel(float value, uint32_t shift)
+{
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint32_t>(value * 255.0f + 0.5f) << shift;
+}
+
+static inline uint32_t PackColor(float r, float g, float b)
+{
+    return opaqueAlpha | PackChannel(r, redShift) | PackChannel(g, greenShift) | PackChannel(b, blueShift);
+}
+
+// Texture coordinates repeat, the same as the samplers on the GPU backends.
+static inline int32_t WrapTexel(int32_t texel, int32_t size)
+{
+    texel %= size;
+    return texel < 0 ? texel + size : texel;
+}
+
+static inline uint32_t SampleNearest(const SoftwareTexture &texture, float u, float v)
+{
+    int32_t x = WrapTexel(static_cast<int32_t>(std::floor(u * texture.width)), texture.width);
+    int32_t y = WrapTexel(static_cast<int32_t>(std::floor(v * texture.height)), texture.height);
+
+    return texture.pixels[y * texture.width + x];
+}
+
+// Smooth textures are filtered bilinearly from their full size image. The GPU backends also use mipmaps, so heavily
+// minified sprites will look sharper here.
+static inline void SampleLinear(const SoftwareTexture &texture, float u, float v, float *rgba)
+{
+    float x = u * texture.width - 0.5f;
+    float y = v * texture.height - 0.5f;
+    float floorX = std::floor(x);
+    float floorY = std::floor(y);
+    float fractX = x - floorX;
+    float fractY = y - floorY;
+
+    int32_t x0 = WrapTexel(static_cast<int32_t>(floorX), texture.width);
+    int32_t x1 = WrapTexel(x0 + 1, texture.width);
+    int32_t y0 = WrapTexel(static_cast<int32_t>(floorY), texture.height);
+    int32_t y1 = WrapTexel(y0 + 1, texture.height);
+
+    uint32_t texel00 = texture.pixels[y0 * texture.width + x0];
+    uint32_t texel10 = texture.pixels[y0 * texture.width + x1];
+    uint32_t texel01 = texture.pixels[y1 * texture.width + x0];
+    uint32_t texel11 = texture.pixels[y1 * texture.width + x1];
+
+    const uint32_t shifts[4] = {redShift, greenShift, blueShift, alphaShift};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        float top = UnpackChannel(texel00, shifts[i]) * (1.0f - fractX) + UnpackChannel(texel10, shifts[i]) * fractX;
+        float bottom =
+            UnpackChannel(texel01, shifts[i]) * (1.0f - fractX) + UnpackChannel(texel11, shifts[i]) * fractX;
+        rgba[i] = top * (1.0f - fractY) + bottom * fractY;
+    }
+}
+
+// Narrows [minX, maxX] to where 0 <= value < 1 along a row, returns false if that leaves nothing.
+static inline bool ClipSpan(float dx, float rowValue, float &minX, float &maxX)
+{
+    if (dx == 0.0f)
+    {
+        return rowValue >= 0.0f && rowValue < 1.0f;
+    }
+
+    float start = -rowValue / dx;
+    float end = (1.0f - rowValue) / dx;
+    minX = std::max(minX, std::min(start, end));
+    maxX = std::min(maxX, std::max(start, end));
+
+    return minX <= maxX;
+}
+
+static uint32_t CalcWorkerCount()
+{
+#ifdef EMSCRIPTEN
+    // The web build doesn't enable pthreads, so every tile is rasterized on the calling thread.
+    return 0;
+#else
+    uint32_t threadCount = std::thread::hardware_concurrency();
+    return threadCount > 1 ? threadCount - 1 : 0;
+#endif
+}
+
+SoftwareRenderer::SoftwareRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight,
+                                   int32_t viewWidth, int32_t viewHeight, const PresentConfig &presentConfig)
+    : windowWidth(windowWidth), windowHeight(windowHeight), viewWidth(viewWidth), viewHeight(viewHeight),
+      threadPool(CalcWorkerCount()), presentConfig(presentConfig)
+{
+    if (presentConfig.maxFramesInFlight < 1)
+    {
+        RUNTIME_ERROR("At least one frame must be allowed in flight!");
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
+    {
+        SDL_Quit();
+        INIT_ERROR("Failed to initialize SDL!");
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        SDL_Quit();
+        INIT_ERROR("Failed to initialize SDL Image!");
+    }
+
+    // Neither SDL_WINDOW_OPENGL nor SDL_WINDOW_VULKAN, the window is only ever presented through its surface.
+    window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth,
+                              windowHeight, SDL_WINDOW_RESIZABLE);
+
+    if (!window)
+    {
+        SDL_Quit();
+        INIT_ERROR("Failed to create a window!");
+    }
+
+    framePacer.SetTargetFps(presentConfig.targetFps);
+
+    rowStride = (viewWidth + 3) & ~3;
+    tileCountX = (viewWidth + softwareTileSize - 1) / softwareTileSize;
+    tileCountY = (viewHeight + softwareTileSize - 1) / softwareTileSize;
+    tileQuads.resize(tileCountX * tileCountY);
+
+    colorBuffer.resize(static_cast<size_t>(rowStride) * viewHeight);
+    depthBuffer.resize(static_cast<size_t>(rowStride) * viewHeight);
+
+    viewSurface = SDL_CreateRGBSurfaceWithFormatFrom(colorBuffer.data(), viewWidth, viewHeight, 32,
+                                                     rowStride * sizeof(uint32_t), SDL_PIXELFORMAT_ARGB8888);
+
+    if (!viewSurface)
+    {
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        INIT_ERROR("Failed to create the view's surface!");
+    }
+
+    backgroundColor = PackColor(0.0f, 0.0f, 0.0f);
+    screenBackgroundColor = PackColor(0.0f, 0.0f, 0.0f);
+
+    ResizeWindow(windowWidth, windowHeight);
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+    SDL_FreeSurface(viewSurface);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+void SoftwareRenderer::ResizeWindow(int32_t windowWidth, int32_t windowHeight)
+{
+    this->windowWidth = windowWidth;
+    this->windowHeight = windowHeight;
+
+    viewTransform = Renderer::CalcViewTransform(windowWidth, windowHeight, viewWidth, viewHeight);
+    compositeMode = Renderer::CalcCompositeMode(viewTransform, viewWidth, viewHeight);
+}
+
+SDL_Window *SoftwareRenderer::GetWindowPtr()
+{
+    return window;
+}
+
+RendererBackend SoftwareRenderer::GetBackend()
+{
+    return RendererBackendSoftware;
+}
+
+void SoftwareRenderer::SetBackgroundColor(float r, float g, float b)
+{
+    backgroundColor = PackColor(r, g, b);
+}
+
+void SoftwareRenderer::SetScreenBackgroundColor(float r, float g, float b)
+{
+    screenBackgroundColor = PackColor(r, g, b);
+}
+
+void SoftwareRenderer::BeginDrawing()
+{
+    AllocationTracker::Begin();
+
+    PXLIO_TRACE_ZONE("SoftwareRenderer::BeginDrawing");
+
+    frameStartTime = std::chrono::steady_clock::now();
+    currentFrameStats = FrameStats{};
+
+    draws.clear();
+    quads.clear();
+
+    for (std::vector<uint32_t> &tile : tileQuads)
+    {
+        tile.clear();
+    }
+}
+
+void SoftwareRenderer::EndDrawing()
+{
+    PXLIO_TRACE_ZONE("SoftwareRenderer::EndDrawing");
+
+    auto viewPassStartTime = std::chrono::steady_clock::now();
+
+    {
+        PXLIO_TRACE_ZONE("SoftwareRenderer::Rasterize");
+        threadPool.Run(static_cast<uint32_t>(tileQuads.size()), [this](uint32_t i) { RasterizeTile(i); });
+    }
+
+    gpuTimings.viewPassMs = CalcElapsedMs(viewPassStartTime);
+
+    // Releases textures that were only kept alive by this frame's draws.
+    draws.clear();
+
+    {
+        PXLIO_TRACE_ZONE("SoftwareRenderer::Present");
+        auto presentStartTime = std::chrono::steady_clock::now();
+        Present();
+        currentFrameStats.presentMs = CalcElapsedMs(presentStartTime);
+    }
+
+    // Compositing happens while presenting, so it is only reported as part of the present.
+    gpuTimings.compositePassMs = 0.0f;
+    gpuTimings.frame = frame;
+    gpuTimings.valid = true;
+    gpuTimingsCsv.Write(gpuTimings);
+    frameTimeHistograms[FrameTimeKindGpu].Add(gpuTimings.viewPassMs + gpuTimings.compositePassMs);
+
+    auto presentTime = std::chrono::steady_clock::now();
+    if (lastPresentTime != std::chrono::steady_clock::time_point())
+    {
+        std::chrono::duration<float, std::milli> presentInterval = presentTime - lastPresentTime;
+        frameTimeHistograms[FrameTimeKindPresent].Add(presentInterval.count());
+    }
+    lastPresentTime = presentTime;
+
+    // The frame is on screen as soon as it has been presented, there is nothing left in flight.
+    latencyMs = SmoothLatency(latencyMs, CalcElapsedMs(frameStartTime));
+
+    frameTimeHistograms[FrameTimeKindCpu].Add(CalcElapsedMs(frameStartTime) - currentFrameStats.presentMs);
+
+    ++frame;
+
+    AllocationTracker::End();
+    const AllocationReport &allocationReport = AllocationTracker::GetLastReport();
+    currentFrameStats.heapAllocations = static_cast<uint32_t>(allocationReport.count);
+    currentFrameStats.heapAllocatedBytes = allocationReport.byteSize;
+
+    frameStats = currentFrameStats;
+
+    framePacer.Wait();
+
+    Trace::NextFrame();
+}
+
+void SoftwareRenderer::Present()
+{
+    // The window's surface is recreated by SDL after the window is resized, so it is fetched every frame.
+    SDL_Surface *windowSurface = SDL_GetWindowSurface(window);
+
+    if (!windowSurface)
+    {
+        return;
+    }
+
+    SDL_FillRect(windowSurface, nullptr,
+                 SDL_MapRGB(windowSurface->format, (screenBackgroundColor >> redShift) & 0xff,
+                            (screenBackgroundColor >> greenShift) & 0xff, (screenBackgroundColor >> blueShift) & 0xff));
+
+    // Blits clip the destination rectangle in place, so it is rebuilt every frame.
+    SDL_Rect destination = {
+        static_cast<int32_t>(viewTransform.offsetX),
+        static_cast<int32_t>(viewTransform.offsetY),
+        static_cast<int32_t>(viewTransform.scaledViewWidth),
+        static_cast<int32_t>(viewTransform.scaledViewHeight),
+    };
+
+    // Scaled blits sample the nearest pixel, the same as the GPU backends' composite passes.
+    if (compositeMode == CompositeModeDirect)
+    {
+        SDL_BlitSurface(viewSurface, nullptr, windowSurface, &destination);
+    }
+    else
+    {
+        SDL_BlitScaled(viewSurface, nullptr, windowSurface, &destination);
+    }
+
+    SDL_UpdateWindowSurface(window);
+}
+
+PresentStatus SoftwareRenderer::GetPresentStatus()
+{
+    // Window surfaces are copied to the screen without waiting for vertical blank.
+    return PresentStatus{
+        PresentModeImmediate,
+        0,
+        presentConfig.maxFramesInFlight,
+        presentConfig.targetFps,
+        latencyMs,
+    };
+}
+
+const FrameStats &SoftwareRenderer::GetFrameStats()
+{
+    return frameStats;
+}
+
+const GpuTimings &SoftwareRenderer::GetGpuTimings()
+{
+    return gpuTimings;
+}
+
+void SoftwareRenderer::SetGpuTimingsCsvPath(const std::string &path)
+{
+    if (path.empty())
+    {
+        gpuTimingsCsv.Close();
+        return;
+    }
+
+    gpuTimingsCsv.Open(path);
+}
+
+MemoryReport SoftwareRenderer::GetMemoryReport()
+{
+    // Everything lives in CPU memory, so the sizes are exact but there are no heaps to report.
+    MemoryReport report;
+
+    spriteBatches.ForEach([&](uint32_t id, SoftwareSpriteBatchData &spriteBatchData) {
+        SpriteBatchMemory memory = CalcSpriteBatchMemory(id, spriteBatchData.maxSprites, spriteBatchData.capacity,
+                                                         spriteBatchData.peakSprites);
+        memory.textureBytes = spriteBatchData.texture->pixels.size() * sizeof(uint32_t);
+        report.spriteBatches.push_back(memory);
+
+        report.allocatedBytes += memory.textureBytes;
+        report.reservedBytes += spriteBatchData.texture->pixels.capacity() * sizeof(uint32_t);
+        report.allocationCount++;
+    });
+
+    // The color and depth buffers, and the sprites and tile bins kept between frames.
+    uint64_t frameBytes = colorBuffer.size() * sizeof(uint32_t) + depthBuffer.size() * sizeof(float);
+    uint64_t reservedFrameBytes = frameBytes + quads.capacity() * sizeof(SoftwareQuad);
+    frameBytes += quads.size() * sizeof(SoftwareQuad);
+
+    for (std::vector<uint32_t> &tile : tileQuads)
+    {
+        frameBytes += tile.size() * sizeof(uint32_t);
+        reservedFrameBytes += tile.capacity() * sizeof(uint32_t);
+    }
+
+    report.allocatedBytes += frameBytes;
+    report.reservedBytes += reservedFrameBytes;
+    report.allocationCount += 3 + static_cast<uint32_t>(tileQuads.size());
+
+    return report;
+}
+
+FrameTimeHistogram &SoftwareRenderer::GetFrameTimeHistogram(FrameTimeKind kind)
+{
+    return frameTimeHistograms[kind];
+}
+
+SpriteBatch &SoftwareRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
+                                                 bool enableBlending)
+{
+    PXLIO_TRACE_ZONE("SoftwareRenderer::CreateSpriteBatch");
+
+    SDL_Surface *loadedSurface = LoadSurface(texturePath);
+    SDL_Surface *surface = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loadedSurface);
+
+    if (!surface)
+    {
+        RUNTIME_ERROR("Failed to convert: " << texturePath);
+    }
+
+    auto texture = std::make_shared<SoftwareTexture>();
+    texture->width = surface->w;
+    texture->height = surface->h;
+    texture->smooth = smooth;
+    texture->pixels.resize(static_cast<size_t>(surface->w) * surface->h);
+
+    for (int32_t y = 0; y < surface->h; y++)
+    {
+        const uint8_t *row = reinterpret_cast<const uint8_t *>(surface->pixels) + y * surface->pitch;
+        std::copy_n(reinterpret_cast<const uint32_t *>(row), surface->w, &texture->pixels[y * surface->w]);
+    }
+
+    SDL_FreeSurface(surface);
+
+    SoftwareSpriteBatchData spriteBatchData;
+    spriteBatchData.texture = texture;
+    spriteBatchData.maxSprites = maxSprites;
+
+    return spriteBatches.Create(texture->width, texture->height, maxSprites, enableBlending, spriteBatchData);
+}
+
+void SoftwareRenderer::DestroySpriteBatch(SpriteBatch &spriteBatch)
+{
+    spriteBatches.Destroy(spriteBatch);
+}
+
+SpriteBatch *SoftwareRenderer::GetSpriteBatch(uint32_t id)
+{
+    return spriteBatches.GetSpriteBatch(id);
+}
+
+void SoftwareRenderer::DrawSpriteBatch(SpriteBatch &spriteBatch)
+{
+    PXLIO_TRACE_ZONE("SoftwareRenderer::DrawSpriteBatch");
+
+    SoftwareSpriteBatchData *spriteBatchData = spriteBatches.Get(spriteBatch);
+
+    if (!spriteBatchData)
+    {
+        return;
+    }
+
+    spriteBatchData->capacity = spriteBatch.GetCapacity();
+    spriteBatchData->peakSprites = std::max(spriteBatchData->peakSprites,
+                                            spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount());
+
+    uint32_t drawIndex = static_cast<uint32_t>(draws.size());
+    draws.push_back(SoftwareDraw{spriteBatchData->texture, spriteBatch.GetHasBlending()});
+
+    const std::vector<float> &vertices = spriteBatch.GetVertices();
+
+    for (uint32_t i = 0; i < spriteBatch.GetSpriteCount(); i++)
+    {
+        // The bottom left, bottom right and top left corners, the top right one completes the parallelogram.
+        const float *vertex0 = &vertices[i * vertexValuesPerSprite];
+        const float *vertex1 = vertex0 + valuesPerSpriteVertex;
+        const float *vertex3 = vertex0 + valuesPerSpriteVertex * 3;
+
+        // The projections map depth zMax to the near plane and -zMax to the far plane, which is where the depth
+        // buffer is cleared to, so sprites outside of (-zMax, zMax] could never be seen.
+        float depth = vertex0[2];
+        if (depth <= -zMax || depth > zMax)
+        {
+            continue;
+        }
+
+        float edge1X = vertex1[0] - vertex0[0];
+        float edge1Y = vertex1[1] - vertex0[1];
+        float edge3X = vertex3[0] - vertex0[0];
+        float edge3Y = vertex3[1] - vertex0[1];
+        float determinant = edge1X * edge3Y - edge1Y * edge3X;
+
+        if (determinant == 0.0f)
+        {
+            continue;
+        }
+
+        SoftwareQuad quad;
+        float inverseDeterminant = 1.0f / determinant;
+        quad.s.dx = edge3Y * inverseDeterminant;
+        quad.s.dy = -edge3X * inverseDeterminant;
+        quad.s.c = -(quad.s.dx * vertex0[0] + quad.s.dy * vertex0[1]);
+        quad.t.dx = -edge1Y * inverseDeterminant;
+        quad.t.dy = edge1X * inverseDeterminant;
+        quad.t.c = -(quad.t.dx * vertex0[0] + quad.t.dy * vertex0[1]);
+
+        float deltaU1 = vertex1[3] - vertex0[3];
+        float deltaU3 = vertex3[3] - vertex0[3];
+        quad.u.dx = quad.s.dx * deltaU1 + quad.t.dx * deltaU3;
+        quad.u.dy = quad.s.dy * deltaU1 + quad.t.dy * deltaU3;
+        quad.u.c = vertex0[3] + quad.s.c * deltaU1 + quad.t.c * deltaU3;
+
+        float deltaV1 = vertex1[4] - vertex0[4];
+        float deltaV3 = vertex3[4] - vertex0[4];
+        quad.v.dx = quad.s.dx * deltaV1 + quad.t.dx * deltaV3;
+        quad.v.dy = quad.s.dy * deltaV1 + quad.t.dy * deltaV3;
+        quad.v.c = vertex0[4] + quad.s.c * deltaV1 + quad.t.c * deltaV3;
+
+        quad.depth = depth;
+        quad.r = vertex0[5];
+        quad.g = vertex0[6];
+        quad.b = vertex0[7];
+        quad.a = vertex0[8];
+        quad.tint = vertex0[9];
+
+        float cornerXs[4] = {vertex0[0], vertex1[0], vertex3[0], vertex1[0] + edge3X};
+        float cornerYs[4] = {vertex0[1], vertex1[1], vertex3[1], vertex1[1] + edge3Y};
+        float viewWidthFloat = static_cast<float>(viewWidth);
+        float viewHeightFloat = static_cast<float>(viewHeight);
+        float minX = std::clamp(*std::min_element(cornerXs, cornerXs + 4), 0.0f, viewWidthFloat);
+        float minY = std::clamp(*std::min_element(cornerYs, cornerYs + 4), 0.0f, viewHeightFloat);
+        float maxX = std::clamp(*std::max_element(cornerXs, cornerXs + 4), 0.0f, viewWidthFloat);
+        float maxY = std::clamp(*std::max_element(cornerYs, cornerYs + 4), 0.0f, viewHeightFloat);
+
+        // Pixels are covered when their centers are, see RasterizeSpan.
+        quad.minX = static_cast<int32_t>(std::ceil(minX - 0.5f));
+        quad.minY = static_cast<int32_t>(std::ceil(minY - 0.5f));
+        quad.maxX = static_cast<int32_t>(std::floor(maxX - 0.5f));
+        quad.maxY = static_cast<int32_t>(std::floor(maxY - 0.5f));
+
+        if (quad.minX > quad.maxX || quad.minY > quad.maxY)
+        {
+            continue;
+        }
+
+        quad.drawIndex = drawIndex;
+
+        uint32_t quadIndex = static_cast<uint32_t>(quads.size());
+        quads.push_back(quad);
+
+        for (int32_t tileY = quad.minY / softwareTileSize; tileY <= quad.maxY / softwareTileSize; tileY++)
+        {
+            for (int32_t tileX = quad.minX / softwareTileSize; tileX <= quad.maxX / softwareTileSize; tileX++)
+            {
+                tileQuads[tileY * tileCountX + tileX].push_back(quadIndex);
+            }
+        }
+    }
+
+    currentFrameStats.spritesSubmitted += spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.spritesCulled += spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.drawCalls++;
+    currentFrameStats.pipelineBinds++;
+    currentFrameStats.textureBinds++;
+}
+
+void SoftwareRenderer::RasterizeTile(uint32_t tileIndex)
+{
+    PXLIO_TRACE_ZONE("SoftwareRenderer::RasterizeTile");
+
+    int32_t tileX = static_cast<int32_t>(tileIndex) % tileCountX;
+    int32_t tileY = static_cast<int32_t>(tileIndex) / tileCountX;
+    int32_t tileMinX = tileX * softwareTileSize;
+    int32_t tileMinY = tileY * softwareTileSize;
+    int32_t tileMaxX = std::min(tileMinX + softwareTileSize, viewWidth);
+    int32_t tileMaxY = std::min(tileMinY + softwareTileSize, viewHeight);
+    // The last column of tiles also owns the padding at the end of each row.
+    int32_t clearMaxX = tileX == tileCountX - 1 ? rowStride : tileMaxX;
+
+    for (int32_t y = tileMinY; y < tileMaxY; y++)
+    {
+        size_t rowStart = static_cast<size_t>(viewHeight - 1 - y) * rowStride;
+        std::fill(&colorBuffer[rowStart + tileMinX], &colorBuffer[rowStart + clearMaxX], backgroundColor);
+        std::fill(&depthBuffer[rowStart + tileMinX], &depthBuffer[rowStart + clearMaxX], -zMax);
+    }
+
+    for (uint32_t quadIndex : tileQuads[tileIndex])
+    {
+        RasterizeQuad(quads[quadIndex], tileMinX, tileMinY, tileMaxX, tileMaxY);
+    }
+}
+
+void SoftwareRenderer::RasterizeQuad(const SoftwareQuad &quad, int32_t tileMinX, int32_t tileMinY, int32_t tileMaxX,
+                                     int32_t tileMaxY)
+{
+    const SoftwareDraw &draw = draws[quad.drawIndex];
+    int32_t minX = std::max(quad.minX, tileMinX);
+    int32_t maxX = std::min(quad.maxX + 1, tileMaxX);
+    int32_t minY = std::max(quad.minY, tileMinY);
+    int32_t maxY = std::min(quad.maxY + 1, tileMaxY);
+
+    for (int32_t y = minY; y < maxY; y++)
+    {
+        float pixelY = static_cast<float>(y) + 0.5f;
+
+        // Found analytically, but only as a bound, each pixel in the span is still tested on its own.
+        float spanMinX = static_cast<float>(minX);
+        float spanMaxX = static_cast<float>(maxX);
+        if (!ClipSpan(quad.s.dx, quad.s.dy * pixelY + quad.s.c, spanMinX, spanMaxX) ||
+            !ClipSpan(quad.t.dx, quad.t.dy * pixelY + quad.t.c, spanMinX, spanMaxX))
+        {
+            continue;
+        }
+
+        int32_t spanStart = std::max(minX, static_cast<int32_t>(std::floor(spanMinX - 0.5f)));
+        int32_t spanEnd = std::min(maxX, static_cast<int32_t>(std::ceil(spanMaxX - 0.5f)) + 1);
+
+        if (spanStart >= spanEnd)
+        {
+            continue;
+        }
+
+        // The view's y axis points up, like the GPU backends' projections, but the buffers start with the top row.
+        size_t rowStart = static_cast<size_t>(viewHeight - 1 - y) * rowStride;
+        RasterizeSpan(quad, draw, pixelY, spanStart, spanEnd, &colorBuffer[rowStart], &depthBuffer[rowStart]);
+    }
+}
+
+// Shades pixels the same way as VKSprite.frag: the texture color is mixed towards the sprite's color by its tint,
+// alpha is multiplied, and fully transparent pixels are discarded without writing depth. The depth test then only
+// passes pixels strictly closer than what was already drawn, and blending uses source alpha over the destination.
+// Pixels are covered when their centers fall inside the sprite, including its bottom and left edges.
+void SoftwareRenderer::RasterizeSpan(const SoftwareQuad &quad, const SoftwareDraw &draw, float pixelY,
+                                     int32_t spanStart, int32_t spanEnd, uint32_t *colorRow, float *depthRow)
+{
+    const SoftwareTexture &texture = *draw.texture;
+    float rowS = quad.s.dy * pixelY + quad.s.c;
+    float rowT = quad.t.dy * pixelY + quad.t.c;
+    float rowU = quad.u.dy * pixelY + quad.u.c;
+    float rowV = quad.v.dy * pixelY + quad.v.c;
+    float oneMinusTint = 1.0f - quad.tint;
+
+#ifdef SOFTWARE_RENDERER_SSE2
+    // Four pixels at a time, starting at a multiple of four so that each group stays inside this tile's columns.
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 channelScale = _mm_set1_ps(255.0f);
+    const __m128i channelMask = _mm_set1_epi32(0xff);
+    const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i firstX = _mm_set1_epi32(spanStart - 1);
+    const __m128i endX = _mm_set1_epi32(spanEnd);
+
+    const __m128 sDx = _mm_set1_ps(quad.s.dx);
+    const __m128 tDx = _mm_set1_ps(quad.t.dx);
+    const __m128 uDx = _mm_set1_ps(quad.u.dx);
+    const __m128 vDx = _mm_set1_ps(quad.v.dx);
+    const __m128 rowSs = _mm_set1_ps(rowS);
+    const __m128 rowTs = _mm_set1_ps(rowT);
+    const __m128 rowUs = _mm_set1_ps(rowU);
+    const __m128 rowVs = _mm_set1_ps(rowV);
+    const __m128 depths = _mm_set1_ps(quad.depth);
+    const __m128 tints = _mm_set1_ps(quad.tint);
+    const __m128 oneMinusTints = _mm_set1_ps(oneMinusTint);
+    const __m128 tintedR = _mm_mul_ps(_mm_set1_ps(quad.r), tints);
+    const __m128 tintedG = _mm_mul_ps(_mm_set1_ps(quad.g), tints);
+    const __m128 tintedB = _mm_mul_ps(_mm_set1_ps(quad.b), tints);
+    const __m128 alphas = _mm_set1_ps(quad.a);
+
+    alignas(16) float us[4];
+    alignas(16) float vs[4];
+    alignas(16) uint32_t texels[4];
+    alignas(16) float sampled[4][4];
+
+    for (int32_t x = spanStart & ~3; x < spanEnd; x += 4)
+    {
+        __m128i xs = _mm_add_epi32(_mm_set1_epi32(x), laneOffsets);
+        __m128 mask = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(xs, firstX), _mm_cmplt_epi32(xs, endX)));
+        __m128 pixelX = _mm_add_ps(_mm_cvtepi32_ps(xs), half);
+
+        __m128 s = _mm_add_ps(_mm_mul_ps(sDx, pixelX), rowSs);
+        __m128 t = _mm_add_ps(_mm_mul_ps(tDx, pixelX), rowTs);
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(s, zero), _mm_cmplt_ps(s, one)));
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, one)));
+
+        __m128 oldDepths = _mm_loadu_ps(&depthRow[x]);
+        mask = _mm_and_ps(mask, _mm_cmpgt_ps(depths, oldDepths));
+
+        int32_t laneMask = _mm_movemask_ps(mask);
+        if (laneMask == 0)
+        {
+            continue;
+        }
+
+        _mm_store_ps(us, _mm_add_ps(_mm_mul_ps(uDx, pixelX), rowUs));
+        _mm_store_ps(vs, _mm_add_ps(_mm_mul_ps(vDx, pixelX), rowVs));
+
+        __m128 texR;
+        __m128 texG;
+        __m128 texB;
+        __m128 texA;
+
+        // Textures can't be gathered from with SSE2, so only the lookups are done one pixel at a time.
+        if (texture.smooth)
+        {
+            for (int32_t i = 0; i < 4; i++)
+            {
+                if (laneMask & (1 << i))
+                {
+                    SampleLinear(texture, us[i], vs[i], sampled[i]);
+                }
+                else
+                {
+                    sampled[i][0] = sampled[i][1] = sampled[i][2] = sampled[i][3] = 0.0f;
+                }
+            }
+
+            texR = _mm_setr_ps(sampled[0][0], sampled[1][0], sampled[2][0], sampled[3][0]);
+            texG = _mm_setr_ps(sampled[0][1], sampled[1][1], sampled[2][1], sampled[3][1]);
+            texB = _mm_setr_ps(sampled[0][2], sampled[1][2], sampled[2][2], sampled[3][2]);
+            texA = _mm_setr_ps(sampled[0][3], sampled[1][3], sampled[2][3], sampled[3][3]);
+        }
+        else
+        {
+            for (int32_t i = 0; i < 4; i++)
+            {
+                texels[i] = laneMask & (1 << i) ? SampleNearest(texture, us[i], vs[i]) : 0;
+            }
+
+            __m128i packed = _mm_load_si128(reinterpret_cast<const __m128i *>(texels));
+            texR = _mm_div_ps(
+                _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, redShift), channelMask)), channelScale);
+            texG = _mm_div_ps(
+                _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, greenShift), channelMask)), channelScale);
+            texB = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, channelMask)), channelScale);
+            texA = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(packed, alphaShift)), channelScale);
+        }
+
+        __m128 r = _mm_add_ps(_mm_mul_ps(texR, oneMinusTints), tintedR);
+        __m128 g = _mm_add_ps(_mm_mul_ps(texG, oneMinusTints), tintedG);
+        __m128 b = _mm_add_ps(_mm_mul_ps(texB, oneMinusTints), tintedB);
+        __m128 a = _mm_mul_ps(texA, alphas);
+
+        mask = _mm_and_ps(mask, _mm_cmpneq_ps(a, zero));
+        if (_mm_movemask_ps(mask) == 0)
+        {
+            continue;
+        }
+
+        __m128i oldColors = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&colorRow[x]));
+
+        if (draw.hasBlending)
+        {
+            __m128 oneMinusA = _mm_sub_ps(one, a);
+            __m128 oldR = _mm_div_ps(
+                _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(oldColors, redShift), channelMask)), channelScale);
+            __m128 oldG = _mm_div_ps(
+                _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(oldColors, greenShift), channelMask)), channelScale);
+            __m128 oldB = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(oldColors, channelMask)), channelScale);
+
+            r = _mm_add_ps(_mm_mul_ps(r, a), _mm_mul_ps(oldR, oneMinusA));
+            g = _mm_add_ps(_mm_mul_ps(g, a), _mm_mul_ps(oldG, oneMinusA));
+            b = _mm_add_ps(_mm_mul_ps(b, a), _mm_mul_ps(oldB, oneMinusA));
+        }
+
+        r = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(r, zero), one), channelScale), half);
+        g = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(g, zero), one), channelScale), half);
+        b = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), channelScale), half);
+
+        __m128i colors = _mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(r), redShift),
+                                      _mm_slli_epi32(_mm_cvttps_epi32(g), greenShift));
+        colors = _mm_or_si128(colors, _mm_cvttps_epi32(b));
+        colors = _mm_or_si128(colors, _mm_set1_epi32(static_cast<int32_t>(opaqueAlpha)));
+
+        __m128i colorMask = _mm_castps_si128(mask);
+        colors = _mm_or_si128(_mm_and_si128(colorMask, colors), _mm_andnot_si128(colorMask, oldColors));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&colorRow[x]), colors);
+        _mm_storeu_ps(&depthRow[x], _mm_or_ps(_mm_and_ps(mask, depths), _mm_andnot_ps(mask, oldDepths)));
+    }
+#else
+    // Mirrors the SSE2 path operation for operation, so both produce the same images.
+    float tintedR = quad.r * quad.tint;
+    float tintedG = quad.g * quad.tint;
+    float tintedB = quad.b * quad.tint;
+
+    for (int32_t x = spanStart; x < spanEnd; x++)
+    {
+        float pixelX = static_cast<float>(x) + 0.5f;
+        float s = quad.s.dx * pixelX + rowS;
+        float t = quad.t.dx * pixelX + rowT;
+
+        if (!(s >= 0.0f && s < 1.0f && t >= 0.0f && t < 1.0f) || !(quad.depth > depthRow[x]))
+        {
+            continue;
+        }
+
+        float u = quad.u.dx * pixelX + rowU;
+        float v = quad.v.dx * pixelX + rowV;
+        float texColor[4];
+
+        if (texture.smooth)
+        {
+            SampleLinear(texture, u, v, texColor);
+        }
+        else
+        {
+            uint32_t texel = SampleNearest(texture, u, v);
+            texColor[0] = UnpackChannel(texel, redShift);
+            texColor[1] = UnpackChannel(texel, greenShift);
+            texColor[2] = UnpackChannel(texel, blueShift);
+            texColor[3] = UnpackChannel(texel, alphaShift);
+        }
+
+        float r = texColor[0] * oneMinusTint + tintedR;
+        float g = texColor[1] * oneMinusTint + tintedG;
+        float b = texColor[2] * oneMinusTint + tintedB;
+        float a = texColor[3] * quad.a;
+
+        if (a == 0.0f)
+        {
+            continue;
+        }
+
+        if (draw.hasBlending)
+        {
+            float oneMinusA = 1.0f - a;
+            r = r * a + UnpackChannel(colorRow[x], redShift) * oneMinusA;
+            g = g * a + UnpackChannel(colorRow[x], greenShift) * oneMinusA;
+            b = b * a + UnpackChannel(colorRow[x], blueShift) * oneMinusA;
+        }
+
+        colorRow[x] = PackColor(r, g, b);
+        depthRow[x] = quad.depth;
+    }
+#endif
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../FramePacer.hpp"
+#include "../ImageLoader.hpp"
+#include "../Renderer.hpp"
+#include "../SpriteBatchPool.hpp"
+#include "ThreadPool.hpp"
+
+// Sprites are binned into square tiles of the view, which are rasterized in parallel. A multiple of four, so that
+// spans processed four pixels at a time never cross into a tile owned by another thread.
+const int32_t softwareTileSize = 32;
+
+struct SoftwareTexture
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    bool smooth = false;
+    // ARGB8888, with the rows in the same order as the image file.
+    std::vector<uint32_t> pixels;
+};
+
+struct SoftwareSpriteBatchData
+{
+    std::shared_ptr<SoftwareTexture> texture;
+    uint32_t maxSprites = 0;
+    // The batch's capacity as of its last draw.
+    uint32_t capacity = 0;
+    uint32_t peakSprites = 0;
+};
+
+// A batch drawn this frame, which keeps its texture alive until the frame is rasterized even if the batch is
+// destroyed before then.
+struct SoftwareDraw
+{
+    std::shared_ptr<SoftwareTexture> texture;
+    bool hasBlending = false;
+};
+
+// value = x * dx + y * dy + c, evaluated at pixel centers in view space.
+struct SoftwarePlane
+{
+    float dx;
+    float dy;
+    float c;
+};
+
+// A sprite after setup. Sprites are always parallelograms, so the position inside the sprite along its bottom and
+// left edges (s and t) and its texture coordinates are all planes over the view, rotated or not.
+struct SoftwareQuad
+{
+    SoftwarePlane s;
+    SoftwarePlane t;
+    SoftwarePlane u;
+    SoftwarePlane v;
+    float depth;
+    float r;
+    float g;
+    float b;
+    float a;
+    float tint;
+    // Inclusive pixel bounds, already clipped to the view.
+    int32_t minX;
+    int32_t minY;
+    int32_t maxX;
+    int32_t maxY;
+    uint32_t drawIndex;
+};
+
+// Rasterizes sprites on the CPU with the same tint, alpha, discard, depth and blending rules as the GPU backends,
+// and presents through the window's SDL surface, so it works without any GPU driver at all. Sprites are set up and
+// binned when their batch is drawn, and the tiles are rasterized on a thread pool in EndDrawing.
+class SoftwareRenderer : public Renderer
+{
+  public:
+    SoftwareRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
+                     int32_t viewHeight, const PresentConfig &presentConfig = PresentConfig());
+
+    ~SoftwareRenderer() override;
+    void ResizeWindow(int32_t windowWidth, int32_t windowHeight) override;
+    SDL_Window *GetWindowPtr() override;
+    RendererBackend GetBackend() override;
+
+    void SetBackgroundColor(float r, float g, float b) override;
+    void SetScreenBackgroundColor(float r, float g, float b) override;
+    void BeginDrawing() override;
+    void EndDrawing() override;
+
+    PresentStatus GetPresentStatus() override;
+    const FrameStats &GetFrameStats() override;
+    const GpuTimings &GetGpuTimings() override;
+    void SetGpuTimingsCsvPath(const std::string &path) override;
+    MemoryReport GetMemoryReport() override;
+    FrameTimeHistogram &GetFrameTimeHistogram(FrameTimeKind kind) override;
+
+    SpriteBatch &CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
+                                   bool enableBlending = false) override;
+    void DrawSpriteBatch(SpriteBatch &spriteBatch) override;
+    void DestroySpriteBatch(SpriteBatch &spriteBatch) override;
+    SpriteBatch *GetSpriteBatch(uint32_t id) override;
+
+  private:
+    void RasterizeTile(uint32_t tileIndex);
+    void RasterizeQuad(const SoftwareQuad &quad, int32_t tileMinX, int32_t tileMinY, int32_t tileMaxX,
+                       int32_t tileMaxY);
+    void RasterizeSpan(const SoftwareQuad &quad, const SoftwareDraw &draw, float pixelY, int32_t spanStart,
+                       int32_t spanEnd, uint32_t *colorRow, float *depthRow);
+    void Present();
+
+    SDL_Window *window = nullptr;
+    int32_t windowWidth = 0;
+    int32_t windowHeight = 0;
+    int32_t viewWidth = 0;
+    int32_t viewHeight = 0;
+    // Rows are padded to a multiple of four pixels.
+    int32_t rowStride = 0;
+    int32_t tileCountX = 0;
+    int32_t tileCountY = 0;
+
+    uint32_t backgroundColor = 0;
+    uint32_t screenBackgroundColor = 0;
+
+    ViewTransform viewTransform;
+    CompositeMode compositeMode = CompositeModeShader;
+
+    // ARGB8888 with the top row first, like an SDL surface, which viewSurface wraps without copying.
+    std::vector<uint32_t> colorBuffer;
+    // Holds sprite depths directly, a larger depth is closer, the same as after the GPU backends' projections.
+    std::vector<float> depthBuffer;
+    SDL_Surface *viewSurface = nullptr;
+
+    std::vector<SoftwareDraw> draws;
+    std::vector<SoftwareQuad> quads;
+    // Indices into quads for each tile, in the order they were drawn.
+    std::vector<std::vector<uint32_t>> tileQuads;
+    ThreadPool threadPool;
+
+    PresentConfig presentConfig;
+    FramePacer framePacer;
+    std::chrono::steady_clock::time_point frameStartTime;
+    float latencyMs = 0.0f;
+    uint64_t frame = 0;
+
+    FrameStats frameStats;
+    FrameStats currentFrameStats;
+    // Rasterizing and compositing take the place of the GPU's passes, so they are reported as GPU timings even
+    // though they are measured on the CPU and are also part of the frame's CPU time.
+    GpuTimings gpuTimings;
+    GpuTimingsCsv gpuTimingsCsv;
+
+    std::array<FrameTimeHistogram, frameTimeKindCount> frameTimeHistograms;
+    std::chrono::steady_clock::time_point lastPresentTime;
+
+    SpriteBatchPool<SoftwareSpriteBatchData> spriteBatches;
+};
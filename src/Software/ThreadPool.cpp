@@ -0,0 +1,87 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(uint32_t workerCount)
+{
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+
+    startCondition.notify_all();
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Run(uint32_t jobCount, const std::function<void(uint32_t)> &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        this->jobCount = jobCount;
+        nextJobIndex = 0;
+        busyWorkerCount = static_cast<uint32_t>(workers.size());
+        ++generation;
+    }
+
+    startCondition.notify_all();
+
+    RunJobs();
+
+    // Every worker has to check in, even the ones that found no jobs left, before the job can go out of scope.
+    std::unique_lock<std::mutex> lock(mutex);
+    finishCondition.wait(lock, [this] { return busyWorkerCount == 0; });
+    currentJob = nullptr;
+}
+
+uint32_t ThreadPool::GetWorkerCount()
+{
+    return static_cast<uint32_t>(workers.size());
+}
+
+void ThreadPool::WorkerLoop()
+{
+    uint64_t lastGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCondition.wait(lock, [&] { return isStopping || generation != lastGeneration; });
+
+            if (isStopping)
+            {
+                return;
+            }
+
+            lastGeneration = generation;
+        }
+
+        RunJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkerCount;
+        }
+
+        finishCondition.notify_one();
+    }
+}
+
+void ThreadPool::RunJobs()
+{
+    for (uint32_t i = nextJobIndex++; i < jobCount; i = nextJobIndex++)
+    {
+        (*currentJob)(i);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a job for every index in a range on a fixed set of worker threads. The calling thread takes jobs too, and
+// Run only returns once all of them have finished, so a pool without workers runs everything on the caller.
+class ThreadPool
+{
+  public:
+    ThreadPool(uint32_t workerCount);
+    ~ThreadPool();
+
+    // Calls job once for each index below jobCount, in no particular order and possibly concurrently.
+    void Run(uint32_t jobCount, const std::function<void(uint32_t)> &job);
+    uint32_t GetWorkerCount();
+
+  private:
+    void WorkerLoop();
+    void RunJobs();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable finishCondition;
+
+    // Written under the mutex before the generation changes, so workers that see the new generation see these too.
+    const std::function<void(uint32_t)> *currentJob = nullptr;
+    uint32_t jobCount = 0;
+    uint64_t generation = 0;
+    uint32_t busyWorkerCount = 0;
+    bool isStopping = false;
+
+    std::atomic<uint32_t> nextJobIndex{0};
+};
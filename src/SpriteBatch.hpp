@@ -1,15 +1,27 @@
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstring>
+#include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtx/matrix_transform_2d.hpp>
 #include <vector>
 
+#include "Trace.hpp"
+
 const uint32_t verticesPerSprite = 4;
 const uint32_t valuesPerSpriteVertex = 10;
 const uint32_t vertexValuesPerSprite = valuesPerSpriteVertex * verticesPerSprite;
 const uint32_t indicesPerSprite = 6;
 
+// Batches allocate nothing until the first sprite is added, then start with room for this many sprites (or maxSprites
+// if that is smaller) and double their capacity whenever they run out, up to maxSprites.
+const uint32_t initialSpriteCapacity = 64;
+// With shrinking enabled, a batch that has used at most a quarter of its capacity for this many clears in a row
+// halves its capacity.
+const uint32_t spriteBatchShrinkClearCount = 300;
+
 const std::vector<float> spriteVertices = {
     0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, // Bottom left
     1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, // Bottom right
@@ -37,32 +49,88 @@ struct Sprite
     float tint = 0.0f;
 };
 
+// The arguments of one call to SpriteBatch::Add.
+struct CapturedSprite
+{
+    float x;
+    float y;
+    float depth;
+    Sprite sprite;
+};
+
+// Sprites committed through SpriteBatch::CommitVertices while capturing, their vertices are kept separately in the
+// order they were committed.
+struct CapturedVertexRun
+{
+    // How many captured sprites were added before the run was committed.
+    uint32_t spriteIndex;
+    uint32_t spriteCount;
+};
+
+// Sprites for SpriteBatch::AddPacked are stored as a CapturedSprite's floats, in the same order as its fields, with no
+// padding or alignment between them.
+const uint32_t packedSpriteSize = sizeof(CapturedSprite);
+static_assert(packedSpriteSize == 17 * sizeof(float), "CapturedSprite must only contain floats");
+
+// Called the first time a sprite is dropped after each clear, with the batch's id and the limit it ran into.
+typedef std::function<void(uint32_t spriteBatchId, uint32_t maxSprites)> SpriteBatchOverflowCallback;
+
+// Renderers own their batches, see SpriteBatchPool, and hand out references to them. Batches can't be copied, since
+// a copy would duplicate the vertices and would no longer be the batch the renderer knows about.
 class SpriteBatch
 {
   public:
-    SpriteBatch(int32_t textureWidth, int32_t textureHeight, uint32_t maxSprites, bool enableBlending = false)
-        : id(nextId++), textureWidth(textureWidth), textureHeight(textureHeight), maxSprites(maxSprites),
+    SpriteBatch(uint32_t id, int32_t textureWidth, int32_t textureHeight, uint32_t maxSprites,
+                bool enableBlending = false)
+        : id(id), textureWidth(textureWidth), textureHeight(textureHeight), maxSprites(maxSprites),
           hasBlending(enableBlending)
     {
         inverseTextureWidth = 1.0f / textureWidth;
         inverseTextureHeight = 1.0f / textureHeight;
-
-        vertices = std::vector<float>(maxSprites * vertexValuesPerSprite);
-        indices = std::vector<uint32_t>(maxSprites * indicesPerSprite);
     }
 
+    SpriteBatch(const SpriteBatch &) = delete;
+    SpriteBatch &operator=(const SpriteBatch &) = delete;
+    SpriteBatch(SpriteBatch &&) = default;
+    SpriteBatch &operator=(SpriteBatch &&) = default;
+
     inline void Clear()
     {
+        if (isShrinkEnabled)
+        {
+            UpdateShrink();
+        }
+
         spriteCount = 0;
+        droppedSpriteCount = 0;
+        mappedSpriteCount = 0;
+        capturedSprites.clear();
+        capturedVertexRuns.clear();
+        capturedVertices.clear();
     }
 
     void Add(float x, float y, float depth, Sprite sprite)
     {
+        PXLIO_TRACE_ZONE("SpriteBatch::Add");
+
+        if (isCaptureEnabled)
+        {
+            capturedSprites.push_back(CapturedSprite{x, y, depth, sprite});
+        }
+
+        mappedSpriteCount = 0;
+
         if (spriteCount >= maxSprites)
         {
+            DropSprites(1);
             return;
         }
 
+        if (spriteCount >= capacity)
+        {
+            GrowCapacity(spriteCount + 1);
+        }
+
         uint32_t vertexI = spriteCount * vertexValuesPerSprite;
         uint32_t indexI = spriteCount * indicesPerSprite;
         ++spriteCount;
@@ -101,6 +169,82 @@ class SpriteBatch
         }
     }
 
+    // Adds count sprites laid out as described by packedSpriteSize, so that callers on the other side of an FFI can
+    // pass a whole frame's sprites in one call. The records don't need to be aligned.
+    void AddPacked(const uint8_t *records, uint32_t count)
+    {
+        PXLIO_TRACE_ZONE("SpriteBatch::AddPacked");
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            CapturedSprite packedSprite;
+            std::memcpy(&packedSprite, records + static_cast<size_t>(i) * packedSpriteSize, packedSpriteSize);
+            Add(packedSprite.x, packedSprite.y, packedSprite.depth, packedSprite.sprite);
+        }
+    }
+
+    // Only the first GetSpriteCount sprites' worth of vertices and indices are valid, the rest is spare capacity.
+    // Makes room for count more sprites and returns their vertices, so that they can be written in place without going
+    // through Add, valuesPerSpriteVertex floats for each of a sprite's verticesPerSprite vertices in the same order as
+    // spriteVertices, with texture coordinates from 0 to 1. Sprites that would pass maxSprites are dropped like they
+    // are by Add, so GetMappedSpriteCount can be less than count, and null is returned if none fit. The vertices stay
+    // valid until the batch is added to, cleared or mapped again.
+    float *MapVertices(uint32_t count)
+    {
+        mappedSpriteCount = 0;
+
+        uint32_t room = maxSprites - spriteCount;
+
+        if (count > room)
+        {
+            DropSprites(count - room);
+            count = room;
+        }
+
+        if (count == 0)
+        {
+            return nullptr;
+        }
+
+        GrowCapacity(spriteCount + count);
+        mappedSpriteCount = count;
+
+        return vertices.data() + static_cast<size_t>(spriteCount) * vertexValuesPerSprite;
+    }
+
+    // Adds the first count of the sprites written to the mapped vertices, only the indices are filled in here.
+    void CommitVertices(uint32_t count)
+    {
+        PXLIO_TRACE_ZONE("SpriteBatch::CommitVertices");
+
+        count = std::min(count, mappedSpriteCount);
+        mappedSpriteCount = 0;
+
+        if (isCaptureEnabled && count > 0)
+        {
+            const float *committedVertices = vertices.data() + static_cast<size_t>(spriteCount) * vertexValuesPerSprite;
+            capturedVertexRuns.push_back(CapturedVertexRun{static_cast<uint32_t>(capturedSprites.size()), count});
+            capturedVertices.insert(capturedVertices.end(), committedVertices,
+                                    committedVertices + static_cast<size_t>(count) * vertexValuesPerSprite);
+        }
+
+        for (uint32_t i = spriteCount; i < spriteCount + count; i++)
+        {
+            for (size_t j = 0; j < spriteIndices.size(); j++)
+            {
+                indices[i * indicesPerSprite + j] = i * verticesPerSprite + spriteIndices[j];
+            }
+        }
+
+        spriteCount += count;
+    }
+
+    // Sprites reserved by the last MapVertices that haven't been committed yet.
+    inline uint32_t GetMappedSpriteCount()
+    {
+        return mappedSpriteCount;
+    }
+
     inline const std::vector<float> &GetVertices()
     {
         return vertices;
@@ -116,6 +260,41 @@ class SpriteBatch
         return spriteCount;
     }
 
+    // Sprites added since the last clear that didn't fit in the batch.
+    inline uint32_t GetDroppedSpriteCount()
+    {
+        return droppedSpriteCount;
+    }
+
+    // Sprites dropped over the batch's whole lifetime, unlike GetDroppedSpriteCount this isn't reset by Clear.
+    inline uint32_t GetOverflowCount()
+    {
+        return overflowCount;
+    }
+
+    inline void SetOverflowCallback(const SpriteBatchOverflowCallback &callback)
+    {
+        overflowCallback = callback;
+    }
+
+    // Sprites the batch can hold before it has to grow again.
+    inline uint32_t GetCapacity()
+    {
+        return capacity;
+    }
+
+    inline uint32_t GetMaxSprites()
+    {
+        return maxSprites;
+    }
+
+    // Off by default, since a batch that is only full every few seconds would otherwise keep shrinking and growing.
+    inline void SetShrinkEnabled(bool enabled)
+    {
+        isShrinkEnabled = enabled;
+        lowUsageClearCount = 0;
+    }
+
     inline uint32_t GetId()
     {
         return id;
@@ -126,8 +305,96 @@ class SpriteBatch
         return hasBlending;
     }
 
+    // While enabled every batch keeps the arguments of each Add since it was last cleared, including sprites that
+    // didn't fit, and the vertices of each CommitVertices, so that CaptureRenderer can record them.
+    static void SetCaptureEnabled(bool enabled)
+    {
+        isCaptureEnabled = enabled;
+    }
+
+    inline const std::vector<CapturedSprite> &GetCapturedSprites()
+    {
+        return capturedSprites;
+    }
+
+    inline const std::vector<CapturedVertexRun> &GetCapturedVertexRuns()
+    {
+        return capturedVertexRuns;
+    }
+
+    // vertexValuesPerSprite floats for each sprite of each captured vertex run, one run after another.
+    inline const std::vector<float> &GetCapturedVertices()
+    {
+        return capturedVertices;
+    }
+
+    inline int32_t GetTextureWidth()
+    {
+        return textureWidth;
+    }
+
+    inline int32_t GetTextureHeight()
+    {
+        return textureHeight;
+    }
+
   private:
-    inline static uint32_t nextId;
+    // Counts sprites that didn't fit, calling the overflow callback for the first one since the last clear.
+    void DropSprites(uint32_t count)
+    {
+        bool isFirstDrop = droppedSpriteCount == 0;
+        droppedSpriteCount += count;
+        overflowCount += count;
+
+        if (isFirstDrop && overflowCallback)
+        {
+            overflowCallback(id, maxSprites);
+        }
+    }
+
+    // Doubles the capacity until it holds at least minCapacity sprites, which must be no more than maxSprites.
+    void GrowCapacity(uint32_t minCapacity)
+    {
+        uint32_t newCapacity = capacity == 0 ? std::min(initialSpriteCapacity, maxSprites) : capacity;
+
+        while (newCapacity < minCapacity)
+        {
+            newCapacity = static_cast<uint32_t>(std::min<uint64_t>(newCapacity * 2ull, maxSprites));
+        }
+
+        if (newCapacity != capacity)
+        {
+            SetCapacity(newCapacity);
+        }
+    }
+
+    void SetCapacity(uint32_t newCapacity)
+    {
+        PXLIO_TRACE_ZONE("SpriteBatch::SetCapacity");
+
+        capacity = newCapacity;
+        vertices.resize(static_cast<size_t>(capacity) * vertexValuesPerSprite);
+        indices.resize(static_cast<size_t>(capacity) * indicesPerSprite);
+        vertices.shrink_to_fit();
+        indices.shrink_to_fit();
+    }
+
+    void UpdateShrink()
+    {
+        if (capacity <= initialSpriteCapacity || spriteCount > capacity / 4)
+        {
+            lowUsageClearCount = 0;
+            return;
+        }
+
+        if (++lowUsageClearCount >= spriteBatchShrinkClearCount)
+        {
+            SetCapacity(std::max(capacity / 2, initialSpriteCapacity));
+            lowUsageClearCount = 0;
+        }
+    }
+
+    inline static bool isCaptureEnabled;
     uint32_t id = 0;
     int32_t textureWidth = 0;
     int32_t textureHeight = 0;
@@ -136,6 +403,17 @@ class SpriteBatch
     std::vector<float> vertices;
     std::vector<uint32_t> indices;
     uint32_t maxSprites = 0;
+    uint32_t capacity = 0;
     uint32_t spriteCount = 0;
+    // Sprites reserved by the last MapVertices that haven't been committed yet.
+    uint32_t mappedSpriteCount = 0;
+    uint32_t droppedSpriteCount = 0;
+    uint32_t overflowCount = 0;
+    SpriteBatchOverflowCallback overflowCallback;
+    bool isShrinkEnabled = false;
+    uint32_t lowUsageClearCount = 0;
     bool hasBlending = false;
+    std::vector<CapturedSprite> capturedSprites;
+    std::vector<CapturedVertexRun> capturedVertexRuns;
+    std::vector<float> capturedVertices;
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cinttypes>
+#include <utility>
+
+#include "SlotMap.hpp"
+#include "SpriteBatch.hpp"
+
+// Owns a renderer's sprite batches along with the backend's data for each of them. A batch's id is its slot map
+// handle, so finding its data is an array access rather than a hash lookup, and ids of destroyed batches are never
+// mistaken for the batches that reuse their slots. References to a batch stay valid until it is destroyed.
+template <typename T> class SpriteBatchPool
+{
+  public:
+    SpriteBatch &Create(int32_t textureWidth, int32_t textureHeight, uint32_t maxSprites, bool enableBlending, T data)
+    {
+        uint32_t id = entries.InsertWith([&](uint32_t handle) {
+            return Entry{SpriteBatch(handle, textureWidth, textureHeight, maxSprites, enableBlending), std::move(data)};
+        });
+
+        return entries.Get(id)->spriteBatch;
+    }
+
+    // Null for batches that have been destroyed or that belong to another pool.
+    T *Get(SpriteBatch &spriteBatch)
+    {
+        Entry *entry = entries.Get(spriteBatch.GetId());
+
+        if (!entry || &entry->spriteBatch != &spriteBatch)
+        {
+            return nullptr;
+        }
+
+        return &entry->data;
+    }
+
+    // Null for stale ids.
+    SpriteBatch *GetSpriteBatch(uint32_t id)
+    {
+        Entry *entry = entries.Get(id);
+
+        return entry ? &entry->spriteBatch : nullptr;
+    }
+
+    // Every reference to the batch is invalid afterwards.
+    void Destroy(SpriteBatch &spriteBatch)
+    {
+        if (Get(spriteBatch))
+        {
+            entries.Remove(spriteBatch.GetId());
+        }
+    }
+
+    // Calls function(id, data) for every batch that hasn't been destroyed.
+    template <typename F> void ForEach(F function)
+    {
+        entries.ForEach([&](uint32_t id, Entry &entry) { function(id, entry.data); });
+    }
+
+  private:
+    struct Entry
+    {
+        SpriteBatch spriteBatch;
+        T data;
+    };
+
+    SlotMap<Entry> entries;
+};
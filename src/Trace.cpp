@@ -0,0 +1,125 @@
+#include "Trace.hpp"
+
+#ifdef PXLIO_ENABLE_TRACING
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Events per thread, older events are overwritten once a thread's buffer is full.
+const uint64_t traceBufferCapacity = 1 << 18;
+
+struct TraceEvent
+{
+    const char *name;
+    int64_t beginNs;
+    int64_t endNs;
+    uint64_t frame;
+};
+
+struct TraceBuffer
+{
+    uint32_t threadIndex;
+    std::vector<TraceEvent> events;
+    // Published with release ordering after each event is written, so exports only see complete events.
+    std::atomic<uint64_t> eventCount{0};
+};
+
+static std::atomic<uint64_t> traceFrame{0};
+
+// Buffers are owned here rather than by their threads, so events survive threads that have exited.
+static std::mutex traceBuffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> traceBuffers;
+
+static TraceBuffer *GetThreadTraceBuffer()
+{
+    thread_local TraceBuffer *threadBuffer = nullptr;
+
+    if (!threadBuffer)
+    {
+        std::lock_guard<std::mutex> lock(traceBuffersMutex);
+
+        auto buffer = std::make_unique<TraceBuffer>();
+        buffer->threadIndex = static_cast<uint32_t>(traceBuffers.size());
+        buffer->events.resize(traceBufferCapacity);
+        threadBuffer = buffer.get();
+        traceBuffers.push_back(std::move(buffer));
+    }
+
+    return threadBuffer;
+}
+
+void Trace::Record(const char *name, int64_t beginNs, int64_t endNs, uint64_t frame)
+{
+    TraceBuffer *buffer = GetThreadTraceBuffer();
+    uint64_t eventCount = buffer->eventCount.load(std::memory_order_relaxed);
+
+    buffer->events[eventCount % traceBufferCapacity] = TraceEvent{name, beginNs, endNs, frame};
+    buffer->eventCount.store(eventCount + 1, std::memory_order_release);
+}
+#endif
+
+void Trace::NextFrame()
+{
+#ifdef PXLIO_ENABLE_TRACING
+    traceFrame.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+uint64_t Trace::GetFrame()
+{
+#ifdef PXLIO_ENABLE_TRACING
+    return traceFrame.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+void Trace::WriteChromeJson(const std::string &path, uint64_t firstFrame, uint64_t lastFrame)
+{
+#ifdef PXLIO_ENABLE_TRACING
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        RUNTIME_ERROR(std::string("Failed to open: ") + path);
+    }
+
+    std::lock_guard<std::mutex> lock(traceBuffersMutex);
+
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+    bool isFirstEvent = true;
+
+    for (const auto &buffer : traceBuffers)
+    {
+        file << (isFirstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+             << buffer->threadIndex << ",\"args\":{\"name\":\"Thread " << buffer->threadIndex << "\"}}";
+        isFirstEvent = false;
+
+        // Events being written concurrently by other threads may be torn, exporting from the thread that drives
+        // the frame loop between frames avoids that for the main thread.
+        uint64_t eventCount = buffer->eventCount.load(std::memory_order_acquire);
+        uint64_t firstEvent = eventCount > traceBufferCapacity ? eventCount - traceBufferCapacity : 0;
+
+        for (uint64_t i = firstEvent; i < eventCount; i++)
+        {
+            const TraceEvent &event = buffer->events[i % traceBufferCapacity];
+
+            if (event.frame < firstFrame || event.frame > lastFrame)
+            {
+                continue;
+            }
+
+            // Timestamps are in microseconds, fractions keep the nanosecond precision.
+            file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+                 << ",\"ts\":" << event.beginNs / 1000.0 << ",\"dur\":" << (event.endNs - event.beginNs) / 1000.0
+                 << ",\"args\":{\"frame\":" << event.frame << "}}";
+        }
+    }
+
+    file << "\n]}\n";
+#endif
+}
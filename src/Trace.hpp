@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <string>
+
+#include "AllocationTracker.hpp"
+#include "Error.hpp"
+
+// Scoped CPU zones that can be exported in the Chrome trace event format, which chrome://tracing and Perfetto can
+// both load. Zones only exist when building with PXLIO_ENABLE_TRACING, otherwise they compile to nothing.
+class Trace
+{
+  public:
+    // Events are tagged with the frame they began in, so that exports can select a range of frames.
+    static void NextFrame();
+    static uint64_t GetFrame();
+    // Writes the events from firstFrame to lastFrame inclusive. Each thread only keeps its most recent events, so
+    // older frames may be incomplete.
+    static void WriteChromeJson(const std::string &path, uint64_t firstFrame, uint64_t lastFrame);
+
+#ifdef PXLIO_ENABLE_TRACING
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Only the calling thread writes to its buffer, so recording never takes a lock.
+    static void Record(const char *name, int64_t beginNs, int64_t endNs, uint64_t frame);
+#endif
+};
+
+#ifdef PXLIO_ENABLE_TRACING
+class TraceZone
+{
+  public:
+    // The name has to outlive the trace, so it should be a string literal.
+    TraceZone(const char *name) : name(name), beginNs(Trace::Now()), frame(Trace::GetFrame())
+    {
+    }
+
+    ~TraceZone()
+    {
+        Trace::Record(name, beginNs, Trace::Now(), frame);
+    }
+
+  private:
+    const char *name;
+    int64_t beginNs;
+    uint64_t frame;
+};
+
+#endif
+
+#define PXLIO_TRACE_CONCAT_INNER(a, b) a##b
+#define PXLIO_TRACE_CONCAT(a, b) PXLIO_TRACE_CONCAT_INNER(a, b)
+
+// Debug builds that track allocations attribute them to the innermost zone, even when tracing is disabled.
+#if defined(PXLIO_TRACK_ALLOCATIONS) && !defined(NDEBUG)
+#define PXLIO_ALLOCATION_SITE(name) AllocationSiteScope PXLIO_TRACE_CONCAT(allocationSite, __LINE__)(name)
+#else
+#define PXLIO_ALLOCATION_SITE(name)
+#endif
+
+#ifdef PXLIO_ENABLE_TRACING
+#define PXLIO_TRACE_ZONE(name)                                                                                         \
+    TraceZone PXLIO_TRACE_CONCAT(traceZone, __LINE__)(name);                                                           \
+    PXLIO_ALLOCATION_SITE(name)
+#else
+#define PXLIO_TRACE_ZONE(name) PXLIO_ALLOCATION_SITE(name)
+#endif
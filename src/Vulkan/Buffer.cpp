@@ -24,7 +24,12 @@ Buffer::Buffer(VmaAllocator allocator, VkDeviceSize byteSize, VkBufferUsageFlags
     if (byteSize != 0 &&
         vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation, &allocInfo) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create buffer!");
+        RENDERER_ERROR("Failed to create buffer!");
+    }
+
+    if (byteSize != 0)
+    {
+        ++allocationCount;
     }
 }
 
@@ -82,4 +87,22 @@ void Buffer::SetData(const void *data)
         return;
 
     memcpy(allocInfo.pMappedData, data, byteSize);
-}
\ No newline at end of file
+}
+
+void Buffer::SetData(const void *data, size_t dataByteSize, size_t byteOffset)
+{
+    if (byteSize == 0 || dataByteSize == 0)
+        return;
+
+    if (byteOffset > byteSize || dataByteSize > byteSize - byteOffset)
+    {
+        RUNTIME_ERROR("Data is too large for the buffer!");
+    }
+
+    memcpy(static_cast<char *>(allocInfo.pMappedData) + byteOffset, data, dataByteSize);
+}
+
+uint64_t Buffer::GetAllocationCount()
+{
+    return allocationCount;
+}
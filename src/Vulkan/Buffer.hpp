@@ -74,13 +74,20 @@ class Buffer
     Buffer(VmaAllocator allocator, VkDeviceSize byteSize, VkBufferUsageFlags usage, bool cpuAccessible);
     void Destroy(VmaAllocator &allocator);
     void SetData(const void *data);
+    // Writes dataByteSize bytes starting byteOffset bytes into the buffer, which must be CPU accessible.
+    void SetData(const void *data, size_t dataByteSize, size_t byteOffset = 0);
     void CopyTo(VmaAllocator &allocator, VkQueue graphicsQueue, VkDevice device, Commands &commands, Buffer &dst);
     const VkBuffer &GetBuffer();
     size_t GetSize();
     void Map(VmaAllocator allocator, void **data);
     void Unmap(VmaAllocator allocator);
 
+    // Number of buffers created so far, used to count allocations per frame.
+    static uint64_t GetAllocationCount();
+
   private:
+    inline static uint64_t allocationCount = 0;
+
     VkBuffer buffer;
     VmaAllocation allocation;
     VmaAllocationInfo allocInfo;
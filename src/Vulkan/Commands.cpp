@@ -46,7 +46,7 @@ void Commands::CreatePool(VkPhysicalDevice physicalDevice, VkDevice device, VkSu
 
     if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create graphics command pool!");
+        RENDERER_ERROR("Failed to create graphics command pool!");
     }
 }
 
@@ -62,7 +62,7 @@ void Commands::CreateBuffers(VkDevice device, size_t maxFramesInFlight)
 
     if (vkAllocateCommandBuffers(device, &allocInfo, buffers.data()) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to allocate command buffers!");
+        RENDERER_ERROR("Failed to allocate command buffers!");
     }
 }
 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cinttypes>
+#include <deque>
+#include <functional>
+#include <utility>
+
+// Defers the destruction of Vulkan objects until the frames that might still reference them have finished.
+class DeletionQueue
+{
+  public:
+    void Push(std::function<void()> deletion)
+    {
+        deletions.push_back(std::make_pair(frame, deletion));
+    }
+
+    // Runs every deletion that was queued at least framesInFlight frames ago. Must be called after waiting on the
+    // current frame's fence, which guarantees that all of those older frames have completed on the GPU.
+    void Flush(uint32_t framesInFlight)
+    {
+        while (!deletions.empty() && deletions.front().first + framesInFlight <= frame)
+        {
+            deletions.front().second();
+            deletions.pop_front();
+        }
+    }
+
+    // Runs every queued deletion, only safe once the device is idle.
+    void FlushAll()
+    {
+        while (!deletions.empty())
+        {
+            deletions.front().second();
+            deletions.pop_front();
+        }
+    }
+
+    void NextFrame()
+    {
+        ++frame;
+    }
+
+  private:
+    std::deque<std::pair<uint64_t, std::function<void()>>> deletions;
+    uint64_t frame = 0;
+};
@@ -0,0 +1,159 @@
+#include "GpuTimer.hpp"
+
+void GpuTimer::Create(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex,
+                      uint32_t maxFramesInFlight)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+
+    if (validBits == 0 || properties.limits.timestampPeriod == 0.0f)
+    {
+        return;
+    }
+
+    timestampPeriod = properties.limits.timestampPeriod;
+    timestampMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = gpuTimestampsPerFrame * maxFramesInFlight;
+
+    if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS)
+    {
+        RENDERER_ERROR("Failed to create query pool!");
+    }
+
+    frames.resize(maxFramesInFlight);
+    results.resize(gpuTimestampsPerFrame * 2);
+    timestamps.resize(gpuTimestampsPerFrame);
+    supported = true;
+}
+
+void GpuTimer::Cleanup(VkDevice device)
+{
+    if (queryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(device, queryPool, nullptr);
+    }
+}
+
+void GpuTimer::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+    if (!supported)
+    {
+        return;
+    }
+
+    currentFrameIndex = frameIndex;
+
+    GpuTimestampFrame &timestampFrame = frames[frameIndex];
+    timestampFrame.frame = frameCount++;
+    timestampFrame.pending = true;
+    timestampFrame.spriteBatchIds.clear();
+
+    vkCmdResetQueryPool(commandBuffer, queryPool, frameIndex * gpuTimestampsPerFrame, gpuTimestampsPerFrame);
+}
+
+void GpuTimer::Write(VkCommandBuffer commandBuffer, GpuTimestamp timestamp, VkPipelineStageFlagBits stage)
+{
+    if (!supported)
+    {
+        return;
+    }
+
+    WriteQuery(commandBuffer, timestamp, stage);
+}
+
+void GpuTimer::BeginSpriteBatch(VkCommandBuffer commandBuffer, uint32_t spriteBatchId)
+{
+    timingSpriteBatch = false;
+
+    if (!supported)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> &spriteBatchIds = frames[currentFrameIndex].spriteBatchIds;
+
+    if (spriteBatchIds.size() >= maxTimedSpriteBatches)
+    {
+        return;
+    }
+
+    uint32_t query = GpuTimestampFirstSpriteBatch + static_cast<uint32_t>(spriteBatchIds.size()) * 2;
+    WriteQuery(commandBuffer, query, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+    spriteBatchIds.push_back(spriteBatchId);
+    timingSpriteBatch = true;
+}
+
+void GpuTimer::EndSpriteBatch(VkCommandBuffer commandBuffer)
+{
+    if (!timingSpriteBatch)
+    {
+        return;
+    }
+
+    uint32_t spriteBatchCount = static_cast<uint32_t>(frames[currentFrameIndex].spriteBatchIds.size());
+    uint32_t query = GpuTimestampFirstSpriteBatch + spriteBatchCount * 2 - 1;
+    WriteQuery(commandBuffer, query, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    timingSpriteBatch = false;
+}
+
+bool GpuTimer::Read(VkDevice device, uint32_t frameIndex, GpuTimings &timings)
+{
+    if (!supported || !frames[frameIndex].pending)
+    {
+        return false;
+    }
+
+    GpuTimestampFrame &timestampFrame = frames[frameIndex];
+    timestampFrame.pending = false;
+
+    uint32_t spriteBatchCount = static_cast<uint32_t>(timestampFrame.spriteBatchIds.size());
+    uint32_t queryCount = GpuTimestampFirstSpriteBatch + spriteBatchCount * 2;
+
+    // Each result is followed by its availability, timestamps that weren't written this frame stay unavailable.
+    VkResult result = vkGetQueryPoolResults(device, queryPool, frameIndex * gpuTimestampsPerFrame, queryCount,
+                                            queryCount * 2 * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+                                            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (result != VK_SUCCESS && result != VK_NOT_READY)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < queryCount; i++)
+    {
+        timestamps[i].reset();
+
+        if (results[i * 2 + 1] != 0)
+        {
+            timestamps[i] = results[i * 2] & timestampMask;
+        }
+    }
+
+    ResolveGpuTimings(timestampFrame, timestamps, timestampPeriod, timings);
+
+    return true;
+}
+
+const bool GpuTimer::GetSupported()
+{
+    return supported;
+}
+
+void GpuTimer::WriteQuery(VkCommandBuffer commandBuffer, uint32_t query, VkPipelineStageFlagBits stage)
+{
+    vkCmdWriteTimestamp(commandBuffer, stage, queryPool, currentFrameIndex * gpuTimestampsPerFrame + query);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <optional>
+#include <vector>
+
+#include "../Error.hpp"
+#include "../GpuTimings.hpp"
+
+// Records timestamps with a query pool that has a separate set of queries for each frame in flight, so results can
+// be read once a frame's fence has been waited on without stalling.
+class GpuTimer
+{
+  public:
+    void Create(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex,
+                uint32_t maxFramesInFlight);
+    void Cleanup(VkDevice device);
+
+    // Resets the frame's queries, so it has to be recorded outside of a render pass.
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    void Write(VkCommandBuffer commandBuffer, GpuTimestamp timestamp, VkPipelineStageFlagBits stage);
+    void BeginSpriteBatch(VkCommandBuffer commandBuffer, uint32_t spriteBatchId);
+    void EndSpriteBatch(VkCommandBuffer commandBuffer);
+    // Reads the results from the last time the frame index was recorded, returns false if there are none. Doesn't
+    // wait for results, so the frame's fence has to be waited on first.
+    bool Read(VkDevice device, uint32_t frameIndex, GpuTimings &timings);
+
+    const bool GetSupported();
+
+  private:
+    void WriteQuery(VkCommandBuffer commandBuffer, uint32_t query, VkPipelineStageFlagBits stage);
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    bool supported = false;
+    float timestampPeriod = 1.0f;
+    uint64_t timestampMask = 0;
+
+    std::vector<GpuTimestampFrame> frames;
+    // Scratch space for reading results back, sized for a full frame so that reading never allocates.
+    std::vector<uint64_t> results;
+    std::vector<std::optional<uint64_t>> timestamps;
+    uint32_t currentFrameIndex = 0;
+    uint64_t frameCount = 0;
+    bool timingSpriteBatch = false;
+};
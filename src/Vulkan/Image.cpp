@@ -43,7 +43,7 @@ Image::Image(VmaAllocator allocator, uint32_t width, uint32_t height, VkFormat f
 
     if (vmaCreateImage(allocator, &imageInfo, &aci, &image, &allocation, nullptr) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to allocate image memory!");
+        RENDERER_ERROR("Failed to allocate image memory!");
     }
 
     this->width = width;
@@ -150,6 +150,8 @@ Buffer Image::LoadImage(const std::string &imagePath, VmaAllocator allocator, in
 Image Image::CreateTexture(const std::string &image, VmaAllocator allocator, Commands &commands, VkQueue graphicsQueue,
                            VkDevice device, bool enableMipmaps)
 {
+    PXLIO_TRACE_ZONE("Image::CreateTexture");
+
     int32_t texWidth, texHeight;
     Buffer stagingBuffer = LoadImage(image, allocator, texWidth, texHeight);
     uint32_t mipMapLevels = enableMipmaps ? CalcMipmapLevels(texWidth, texHeight) : 1;
@@ -225,7 +227,7 @@ VkSampler Image::CreateTextureSampler(VkPhysicalDevice physicalDevice, VkDevice
 
     if (vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create texture sampler!");
+        RENDERER_ERROR("Failed to create texture sampler!");
     }
 
     return textureSampler;
@@ -248,7 +250,7 @@ VkImageView Image::CreateView(VkImageAspectFlags aspectFlags, VkDevice device)
     VkImageView imageView;
     if (vkCreateImageView(device, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create texture image view!");
+        RENDERER_ERROR("Failed to create texture image view!");
     }
 
     return imageView;
@@ -361,6 +363,11 @@ void Image::Destroy(VmaAllocator allocator)
     vmaDestroyImage(allocator, image, allocation);
 }
 
+VkImage Image::GetImage() const
+{
+    return image;
+}
+
 uint32_t Image::GetWidth() const
 {
     return width;
@@ -369,4 +376,18 @@ uint32_t Image::GetWidth() const
 uint32_t Image::GetHeight() const
 {
     return height;
+}
+
+VkDeviceSize Image::GetByteSize(VmaAllocator allocator) const
+{
+    // Swapchain images aren't allocated by VMA.
+    if (allocation == VK_NULL_HANDLE)
+    {
+        return 0;
+    }
+
+    VmaAllocationInfo allocationInfo;
+    vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+
+    return allocationInfo.size;
 }
\ No newline at end of file
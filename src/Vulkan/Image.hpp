@@ -7,6 +7,7 @@
 
 #include "../Error.hpp"
 #include "../ImageLoader.hpp"
+#include "../Trace.hpp"
 #include "Buffer.hpp"
 
 class Image
@@ -34,12 +35,15 @@ class Image
                         uint32_t fullHeight = 0);
     void GenerateMipmaps(Commands &commands, VkQueue graphicsQueue, VkDevice device);
     void Destroy(VmaAllocator allocator);
+    VkImage GetImage() const;
     uint32_t GetWidth() const;
     uint32_t GetHeight() const;
+    // Size of the image's allocation, including mipmaps and any padding the driver requires.
+    VkDeviceSize GetByteSize(VmaAllocator allocator) const;
 
   private:
     VkImage image;
-    VmaAllocation allocation;
+    VmaAllocation allocation = VK_NULL_HANDLE;
     VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
     uint32_t layerCount = 1;
     uint32_t width = 0;
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
 
+#include "../Trace.hpp"
+#include "DeletionQueue.hpp"
+
 template <typename V, typename I, typename D> class Model
 {
   public:
@@ -31,6 +35,28 @@ template <typename V, typename I, typename D> class Model
         return model;
     };
 
+    // Creates a model that is rewritten every frame. Each frame in flight gets its own persistently mapped,
+    // host visible ring of buffers so the CPU can write the next frame's geometry while the GPU is still reading the
+    // last, and so the model can be drawn more than once per frame.
+    static Model<V, I, D> CreateStreaming(const size_t maxVertices, const size_t maxIndices, const size_t maxInstances,
+                                          const uint32_t maxFramesInFlight, VmaAllocator allocator,
+                                          Commands &commands, VkQueue graphicsQueue, VkDevice device)
+    {
+        Model model = Create(maxInstances, allocator, commands, graphicsQueue, device);
+
+        model.streamingFrames.resize(maxFramesInFlight);
+
+        for (uint32_t i = 0; i < maxFramesInFlight; i++)
+        {
+            model.streamingFrames[i].vertexBuffer =
+                Buffer(allocator, maxVertices * sizeof(V), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, true);
+            model.streamingFrames[i].indexBuffer =
+                Buffer(allocator, maxIndices * sizeof(I), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, true);
+        }
+
+        return model;
+    }
+
     void Draw(VkCommandBuffer commandBuffer)
     {
         if (vertexBuffer.GetSize() == 0 || instanceBuffer.GetSize() == 0 || indexBuffer.GetSize() == 0)
@@ -51,6 +77,98 @@ template <typename V, typename I, typename D> class Model
         vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(size), static_cast<uint32_t>(instanceCount), 0, 0, 0);
     }
 
+    // Draws the geometry written by the last call to UpdateStreaming.
+    void DrawStreaming(VkCommandBuffer commandBuffer, uint32_t currentFrame)
+    {
+        StreamingFrame &frame = streamingFrames[currentFrame];
+
+        if (frame.drawSize == 0 || instanceBuffer.GetSize() == 0)
+            return;
+
+        if (instanceCount < 1)
+            return;
+
+        VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+
+        if (sizeof(I) == 4)
+            indexType = VK_INDEX_TYPE_UINT32;
+
+        VkDeviceSize vertexOffsets[] = {frame.drawVertexOffset};
+        VkDeviceSize instanceOffsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &frame.vertexBuffer.GetBuffer(), vertexOffsets);
+        vkCmdBindVertexBuffers(commandBuffer, 1, 1, &instanceBuffer.GetBuffer(), instanceOffsets);
+        vkCmdBindIndexBuffer(commandBuffer, frame.indexBuffer.GetBuffer(), frame.drawIndexOffset, indexType);
+        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(frame.drawSize), static_cast<uint32_t>(instanceCount), 0,
+                         0, 0);
+    }
+
+    // Rewinds currentFrame's ring, only safe once the fence for currentFrame has been waited on, since the GPU may
+    // still be reading what was written the last time this frame index was used. A ring that ended up much larger
+    // than what the finished frame used is shrunk, so memory follows the model when it stops being drawn as much.
+    void ResetStreaming(uint32_t currentFrame, VmaAllocator allocator, DeletionQueue &deletionQueue)
+    {
+        StreamingFrame &frame = streamingFrames[currentFrame];
+
+        if (frame.vertexBytesUsed * 4 <= frame.vertexBuffer.GetSize())
+        {
+            ReallocateStreamingBuffer(frame.vertexBuffer, frame.vertexBytesUsed, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                      allocator, deletionQueue);
+        }
+
+        if (frame.indexBytesUsed * 4 <= frame.indexBuffer.GetSize())
+        {
+            ReallocateStreamingBuffer(frame.indexBuffer, frame.indexBytesUsed, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                      allocator, deletionQueue);
+        }
+
+        frame.vertexOffset = 0;
+        frame.indexOffset = 0;
+        frame.vertexBytesUsed = 0;
+        frame.indexBytesUsed = 0;
+        frame.drawSize = 0;
+    }
+
+    // Appends the geometry to currentFrame's ring, growing it when full. The outgrown buffers are retired through the
+    // deletion queue, since draws recorded earlier in the frame still read from them, and the new ones are sized for
+    // everything written this frame so the next use of this frame index fits in one buffer.
+    void UpdateStreaming(const V *vertices, const I *indices, size_t vertexCount, size_t indexCount,
+                         uint32_t currentFrame, VmaAllocator allocator, DeletionQueue &deletionQueue)
+    {
+        PXLIO_TRACE_ZONE("Model::UpdateStreaming");
+
+        StreamingFrame &frame = streamingFrames[currentFrame];
+        size_t vertexByteSize = vertexCount * sizeof(V);
+        size_t indexByteSize = indexCount * sizeof(I);
+
+        if (frame.vertexOffset + vertexByteSize > frame.vertexBuffer.GetSize())
+        {
+            ReallocateStreamingBuffer(frame.vertexBuffer,
+                                      std::max(frame.vertexBuffer.GetSize() * 2, frame.vertexBytesUsed + vertexByteSize),
+                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, allocator, deletionQueue);
+            frame.vertexOffset = 0;
+        }
+
+        if (frame.indexOffset + indexByteSize > frame.indexBuffer.GetSize())
+        {
+            ReallocateStreamingBuffer(frame.indexBuffer,
+                                      std::max(frame.indexBuffer.GetSize() * 2, frame.indexBytesUsed + indexByteSize),
+                                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT, allocator, deletionQueue);
+            frame.indexOffset = 0;
+        }
+
+        frame.vertexBuffer.SetData(vertices, vertexByteSize, frame.vertexOffset);
+        frame.indexBuffer.SetData(indices, indexByteSize, frame.indexOffset);
+
+        frame.drawVertexOffset = frame.vertexOffset;
+        frame.drawIndexOffset = frame.indexOffset;
+        frame.drawSize = indexCount;
+
+        frame.vertexOffset += vertexByteSize;
+        frame.indexOffset += indexByteSize;
+        frame.vertexBytesUsed += vertexByteSize;
+        frame.indexBytesUsed += indexByteSize;
+    }
+
     void Update(const std::vector<V> &vertices, const std::vector<I> &indices, Commands &commands,
                 VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device)
     {
@@ -60,6 +178,8 @@ template <typename V, typename I, typename D> class Model
     void Update(const V *vertices, const I *indices, size_t vertexCount, size_t indexCount, Commands &commands,
                 VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device)
     {
+        PXLIO_TRACE_ZONE("Model::Update");
+
         size = indexCount;
 
         vkDeviceWaitIdle(device);
@@ -74,24 +194,73 @@ template <typename V, typename I, typename D> class Model
     void UpdateInstances(const std::vector<D> &instances, Commands &commands, VmaAllocator allocator,
                          VkQueue graphicsQueue, VkDevice device)
     {
+        PXLIO_TRACE_ZONE("Model::UpdateInstances");
+
         instanceCount = instances.size();
         instanceStagingBuffer.SetData(instances.data());
         instanceStagingBuffer.CopyTo(allocator, graphicsQueue, device, commands, instanceBuffer);
     }
 
+    // Bytes requested for every buffer the model owns.
+    size_t GetByteSize()
+    {
+        size_t byteSize = vertexBuffer.GetSize() + indexBuffer.GetSize() + instanceBuffer.GetSize() +
+                          instanceStagingBuffer.GetSize();
+
+        for (StreamingFrame &frame : streamingFrames)
+        {
+            byteSize += frame.vertexBuffer.GetSize() + frame.indexBuffer.GetSize();
+        }
+
+        return byteSize;
+    }
+
     void Destroy(VmaAllocator allocator)
     {
         vertexBuffer.Destroy(allocator);
         indexBuffer.Destroy(allocator);
         instanceStagingBuffer.Destroy(allocator);
         instanceBuffer.Destroy(allocator);
+
+        for (StreamingFrame &frame : streamingFrames)
+        {
+            frame.vertexBuffer.Destroy(allocator);
+            frame.indexBuffer.Destroy(allocator);
+        }
     }
 
   private:
+    // One frame in flight's ring. The offsets are where the next write goes in the current buffers, the bytes used
+    // count every write this frame including those left in outgrown buffers. The draw fields describe the last write.
+    struct StreamingFrame
+    {
+        Buffer vertexBuffer;
+        Buffer indexBuffer;
+        size_t vertexOffset = 0;
+        size_t indexOffset = 0;
+        size_t vertexBytesUsed = 0;
+        size_t indexBytesUsed = 0;
+        VkDeviceSize drawVertexOffset = 0;
+        VkDeviceSize drawIndexOffset = 0;
+        size_t drawSize = 0;
+    };
+
+    static void ReallocateStreamingBuffer(Buffer &buffer, size_t byteSize, VkBufferUsageFlags usage,
+                                          VmaAllocator allocator, DeletionQueue &deletionQueue)
+    {
+        if (buffer.GetSize() == byteSize)
+            return;
+
+        Buffer oldBuffer = buffer;
+        deletionQueue.Push([=]() mutable { oldBuffer.Destroy(allocator); });
+        buffer = Buffer(allocator, byteSize, usage, true);
+    }
+
     Buffer vertexBuffer;
     Buffer indexBuffer;
     Buffer instanceBuffer;
     Buffer instanceStagingBuffer;
+    std::vector<StreamingFrame> streamingFrames;
     size_t size = 0;
     size_t instanceCount = 0;
 };
\ No newline at end of file
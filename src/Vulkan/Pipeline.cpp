@@ -15,7 +15,7 @@ void Pipeline::CreateDescriptorSetLayout(VkDevice device,
 
     if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create descriptor set layout!");
+        RENDERER_ERROR("Failed to create descriptor set layout!");
     }
 }
 
@@ -35,7 +35,7 @@ void Pipeline::CreateDescriptorPool(const uint32_t maxFramesInFlight, VkDevice d
 
     if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create descriptor pool!");
+        RENDERER_ERROR("Failed to create descriptor pool!");
     }
 }
 
@@ -55,7 +55,7 @@ void Pipeline::CreateDescriptorSets(
     descriptorSets.resize(maxFramesInFlight);
     if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to allocate descriptor sets!");
+        RENDERER_ERROR("Failed to allocate descriptor sets!");
     }
 
     for (uint32_t i = 0; i < maxFramesInFlight; i++)
@@ -82,7 +82,7 @@ VkShaderModule Pipeline::CreateShaderModule(const std::vector<char> &code, VkDev
     VkShaderModule shaderModule;
     if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create shader module!");
+        RENDERER_ERROR("Failed to create shader module!");
     }
 
     return shaderModule;
@@ -94,7 +94,7 @@ std::vector<char> Pipeline::ReadFile(const std::string &filename)
 
     if (!file.is_open())
     {
-        RUNTIME_ERROR(std::string("Failed to open file: ") + filename);
+        RENDERER_ERROR(std::string("Failed to open file: ") + filename);
     }
 
     size_t fileSize = (size_t)file.tellg();
@@ -145,7 +145,7 @@ class Pipeline
 
         if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
         {
-            RUNTIME_ERROR("Failed to create pipeline layout!");
+            RENDERER_ERROR("Failed to create pipeline layout!");
         }
 
         VkGraphicsPipelineCreateInfo pipelineInfo{};
@@ -165,10 +165,23 @@ class Pipeline
         pipelineInfo.subpass = 0;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
+        // Dynamic rendering pipelines are created against attachment formats rather than a render pass.
+        VkFormat colorFormat = renderPass.GetColorFormat();
+        VkPipelineRenderingCreateInfoKHR renderingInfo{};
+
+        if (renderPass.GetDynamicRenderingEnabled())
+        {
+            renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+            renderingInfo.colorAttachmentCount = 1;
+            renderingInfo.pColorAttachmentFormats = &colorFormat;
+            renderingInfo.depthAttachmentFormat = renderPass.GetDepthFormat();
+            pipelineInfo.pNext = &renderingInfo;
+        }
+
         if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) !=
             VK_SUCCESS)
         {
-            RUNTIME_ERROR("Failed to create graphics pipeline!");
+            RENDERER_ERROR("Failed to create graphics pipeline!");
         }
 
         vkDestroyShaderModule(device, fragShaderModule, nullptr);
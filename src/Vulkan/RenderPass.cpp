@@ -72,7 +72,7 @@ void RenderPass::Create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
         depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference colorAttachmentResolveRef{};
-        colorAttachmentResolveRef.attachment = 2;
+        colorAttachmentResolveRef.attachment = depthEnabled ? 2 : 1;
         colorAttachmentResolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
         VkSubpassDescription subpass{};
@@ -100,7 +100,12 @@ void RenderPass::Create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
         dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
-        std::vector<VkAttachmentDescription> attachments = {colorAttachment, depthAttachment};
+        std::vector<VkAttachmentDescription> attachments = {colorAttachment};
+
+        if (depthEnabled)
+        {
+            attachments.push_back(depthAttachment);
+        }
 
         if (msaaEnabled)
         {
@@ -120,24 +125,30 @@ void RenderPass::Create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
 
         if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
         {
-            RUNTIME_ERROR("Failed to create render pass!");
+            RENDERER_ERROR("Failed to create render pass!");
         }
 
         return renderPass;
     };
 
+    // The attachments are owned by the render pass, so they can be retired along with the framebuffers
+    // when recreating instead of being destroyed by a cleanup callback.
+    ownsAttachments = true;
+
     std::function<void(const VkExtent2D &)> recreateCallback = [=](const VkExtent2D &extent) {
-        CreateColorResources(allocator, physicalDevice, device, extent);
-        CreateDepthResources(allocator, physicalDevice, device, extent);
-    };
+        if (msaaEnabled)
+        {
+            CreateColorResources(allocator, physicalDevice, device, extent);
+        }
 
-    std::function<void()> cleanupCallback = [=] {
-        vkDestroyImageView(device, depthImageView, nullptr);
-        depthImage.Destroy(allocator);
-        vkDestroyImageView(device, colorImageView, nullptr);
-        colorImage.Destroy(allocator);
+        if (depthEnabled)
+        {
+            CreateDepthResources(allocator, physicalDevice, device, extent);
+        }
     };
 
+    std::function<void()> cleanupCallback = nullptr;
+
     std::function<void(std::vector<VkImageView> &, VkImageView)> setupFramebuffer =
         [&](std::vector<VkImageView> &attachments, VkImageView imageView) {
             if (msaaEnabled)
@@ -149,7 +160,10 @@ void RenderPass::Create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
                 attachments.push_back(imageView);
             }
 
-            attachments.push_back(depthImageView);
+            if (depthEnabled)
+            {
+                attachments.push_back(depthImageView);
+            }
 
             if (msaaEnabled)
             {
@@ -162,6 +176,70 @@ void RenderPass::Create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
                  setupFramebuffer);
 }
 
+void RenderPass::CreateOffscreen(
+    VkDevice device, uint32_t width, uint32_t height, uint32_t framebufferCount,
+    std::function<VkRenderPass()> setupRenderPass,
+    std::function<void(std::vector<VkImageView> &attachments, uint32_t i)> setupFramebuffer)
+{
+    renderPass = setupRenderPass();
+
+    framebuffers.resize(framebufferCount);
+
+    for (uint32_t i = 0; i < framebufferCount; i++)
+    {
+        std::vector<VkImageView> attachments;
+        setupFramebuffer(attachments, i);
+
+        framebuffers[i] = CreateFramebuffer(device, attachments, width, height);
+    }
+}
+
+void RenderPass::CreateDynamic(VkDevice device, Swapchain &swapchain, const DynamicRenderingFunctions &functions)
+{
+    dynamicRenderingEnabled = true;
+    dynamicRenderingFunctions = functions;
+    imageFormat = swapchain.GetImageFormat();
+    finalColorLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    CreateImages(device, swapchain);
+    CreateImageViews(device);
+    CreateSwapchainTargets();
+}
+
+void RenderPass::CreateDynamicOffscreen(VkFormat colorFormat, VkFormat depthFormat, VkImageLayout finalColorLayout,
+                                        const std::vector<RenderTarget> &targets,
+                                        const DynamicRenderingFunctions &functions)
+{
+    dynamicRenderingEnabled = true;
+    dynamicRenderingFunctions = functions;
+    imageFormat = colorFormat;
+    this->depthFormat = depthFormat;
+    this->finalColorLayout = finalColorLayout;
+    dynamicTargets = targets;
+}
+
+void RenderPass::SetDynamicDepth(VkFormat depthFormat, const std::vector<VkImage> &depthImages,
+                                 const std::vector<VkImageView> &depthImageViews)
+{
+    this->depthFormat = depthFormat;
+    dynamicDepthImages = depthImages;
+    dynamicDepthImageViews = depthImageViews;
+}
+
+void RenderPass::CreateSwapchainTargets()
+{
+    dynamicTargets.resize(images.size());
+    dynamicDepthImages.clear();
+    dynamicDepthImageViews.clear();
+
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        dynamicTargets[i] = RenderTarget{};
+        dynamicTargets[i].colorImage = images[i].GetImage();
+        dynamicTargets[i].colorImageView = imageViews[i];
+    }
+}
+
 void RenderPass::CreateImages(VkDevice device, Swapchain &swapchain)
 {
     VkSwapchainKHR vkSwapchain = swapchain.GetSwapchain();
@@ -181,21 +259,28 @@ void RenderPass::CreateImages(VkDevice device, Swapchain &swapchain)
 }
 
 void RenderPass::Begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, uint32_t width, uint32_t height,
-                       const std::vector<VkClearValue> &clearValues)
+                       const std::vector<VkClearValue> &clearValues, const uint32_t frameIndex)
 {
     VkExtent2D extent = {width, height};
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = framebuffers[imageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = extent;
+    if (dynamicRenderingEnabled)
+    {
+        BeginDynamic(imageIndex, frameIndex, commandBuffer, extent, clearValues);
+    }
+    else
+    {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = framebuffers[imageIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = extent;
 
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
 
     VkViewport viewport{};
     viewport.x = 0.0f;
@@ -214,9 +299,133 @@ void RenderPass::Begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer,
 
 void RenderPass::End(VkCommandBuffer commandBuffer)
 {
+    if (dynamicRenderingEnabled)
+    {
+        EndDynamic(commandBuffer);
+        return;
+    }
+
     vkCmdEndRenderPass(commandBuffer);
 }
 
+void RenderPass::BeginDynamic(const uint32_t targetIndex, const uint32_t frameIndex, VkCommandBuffer commandBuffer,
+                              VkExtent2D extent, const std::vector<VkClearValue> &clearValues)
+{
+    currentTarget = targetIndex;
+    const RenderTarget &target = dynamicTargets[targetIndex];
+    VkImage depthImage = target.depthImage;
+    VkImageView depthImageView = target.depthImageView;
+
+    if (!dynamicDepthImageViews.empty())
+    {
+        depthImage = dynamicDepthImages[frameIndex];
+        depthImageView = dynamicDepthImageViews[frameIndex];
+    }
+
+    bool hasDepth = depthImageView != VK_NULL_HANDLE;
+
+    // The previous contents are cleared, so the attachments can be transitioned from an undefined layout. The depth
+    // barrier still waits on the last pass's depth writes to the image, which would otherwise race the transition.
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+
+    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[0].image = target.colorImage;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].srcAccessMask = 0;
+    barriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barriers[0].subresourceRange.levelCount = 1;
+    barriers[0].subresourceRange.layerCount = 1;
+
+    if (hasDepth)
+    {
+        VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+        if (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT)
+        {
+            depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+
+        barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barriers[1].image = depthImage;
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[1].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barriers[1].dstAccessMask =
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barriers[1].subresourceRange.aspectMask = depthAspect;
+        barriers[1].subresourceRange.levelCount = 1;
+        barriers[1].subresourceRange.layerCount = 1;
+    }
+
+    VkPipelineStageFlags stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                  VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                  VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    vkCmdPipelineBarrier(commandBuffer, stages, stages, 0, 0, nullptr, 0, nullptr, hasDepth ? 2 : 1,
+                         barriers.data());
+
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = target.colorImageView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = clearValues[0];
+
+    VkRenderingAttachmentInfoKHR depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = depthImageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+    if (clearValues.size() > 1)
+    {
+        depthAttachment.clearValue = clearValues[1];
+    }
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = extent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+
+    dynamicRenderingFunctions.beginRendering(commandBuffer, &renderingInfo);
+}
+
+void RenderPass::EndDynamic(VkCommandBuffer commandBuffer)
+{
+    dynamicRenderingFunctions.endRendering(commandBuffer);
+
+    bool presenting = finalColorLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = dynamicTargets[currentTarget].colorImage;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barrier.newLayout = finalColorLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = presenting ? 0 : VK_ACCESS_SHADER_READ_BIT;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkPipelineStageFlags dstStage =
+        presenting ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, dstStage, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+}
+
 const VkRenderPass &RenderPass::GetRenderPass()
 {
     return renderPass;
@@ -232,6 +441,21 @@ const bool RenderPass::GetMsaaEnabled()
     return msaaEnabled;
 }
 
+const bool RenderPass::GetDynamicRenderingEnabled()
+{
+    return dynamicRenderingEnabled;
+}
+
+const VkFormat RenderPass::GetColorFormat()
+{
+    return imageFormat;
+}
+
+const VkFormat RenderPass::GetDepthFormat()
+{
+    return depthFormat;
+}
+
 void RenderPass::CreateImageViews(VkDevice device)
 {
     imageViews.resize(images.size());
@@ -251,20 +475,30 @@ void RenderPass::CreateFramebuffers(VkDevice device, uint32_t width, uint32_t he
         std::vector<VkImageView> attachments;
         setupFramebuffer(attachments, imageViews[i]);
 
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = renderPass;
-        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        framebufferInfo.pAttachments = attachments.data();
-        framebufferInfo.width = width;
-        framebufferInfo.height = height;
-        framebufferInfo.layers = 1;
+        framebuffers[i] = CreateFramebuffer(device, attachments, width, height);
+    }
+}
 
-        if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffers[i]) != VK_SUCCESS)
-        {
-            RUNTIME_ERROR("Failed to create framebuffer!");
-        }
+VkFramebuffer RenderPass::CreateFramebuffer(VkDevice device, const std::vector<VkImageView> &attachments,
+                                            uint32_t width, uint32_t height)
+{
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferInfo.pAttachments = attachments.data();
+    framebufferInfo.width = width;
+    framebufferInfo.height = height;
+    framebufferInfo.layers = 1;
+
+    VkFramebuffer framebuffer;
+
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS)
+    {
+        RENDERER_ERROR("Failed to create framebuffer!");
     }
+
+    return framebuffer;
 }
 
 void RenderPass::CreateDepthResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice, VkDevice device,
@@ -288,9 +522,17 @@ void RenderPass::CreateColorResources(VmaAllocator allocator, VkPhysicalDevice p
 }
 
 void RenderPass::Recreate(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator,
-                          Swapchain &swapchain, uint32_t width, uint32_t height)
+                          Swapchain &swapchain, uint32_t width, uint32_t height, DeletionQueue &deletionQueue)
 {
-    CleanupForRecreation(allocator, device);
+    RetireForRecreation(allocator, device, deletionQueue);
+
+    if (dynamicRenderingEnabled)
+    {
+        CreateImages(device, swapchain);
+        CreateImageViews(device);
+        CreateSwapchainTargets();
+        return;
+    }
 
     const VkExtent2D &extent = swapchain.GetExtent();
 
@@ -318,7 +560,7 @@ VkFormat RenderPass::FindSupportedFormat(VkPhysicalDevice physicalDevice, const
         }
     }
 
-    RUNTIME_ERROR("Failed to find supported format!");
+    RENDERER_ERROR("Failed to find supported format!");
 }
 
 VkFormat RenderPass::FindDepthFormat(VkPhysicalDevice physicalDevice)
@@ -328,9 +570,70 @@ VkFormat RenderPass::FindDepthFormat(VkPhysicalDevice physicalDevice)
                                VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 }
 
-void RenderPass::CleanupForRecreation(VmaAllocator allocator, VkDevice device)
+void RenderPass::RetireForRecreation(VmaAllocator allocator, VkDevice device, DeletionQueue &deletionQueue)
+{
+    if (cleanupCallback)
+    {
+        cleanupCallback();
+    }
+
+    // Frames that are still in flight may be using the old framebuffers and attachments,
+    // so they are destroyed once those frames have finished.
+    std::vector<VkFramebuffer> oldFramebuffers = framebuffers;
+    std::vector<VkImageView> oldImageViews = imageViews;
+    bool destroyColor = ownsAttachments && msaaEnabled;
+    bool destroyDepth = ownsAttachments && depthEnabled;
+    Image oldColorImage = colorImage;
+    VkImageView oldColorImageView = colorImageView;
+    Image oldDepthImage = depthImage;
+    VkImageView oldDepthImageView = depthImageView;
+
+    deletionQueue.Push([=]() mutable {
+        for (auto framebuffer : oldFramebuffers)
+        {
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+
+        for (auto imageView : oldImageViews)
+        {
+            vkDestroyImageView(device, imageView, nullptr);
+        }
+
+        if (destroyColor)
+        {
+            vkDestroyImageView(device, oldColorImageView, nullptr);
+            oldColorImage.Destroy(allocator);
+        }
+
+        if (destroyDepth)
+        {
+            vkDestroyImageView(device, oldDepthImageView, nullptr);
+            oldDepthImage.Destroy(allocator);
+        }
+    });
+
+    framebuffers.clear();
+    imageViews.clear();
+}
+
+void RenderPass::Cleanup(VmaAllocator allocator, VkDevice device)
 {
-    cleanupCallback();
+    if (cleanupCallback)
+    {
+        cleanupCallback();
+    }
+
+    if (ownsAttachments && msaaEnabled)
+    {
+        vkDestroyImageView(device, colorImageView, nullptr);
+        colorImage.Destroy(allocator);
+    }
+
+    if (ownsAttachments && depthEnabled)
+    {
+        vkDestroyImageView(device, depthImageView, nullptr);
+        depthImage.Destroy(allocator);
+    }
 
     for (auto framebuffer : framebuffers)
     {
@@ -341,11 +644,7 @@ void RenderPass::CleanupForRecreation(VmaAllocator allocator, VkDevice device)
     {
         vkDestroyImageView(device, imageView, nullptr);
     }
-}
 
-void RenderPass::Cleanup(VmaAllocator allocator, VkDevice device)
-{
-    CleanupForRecreation(allocator, device);
     vkDestroyRenderPass(device, renderPass, nullptr);
 }
 
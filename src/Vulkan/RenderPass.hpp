@@ -8,9 +8,24 @@
 #include <vector>
 
 #include "../Error.hpp"
+#include "DeletionQueue.hpp"
 #include "Image.hpp"
 #include "Swapchain.hpp"
 
+struct DynamicRenderingFunctions
+{
+    PFN_vkCmdBeginRenderingKHR beginRendering = nullptr;
+    PFN_vkCmdEndRenderingKHR endRendering = nullptr;
+};
+
+struct RenderTarget
+{
+    VkImage colorImage = VK_NULL_HANDLE;
+    VkImageView colorImageView = VK_NULL_HANDLE;
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkImageView depthImageView = VK_NULL_HANDLE;
+};
+
 class RenderPass
 {
   public:
@@ -21,11 +36,29 @@ class RenderPass
         std::function<void(std::vector<VkImageView> &attachments, VkImageView imageView)> setupFramebuffer);
     void Create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator, Swapchain &swapchain,
                 bool enableDepth, bool enableMsaa);
+    // Creates a render pass that draws into caller owned attachments rather than the swapchain images, it doesn't
+    // depend on the swapchain so it never needs to be recreated when the window is resized.
+    void CreateOffscreen(VkDevice device, uint32_t width, uint32_t height, uint32_t framebufferCount,
+                         std::function<VkRenderPass()> setupRenderPass,
+                         std::function<void(std::vector<VkImageView> &attachments, uint32_t i)> setupFramebuffer);
+    // Dynamic passes are recorded with VK_KHR_dynamic_rendering and explicit layout transitions, so there are no
+    // VkRenderPass or VkFramebuffer objects, recreating one only replaces the swapchain image views.
+    void CreateDynamic(VkDevice device, Swapchain &swapchain, const DynamicRenderingFunctions &functions);
+    void CreateDynamicOffscreen(VkFormat colorFormat, VkFormat depthFormat, VkImageLayout finalColorLayout,
+                                const std::vector<RenderTarget> &targets, const DynamicRenderingFunctions &functions);
+    // Adds a depth attachment per frame in flight to a dynamic pass that targets the swapchain, Begin picks the one
+    // for the frame being recorded so frames in flight never share one. It has to be set again after recreating.
+    void SetDynamicDepth(VkFormat depthFormat, const std::vector<VkImage> &depthImages,
+                         const std::vector<VkImageView> &depthImageViews);
+    // Objects that depend on the old swapchain are queued for deletion instead of waiting for the device to go idle.
+    // Attachments owned by a CreateCustom caller are cleaned up immediately, so the caller has to ensure they
+    // are no longer in use.
     void Recreate(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator, Swapchain &swapchain,
-                  uint32_t width, uint32_t height);
+                  uint32_t width, uint32_t height, DeletionQueue &deletionQueue);
 
+    // frameIndex selects the depth attachment given to SetDynamicDepth, other passes ignore it.
     void Begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, uint32_t width, uint32_t height,
-               const std::vector<VkClearValue> &clearValues);
+               const std::vector<VkClearValue> &clearValues, const uint32_t frameIndex = 0);
     void End(VkCommandBuffer commandBuffer);
 
     VkFormat FindSupportedFormat(VkPhysicalDevice physicalDevice, const std::vector<VkFormat> &candidates,
@@ -36,18 +69,27 @@ class RenderPass
     const VkFramebuffer &GetFramebuffer(const uint32_t imageIndex);
     const VkSampleCountFlagBits GetMsaaSamples();
     const bool GetMsaaEnabled();
+    const bool GetDynamicRenderingEnabled();
+    const VkFormat GetColorFormat();
+    const VkFormat GetDepthFormat();
 
     void Cleanup(VmaAllocator, VkDevice device);
 
   private:
     void CreateImages(VkDevice device, Swapchain &swapchain);
     void CreateFramebuffers(VkDevice device, uint32_t width, uint32_t height);
+    VkFramebuffer CreateFramebuffer(VkDevice device, const std::vector<VkImageView> &attachments, uint32_t width,
+                                    uint32_t height);
     void CreateDepthResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice, VkDevice device,
                               VkExtent2D extent);
     void CreateColorResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice, VkDevice device,
                               VkExtent2D extent);
     void CreateImageViews(VkDevice device);
-    void CleanupForRecreation(VmaAllocator allocator, VkDevice device);
+    void RetireForRecreation(VmaAllocator allocator, VkDevice device, DeletionQueue &deletionQueue);
+    void CreateSwapchainTargets();
+    void BeginDynamic(const uint32_t targetIndex, const uint32_t frameIndex, VkCommandBuffer commandBuffer,
+                      VkExtent2D extent, const std::vector<VkClearValue> &clearValues);
+    void EndDynamic(VkCommandBuffer commandBuffer);
 
     const VkSampleCountFlagBits GetMaxUsableSamples(VkPhysicalDevice physicalDevice);
 
@@ -55,7 +97,7 @@ class RenderPass
     std::function<void(const VkExtent2D &)> recreateCallback;
     std::function<void(std::vector<VkImageView> &attachments, VkImageView imageView)> setupFramebuffer;
 
-    VkRenderPass renderPass;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
 
     std::vector<Image> images;
     std::vector<VkImageView> imageViews;
@@ -66,7 +108,18 @@ class RenderPass
     Image colorImage;
     VkImageView colorImageView;
     VkFormat imageFormat;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
     bool depthEnabled = false;
     bool msaaEnabled = false;
+    bool ownsAttachments = false;
     VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    bool dynamicRenderingEnabled = false;
+    DynamicRenderingFunctions dynamicRenderingFunctions;
+    std::vector<RenderTarget> dynamicTargets;
+    // Indexed by frame in flight rather than by target, see SetDynamicDepth.
+    std::vector<VkImage> dynamicDepthImages;
+    std::vector<VkImageView> dynamicDepthImageViews;
+    VkImageLayout finalColorLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    uint32_t currentTarget = 0;
 };
\ No newline at end of file
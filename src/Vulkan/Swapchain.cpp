@@ -1,19 +1,19 @@
 #include "Swapchain.hpp"
 
 void Swapchain::Create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, int32_t windowWidth,
-                       int32_t windowHeight, VkPresentModeKHR preferredPresentMode)
+                       int32_t windowHeight, VkPresentModeKHR preferredPresentMode, uint32_t preferredImageCount,
+                       VkSwapchainKHR oldSwapchain)
 {
+    this->preferredPresentMode = preferredPresentMode;
+    this->preferredImageCount = preferredImageCount;
+
     SwapchainSupportDetails swapchainSupport = QuerySupport(physicalDevice, surface);
 
     VkSurfaceFormatKHR surfaceFormat = ChooseSurfaceFormat(swapchainSupport.formats);
-    VkPresentModeKHR presentMode = ChoosePresentMode(swapchainSupport.presentModes, preferredPresentMode);
+    presentMode = ChoosePresentMode(swapchainSupport.presentModes, preferredPresentMode);
     extent = ChooseExtent(swapchainSupport.capabilities, windowWidth, windowHeight);
 
-    uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
-    if (swapchainSupport.capabilities.maxImageCount > 0 && imageCount > swapchainSupport.capabilities.maxImageCount)
-    {
-        imageCount = swapchainSupport.capabilities.maxImageCount;
-    }
+    uint32_t imageCount = ChooseImageCount(swapchainSupport.capabilities, preferredImageCount);
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -26,6 +26,13 @@ void Swapchain::Create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfa
     createInfo.imageArrayLayers = 1;
     createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+    // Allows the view to be blit onto the swapchain images.
+    transferDstSupported = (swapchainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0;
+    if (transferDstSupported)
+    {
+        createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+
     QueueFamilyIndices indices = QueueFamilyIndices::FindQueueFamilies(physicalDevice, surface);
     uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
 
@@ -44,13 +51,18 @@ void Swapchain::Create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfa
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = oldSwapchain;
 
     if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapchain) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create swap chain!");
+        RENDERER_ERROR("Failed to create swap chain!");
     }
 
     imageFormat = surfaceFormat.format;
+
+    vkGetSwapchainImagesKHR(device, swapchain, &imageCount, nullptr);
+    images.resize(imageCount);
+    vkGetSwapchainImagesKHR(device, swapchain, &imageCount, images.data());
 }
 
 SwapchainSupportDetails Swapchain::QuerySupport(VkPhysicalDevice device, VkSurfaceKHR surface)
@@ -97,17 +109,44 @@ VkSurfaceFormatKHR Swapchain::ChooseSurfaceFormat(const std::vector<VkSurfaceFor
 VkPresentModeKHR Swapchain::ChoosePresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes,
                                               VkPresentModeKHR preferredPresentMode)
 {
-    for (const auto &availablePresentMode : availablePresentModes)
+    std::vector<VkPresentModeKHR> candidates = {preferredPresentMode};
+
+    // Immediate falls back to mailbox, which keeps its low latency without tearing. The other modes fall straight
+    // back to FIFO since they all avoid tearing, or only tear when a frame is late.
+    if (preferredPresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
     {
-        if (availablePresentMode == preferredPresentMode)
+        candidates.push_back(VK_PRESENT_MODE_MAILBOX_KHR);
+    }
+
+    for (VkPresentModeKHR candidate : candidates)
+    {
+        if (std::find(availablePresentModes.begin(), availablePresentModes.end(), candidate) !=
+            availablePresentModes.end())
         {
-            return availablePresentMode;
+            return candidate;
         }
     }
 
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+uint32_t Swapchain::ChooseImageCount(const VkSurfaceCapabilitiesKHR &capabilities, uint32_t preferredImageCount)
+{
+    uint32_t imageCount = capabilities.minImageCount + 1;
+
+    if (preferredImageCount > 0)
+    {
+        imageCount = std::max(preferredImageCount, capabilities.minImageCount);
+    }
+
+    if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount)
+    {
+        imageCount = capabilities.maxImageCount;
+    }
+
+    return imageCount;
+}
+
 VkExtent2D Swapchain::ChooseExtent(const VkSurfaceCapabilitiesKHR &capabilities, int32_t windowWidth,
                                    int32_t windowHeight)
 {
@@ -134,13 +173,16 @@ void Swapchain::Cleanup(VmaAllocator allocator, VkDevice device)
 }
 
 void Swapchain::Recreate(VmaAllocator allocator, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
-                         int32_t windowWidth, int32_t windowHeight)
+                         int32_t windowWidth, int32_t windowHeight, DeletionQueue &deletionQueue)
 {
-    vkDeviceWaitIdle(device);
+    // Hand the old swapchain over to the new one instead of draining the GPU, it is destroyed once the frames
+    // that were presenting to it have completed.
+    VkSwapchainKHR oldSwapchain = swapchain;
 
-    Cleanup(allocator, device);
+    Create(device, physicalDevice, surface, windowWidth, windowHeight, preferredPresentMode, preferredImageCount,
+           oldSwapchain);
 
-    Create(device, physicalDevice, surface, windowWidth, windowHeight);
+    deletionQueue.Push([=] { vkDestroySwapchainKHR(device, oldSwapchain, nullptr); });
 }
 
 VkResult Swapchain::GetNextImage(VkDevice device, VkSemaphore semaphore, uint32_t &imageIndex)
@@ -158,6 +200,26 @@ const VkFormat &Swapchain::GetImageFormat()
     return imageFormat;
 }
 
+const bool Swapchain::GetTransferDstSupported()
+{
+    return transferDstSupported;
+}
+
+const VkImage Swapchain::GetImage(uint32_t imageIndex)
+{
+    return images[imageIndex];
+}
+
+const VkPresentModeKHR Swapchain::GetPresentMode()
+{
+    return presentMode;
+}
+
+const uint32_t Swapchain::GetImageCount()
+{
+    return static_cast<uint32_t>(images.size());
+}
+
 const VkExtent2D &Swapchain::GetExtent()
 {
     return extent;
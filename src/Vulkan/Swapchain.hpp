@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "../Error.hpp"
+#include "DeletionQueue.hpp"
 #include "Image.hpp"
 #include "QueueFamilyIndices.hpp"
 
@@ -24,24 +25,37 @@ class Swapchain
 {
   public:
     void Create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, int32_t windowWidth,
-                int32_t windowHeight, VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR);
+                int32_t windowHeight, VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR,
+                uint32_t preferredImageCount = 0, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
     void Cleanup(VmaAllocator allocator, VkDevice device);
     void Recreate(VmaAllocator allocator, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
-                  int32_t windowWidth, int32_t windowHeight);
+                  int32_t windowWidth, int32_t windowHeight, DeletionQueue &deletionQueue);
 
     SwapchainSupportDetails QuerySupport(VkPhysicalDevice device, VkSurfaceKHR surface);
     VkSurfaceFormatKHR ChooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats);
+    // Falls back to the closest supported mode, FIFO is the last resort because it is always supported.
     VkPresentModeKHR ChoosePresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes,
                                        VkPresentModeKHR preferredPresentMode);
+    // Zero picks one more than the minimum, so that an image is always available to acquire.
+    uint32_t ChooseImageCount(const VkSurfaceCapabilitiesKHR &capabilities, uint32_t preferredImageCount);
     VkExtent2D ChooseExtent(const VkSurfaceCapabilitiesKHR &capabilities, int32_t windowWidth, int32_t windowHeight);
     VkResult GetNextImage(VkDevice device, VkSemaphore semaphore, uint32_t &imageIndex);
 
     const VkSwapchainKHR &GetSwapchain();
     const VkExtent2D &GetExtent();
     const VkFormat &GetImageFormat();
+    const bool GetTransferDstSupported();
+    const VkImage GetImage(uint32_t imageIndex);
+    const VkPresentModeKHR GetPresentMode();
+    const uint32_t GetImageCount();
 
   private:
-    VkSwapchainKHR swapchain;
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
     VkExtent2D extent;
+    std::vector<VkImage> images;
     VkFormat imageFormat;
+    bool transferDstSupported = false;
+    VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    uint32_t preferredImageCount = 0;
 };
\ No newline at end of file
@@ -31,6 +31,11 @@ template <typename T> class UniformBuffer
         }
     }
 
+    void Update(const T &data, uint32_t i)
+    {
+        memcpy(buffersMapped[i], &data, sizeof(T));
+    }
+
     const VkBuffer &GetBuffer(uint32_t i)
     {
         return buffers[i].GetBuffer();
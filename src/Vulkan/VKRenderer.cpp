@@ -4,7 +4,14 @@ const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation
 
 const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
-const uint32_t maxFramesInFlight = 2;
+// Dynamic rendering is core in Vulkan 1.3, the extension and its dependencies are used so that it is
+// also available on 1.1 and 1.2 drivers that support it.
+const std::vector<const char *> dynamicRenderingExtensions = {VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+                                                              VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME,
+                                                              VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME};
+
+// Lets the allocator report the driver's budget and usage per heap, instead of estimating them.
+const std::vector<const char *> memoryBudgetExtensions = {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME};
 
 #ifdef NDEBUG
 const bool enableValidationLayers = false;
@@ -38,12 +45,35 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT
 }
 
 VKRenderer::VKRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
-                       int32_t viewHeight, bool enableVsync)
+                       int32_t viewHeight, const PresentConfig &presentConfig)
     : windowWidth(windowWidth), windowHeight(windowHeight), viewWidth(viewWidth), viewHeight(viewHeight),
-      enableVsync(enableVsync)
+      presentConfig(presentConfig)
 {
-    InitWindow(windowName);
-    InitVulkan(maxFramesInFlight);
+    if (presentConfig.maxFramesInFlight < 1)
+    {
+        RUNTIME_ERROR("At least one frame must be allowed in flight!");
+    }
+
+    framePacer.SetTargetFps(presentConfig.targetFps);
+
+    // Failures in code that is shared with later calls, like creating the swapchain or pipelines, should also let
+    // another backend be tried while the renderer is still being created.
+    isRendererInitializing = true;
+
+    try
+    {
+        InitWindow(windowName);
+        InitVulkan();
+    }
+    catch (const RendererInitError &)
+    {
+        isRendererInitializing = false;
+        CleanupFailedInit();
+        throw;
+    }
+
+    isRendererInitializing = false;
+
     ResizeWindow(windowWidth, windowHeight);
 }
 
@@ -60,6 +90,11 @@ SDL_Window *VKRenderer::GetWindowPtr()
     return window;
 }
 
+RendererBackend VKRenderer::GetBackend()
+{
+    return RendererBackendVulkan;
+}
+
 void VKRenderer::SetBackgroundColor(float r, float g, float b)
 {
     backgroundR = r;
@@ -74,52 +109,240 @@ void VKRenderer::SetScreenBackgroundColor(float r, float g, float b)
     screenBackgroundB = b;
 }
 
+void VKRenderer::RecreateSwapchain()
+{
+    WaitWhileMinimized();
+    int32_t width;
+    int32_t height;
+    SDL_Vulkan_GetDrawableSize(window, &width, &height);
+    vulkanState.swapchain.Recreate(vulkanState.allocator, vulkanState.device, vulkanState.physicalDevice,
+                                   vulkanState.surface, width, height, deletionQueue);
+    HandleResize();
+}
+
 void VKRenderer::HandleResize()
 {
-    renderPass.Recreate(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator, vulkanState.swapchain,
-                        viewWidth, viewHeight);
+    // Only the passes that target the swapchain need to be recreated,
+    // the view sized offscreen pass and the pipelines are unaffected.
     const VkExtent2D &extent = vulkanState.swapchain.GetExtent();
     screenRenderPass.Recreate(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
-                              vulkanState.swapchain, extent.width, extent.height);
-    screenPipeline.Recreate<VertexData, InstanceData>(vulkanState.device, vulkanState.maxFramesInFlight,
-                                                      screenRenderPass);
+                              vulkanState.swapchain, extent.width, extent.height, deletionQueue);
 
+    if (vulkanState.dynamicRenderingEnabled)
+    {
+        directRenderPass.Recreate(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                                  vulkanState.swapchain, extent.width, extent.height, deletionQueue);
+    }
+
+    UpdateViewTransform();
+}
+
+void VKRenderer::UpdateViewTransform()
+{
     ViewTransform viewTransform = Renderer::CalcViewTransform(windowWidth, windowHeight, viewWidth, viewHeight);
 
-    ScreenUniformBufferData screenUboData{};
     screenUboData.proj =
         VkOrtho(0.0f, static_cast<float>(windowWidth), 0.0f, static_cast<float>(windowHeight), -zMax, zMax);
     screenUboData.viewSize = glm::vec2(viewTransform.scaledViewWidth, viewTransform.scaledViewHeight);
     screenUboData.offset = glm::vec2(viewTransform.offsetX, viewTransform.offsetY);
 
-    screenUbo.Update(screenUboData);
+    // Blitting and drawing directly work in swapchain pixels, which may not match the window size.
+    const VkExtent2D &extent = vulkanState.swapchain.GetExtent();
+    ViewTransform pixelTransform = Renderer::CalcViewTransform(extent.width, extent.height, viewWidth, viewHeight);
+    compositeMode = Renderer::CalcCompositeMode(pixelTransform, viewWidth, viewHeight);
+
+    // Drawing directly into the swapchain reuses the sprite pipelines, which only works with dynamic rendering
+    // since they aren't tied to a render pass, and only if the swapchain format matches the view's.
+    if (compositeMode == CompositeModeDirect &&
+        (!vulkanState.dynamicRenderingEnabled || vulkanState.swapchain.GetImageFormat() != viewFormat))
+    {
+        compositeMode = CompositeModeBlit;
+    }
+
+    if (compositeMode == CompositeModeBlit && !CheckBlitSupport())
+    {
+        compositeMode = CompositeModeShader;
+    }
+
+    compositeRect.offset = {static_cast<int32_t>(pixelTransform.offsetX),
+                            static_cast<int32_t>(pixelTransform.offsetY)};
+    compositeRect.extent = {static_cast<uint32_t>(pixelTransform.scaledViewWidth),
+                            static_cast<uint32_t>(pixelTransform.scaledViewHeight)};
+
+    for (size_t i = 0; i < directDepthImageViews.size(); i++)
+    {
+        Image oldDepthImage = directDepthImages[i];
+        VkImageView oldDepthImageView = directDepthImageViews[i];
+        VkDevice device = vulkanState.device;
+        VmaAllocator allocator = vulkanState.allocator;
+        deletionQueue.Push([=]() mutable {
+            vkDestroyImageView(device, oldDepthImageView, nullptr);
+            oldDepthImage.Destroy(allocator);
+        });
+    }
+
+    directDepthImages.clear();
+    directDepthImageViews.clear();
+
+    if (compositeMode == CompositeModeDirect)
+    {
+        VkFormat depthFormat = renderPass.GetDepthFormat();
+        std::vector<VkImage> depthImages(vulkanState.maxFramesInFlight);
+        directDepthImages.resize(vulkanState.maxFramesInFlight);
+        directDepthImageViews.resize(vulkanState.maxFramesInFlight);
+
+        for (uint32_t i = 0; i < vulkanState.maxFramesInFlight; i++)
+        {
+            directDepthImages[i] =
+                Image(vulkanState.allocator, extent.width, extent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL,
+                      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            directDepthImageViews[i] = directDepthImages[i].CreateView(VK_IMAGE_ASPECT_DEPTH_BIT, vulkanState.device);
+            depthImages[i] = directDepthImages[i].GetImage();
+        }
+
+        directRenderPass.SetDynamicDepth(depthFormat, depthImages, directDepthImageViews);
+    }
+}
+
+bool VKRenderer::CheckBlitSupport()
+{
+    if (!vulkanState.swapchain.GetTransferDstSupported())
+    {
+        return false;
+    }
+
+    VkFormatProperties viewProperties;
+    vkGetPhysicalDeviceFormatProperties(vulkanState.physicalDevice, viewFormat, &viewProperties);
+    VkFormatProperties swapchainProperties;
+    vkGetPhysicalDeviceFormatProperties(vulkanState.physicalDevice, vulkanState.swapchain.GetImageFormat(),
+                                        &swapchainProperties);
+
+    return (viewProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT) != 0 &&
+           (swapchainProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT) != 0;
+}
+
+void VKRenderer::BlitToSwapchain(VkCommandBuffer commandBuffer)
+{
+    VkImage viewImage = screenColorImages[currentFrame].GetImage();
+    VkImage swapchainImage = vulkanState.swapchain.GetImage(currentImageIndex);
+
+    // The swapchain image's previous contents are about to be cleared, so its old layout can be discarded.
+    std::array<VkImageMemoryBarrier, 2> barriers = {
+        CreateColorBarrier(viewImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT),
+        CreateColorBarrier(swapchainImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                           VK_ACCESS_TRANSFER_WRITE_BIT),
+    };
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    VkClearColorValue clearColor = ConvertClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB,
+                                                     vulkanState.swapchain.GetImageFormat());
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.levelCount = 1;
+    range.layerCount = 1;
+    vkCmdClearColorImage(commandBuffer, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &range);
+
+    VkImageMemoryBarrier clearBarrier =
+        CreateColorBarrier(swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &clearBarrier);
+
+    VkImageBlit blit{};
+    blit.srcOffsets[0] = {0, 0, 0};
+    blit.srcOffsets[1] = {viewWidth, viewHeight, 1};
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.layerCount = 1;
+    blit.dstOffsets[0] = {compositeRect.offset.x, compositeRect.offset.y, 0};
+    blit.dstOffsets[1] = {compositeRect.offset.x + static_cast<int32_t>(compositeRect.extent.width),
+                          compositeRect.offset.y + static_cast<int32_t>(compositeRect.extent.height), 1};
+    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.dstSubresource.layerCount = 1;
+
+    vkCmdBlitImage(commandBuffer, viewImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapchainImage,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+
+    VkImageMemoryBarrier presentBarrier =
+        CreateColorBarrier(swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                           VK_ACCESS_TRANSFER_WRITE_BIT, 0);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &presentBarrier);
 }
 
 void VKRenderer::BeginDrawing()
 {
-    vkWaitForFences(vulkanState.device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    AllocationTracker::Begin();
+
+    PXLIO_TRACE_ZONE("VKRenderer::BeginDrawing");
 
-    VkResult result = vulkanState.swapchain.GetNextImage(vulkanState.device, imageAvailableSemaphores[currentFrame],
-                                                         currentImageIndex);
+    frameStartTime = std::chrono::steady_clock::now();
+    currentFrameStats = FrameStats{};
+    frameStartAllocationCount = Buffer::GetAllocationCount();
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
-        WaitWhileMinimized();
-        int32_t width;
-        int32_t height;
-        SDL_Vulkan_GetDrawableSize(window, &width, &height);
-        vulkanState.swapchain.Recreate(vulkanState.allocator, vulkanState.device, vulkanState.physicalDevice,
-                                       vulkanState.surface, width, height);
-        HandleResize();
-        return;
+        PXLIO_TRACE_ZONE("VKRenderer::WaitForFence");
+        vkWaitForFences(vulkanState.device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        currentFrameStats.fenceWaitMs = CalcElapsedMs(frameStartTime);
+    }
+
+    // Measured from when the previous frame using this slot began, which includes any time it spent queued
+    // behind other frames, so deeper queues and blocking present modes show up as higher latency.
+    if (submittedFrameStartTimes[currentFrame] != std::chrono::steady_clock::time_point())
+    {
+        std::chrono::duration<float, std::milli> sample =
+            std::chrono::steady_clock::now() - submittedFrameStartTimes[currentFrame];
+        latencyMs = SmoothLatency(latencyMs, sample.count());
+    }
+
+    deletionQueue.Flush(vulkanState.maxFramesInFlight);
+
+    // The fence guarantees the GPU is done with what the batches streamed the last time this frame index was used.
+    spriteBatches.ForEach([&](uint32_t id, VKSpriteBatchData &spriteBatchData) {
+        spriteBatchData.model.ResetStreaming(currentFrame, vulkanState.allocator, deletionQueue);
+    });
+
+    if (gpuTimer.Read(vulkanState.device, currentFrame, gpuTimings))
+    {
+        gpuTimingsCsv.Write(gpuTimings);
+        frameTimeHistograms[FrameTimeKindGpu].Add(gpuTimings.viewPassMs + gpuTimings.compositePassMs);
+    }
+
+    VkResult result;
+
+    {
+        PXLIO_TRACE_ZONE("VKRenderer::AcquireImage");
+        auto acquireStartTime = std::chrono::steady_clock::now();
+
+        result = vulkanState.swapchain.GetNextImage(vulkanState.device, imageAvailableSemaphores[currentFrame],
+                                                    currentImageIndex);
+
+        // The semaphore isn't signaled when acquiring fails, so it can be reused to acquire from the new swapchain.
+        while (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            RecreateSwapchain();
+            result = vulkanState.swapchain.GetNextImage(vulkanState.device, imageAvailableSemaphores[currentFrame],
+                                                        currentImageIndex);
+        }
+
+        currentFrameStats.acquireMs = CalcElapsedMs(acquireStartTime);
     }
-    else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
     {
         RUNTIME_ERROR("Failed to acquire swap chain image!");
     }
 
     vkResetFences(vulkanState.device, 1, &inFlightFences[currentFrame]);
 
+    // The previous contents of this frame's buffer are no longer in use now that its fence has been waited on.
+    screenUbo.Update(screenUboData, currentFrame);
+    currentFrameStats.bytesUploaded += sizeof(ScreenUniformBufferData);
+
     vulkanState.commands.ResetBuffer(currentImageIndex, currentFrame);
 
     const VkExtent2D &extent = vulkanState.swapchain.GetExtent();
@@ -127,28 +350,90 @@ void VKRenderer::BeginDrawing()
 
     vulkanState.commands.BeginBuffer(currentFrame);
 
+    gpuTimer.BeginFrame(currentBuffer, currentFrame);
+    gpuTimer.Write(currentBuffer, GpuTimestampViewBegin, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+    if (compositeMode == CompositeModeDirect)
+    {
+        // The whole image is cleared to the screen background, then the view's area is cleared to its own
+        // background and drawing is restricted to it.
+        clearValues[0].color = ConvertClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB,
+                                                 vulkanState.swapchain.GetImageFormat());
+        directRenderPass.Begin(currentImageIndex, currentBuffer, extent.width, extent.height, clearValues,
+                               currentFrame);
+
+        VkClearAttachment clearAttachment{};
+        clearAttachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        clearAttachment.colorAttachment = 0;
+        clearAttachment.clearValue.color =
+            ConvertClearColor(backgroundR, backgroundG, backgroundB, vulkanState.swapchain.GetImageFormat());
+
+        VkClearRect clearRect{};
+        clearRect.rect = compositeRect;
+        clearRect.layerCount = 1;
+        vkCmdClearAttachments(currentBuffer, 1, &clearAttachment, 1, &clearRect);
+
+        VkViewport viewport{};
+        viewport.x = static_cast<float>(compositeRect.offset.x);
+        viewport.y = static_cast<float>(compositeRect.offset.y);
+        viewport.width = static_cast<float>(compositeRect.extent.width);
+        viewport.height = static_cast<float>(compositeRect.extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(currentBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(currentBuffer, 0, 1, &compositeRect);
+
+        return;
+    }
+
     clearValues[0].color =
         ConvertClearColor(backgroundR, backgroundG, backgroundB, vulkanState.swapchain.GetImageFormat());
-    renderPass.Begin(currentImageIndex, currentBuffer, static_cast<uint32_t>(viewWidth),
+    renderPass.Begin(currentFrame, currentBuffer, static_cast<uint32_t>(viewWidth),
                      static_cast<uint32_t>(viewHeight), clearValues);
 }
 
 void VKRenderer::EndDrawing()
 {
+    PXLIO_TRACE_ZONE("VKRenderer::EndDrawing");
+
     const VkExtent2D &extent = vulkanState.swapchain.GetExtent();
     const VkCommandBuffer &currentBuffer = vulkanState.commands.GetBuffer(currentFrame);
 
-    renderPass.End(currentBuffer);
+    if (compositeMode == CompositeModeDirect)
+    {
+        directRenderPass.End(currentBuffer);
+        gpuTimer.Write(currentBuffer, GpuTimestampViewEnd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
+    else
+    {
+        renderPass.End(currentBuffer);
+        gpuTimer.Write(currentBuffer, GpuTimestampViewEnd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+        gpuTimer.Write(currentBuffer, GpuTimestampCompositeBegin, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
 
-    clearValues[0].color = ConvertClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB,
-                                             vulkanState.swapchain.GetImageFormat());
-    screenRenderPass.Begin(currentImageIndex, currentBuffer, static_cast<uint32_t>(extent.width),
-                           static_cast<uint32_t>(extent.height), clearValues);
-    screenPipeline.Bind(currentBuffer, currentFrame);
+        if (compositeMode == CompositeModeBlit)
+        {
+            BlitToSwapchain(currentBuffer);
+        }
+        else
+        {
+            clearValues[0].color = ConvertClearColor(screenBackgroundR, screenBackgroundG, screenBackgroundB,
+                                                     vulkanState.swapchain.GetImageFormat());
+            screenRenderPass.Begin(currentImageIndex, currentBuffer, static_cast<uint32_t>(extent.width),
+                                   static_cast<uint32_t>(extent.height), clearValues);
+            screenPipeline.Bind(currentBuffer, currentFrame);
 
-    screenModel.Draw(currentBuffer);
+            screenModel.Draw(currentBuffer);
 
-    screenRenderPass.End(currentBuffer);
+            // The screen pass samples the view as a texture.
+            currentFrameStats.drawCalls++;
+            currentFrameStats.pipelineBinds++;
+            currentFrameStats.textureBinds++;
+
+            screenRenderPass.End(currentBuffer);
+        }
+
+        gpuTimer.Write(currentBuffer, GpuTimestampCompositeEnd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
 
     vulkanState.commands.EndBuffer(currentFrame);
 
@@ -156,7 +441,8 @@ void VKRenderer::EndDrawing()
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
     VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                         VK_PIPELINE_STAGE_TRANSFER_BIT};
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
@@ -168,11 +454,17 @@ void VKRenderer::EndDrawing()
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    if (vkQueueSubmit(vulkanState.graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to submit draw command buffer!");
+        PXLIO_TRACE_ZONE("VKRenderer::Submit");
+
+        if (vkQueueSubmit(vulkanState.graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS)
+        {
+            RUNTIME_ERROR("Failed to submit draw command buffer!");
+        }
     }
 
+    submittedFrameStartTimes[currentFrame] = frameStartTime;
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
@@ -185,29 +477,129 @@ void VKRenderer::EndDrawing()
 
     presentInfo.pImageIndices = &currentImageIndex;
 
-    VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
+    VkResult result;
+
+    {
+        PXLIO_TRACE_ZONE("VKRenderer::Present");
+        auto presentStartTime = std::chrono::steady_clock::now();
+        result = vkQueuePresentKHR(presentQueue, &presentInfo);
+        currentFrameStats.presentMs = CalcElapsedMs(presentStartTime);
+    }
+
+    auto presentTime = std::chrono::steady_clock::now();
+    if (lastPresentTime != std::chrono::steady_clock::time_point())
+    {
+        std::chrono::duration<float, std::milli> presentInterval = presentTime - lastPresentTime;
+        frameTimeHistograms[FrameTimeKindPresent].Add(presentInterval.count());
+    }
+    lastPresentTime = presentTime;
+
+    float blockedMs = currentFrameStats.fenceWaitMs + currentFrameStats.acquireMs + currentFrameStats.presentMs;
+    frameTimeHistograms[FrameTimeKindCpu].Add(CalcElapsedMs(frameStartTime) - blockedMs);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized)
     {
         framebufferResized = false;
-        WaitWhileMinimized();
-        int32_t width;
-        int32_t height;
-        SDL_Vulkan_GetDrawableSize(window, &width, &height);
-        vulkanState.swapchain.Recreate(vulkanState.allocator, vulkanState.device, vulkanState.physicalDevice,
-                                       vulkanState.surface, width, height);
-        HandleResize();
+        RecreateSwapchain();
     }
     else if (result != VK_SUCCESS)
     {
         RUNTIME_ERROR("Failed to present swap chain image!");
     }
 
+    deletionQueue.NextFrame();
+
     currentFrame = (currentFrame + 1) % vulkanState.maxFramesInFlight;
+
+    uint64_t frameAllocationCount = Buffer::GetAllocationCount() - frameStartAllocationCount;
+    currentFrameStats.buffersAllocated = static_cast<uint32_t>(frameAllocationCount);
+
+    AllocationTracker::End();
+    const AllocationReport &allocationReport = AllocationTracker::GetLastReport();
+    currentFrameStats.heapAllocations = static_cast<uint32_t>(allocationReport.count);
+    currentFrameStats.heapAllocatedBytes = allocationReport.byteSize;
+
+    frameStats = currentFrameStats;
+
+    framePacer.Wait();
+
+    Trace::NextFrame();
+}
+
+PresentStatus VKRenderer::GetPresentStatus()
+{
+    return PresentStatus{
+        ConvertVkPresentMode(vulkanState.swapchain.GetPresentMode()),
+        vulkanState.swapchain.GetImageCount(),
+        vulkanState.maxFramesInFlight,
+        presentConfig.targetFps,
+        latencyMs,
+    };
+}
+
+const FrameStats &VKRenderer::GetFrameStats()
+{
+    return frameStats;
+}
+
+const GpuTimings &VKRenderer::GetGpuTimings()
+{
+    return gpuTimings;
+}
+
+MemoryReport VKRenderer::GetMemoryReport()
+{
+    MemoryReport report;
+
+    spriteBatches.ForEach([&](uint32_t id, VKSpriteBatchData &spriteBatchData) {
+        SpriteBatchMemory memory = CalcSpriteBatchMemory(id, spriteBatchData.maxSprites, spriteBatchData.capacity,
+                                                         spriteBatchData.peakSprites);
+        memory.gpuBufferBytes = spriteBatchData.model.GetByteSize();
+        memory.textureBytes = spriteBatchData.textureImage.GetByteSize(vulkanState.allocator);
+        report.spriteBatches.push_back(memory);
+    });
+
+    VmaTotalStatistics statistics;
+    vmaCalculateStatistics(vulkanState.allocator, &statistics);
+    report.allocatedBytes = statistics.total.statistics.allocationBytes;
+    report.reservedBytes = statistics.total.statistics.blockBytes;
+    report.allocationCount = statistics.total.statistics.allocationCount;
+
+    const VkPhysicalDeviceMemoryProperties *memoryProperties;
+    vmaGetMemoryProperties(vulkanState.allocator, &memoryProperties);
+
+    // Without the extension the allocator estimates usage from its own allocations, and budgets from heap sizes.
+    std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+    vmaGetHeapBudgets(vulkanState.allocator, budgets.data());
+
+    report.budgetsFromDriver = vulkanState.memoryBudgetEnabled;
+
+    for (const VmaBudget &budget : budgets)
+    {
+        report.heaps.push_back(MemoryHeapBudget{budget.usage, budget.budget});
+    }
+
+    return report;
+}
+
+FrameTimeHistogram &VKRenderer::GetFrameTimeHistogram(FrameTimeKind kind)
+{
+    return frameTimeHistograms[kind];
+}
+
+void VKRenderer::SetGpuTimingsCsvPath(const std::string &path)
+{
+    if (path.empty())
+    {
+        gpuTimingsCsv.Close();
+        return;
+    }
+
+    gpuTimingsCsv.Open(path);
 }
 
-SpriteBatch VKRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
-                                          bool enableBlending)
+SpriteBatch &VKRenderer::CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth,
+                                           bool enableBlending)
 {
     Image textureImage = Image::CreateTexture(texturePath, vulkanState.allocator, vulkanState.commands,
                                               vulkanState.graphicsQueue, vulkanState.device, false);
@@ -219,8 +611,6 @@ SpriteBatch VKRenderer::CreateSpriteBatch(const std::string &texturePath, uint32
     int32_t textureWidth = static_cast<uint32_t>(textureImage.GetWidth());
     int32_t textureHeight = static_cast<uint32_t>(textureImage.GetHeight());
 
-    auto spriteBatch = SpriteBatch(textureWidth, textureHeight, maxSprites, enableBlending);
-
     Pipeline pipeline;
     pipeline.CreateDescriptorSetLayout(vulkanState.device, [&](std::vector<VkDescriptorSetLayoutBinding> &bindings) {
         VkDescriptorSetLayoutBinding uboLayoutBinding{};
@@ -285,75 +675,108 @@ SpriteBatch VKRenderer::CreateSpriteBatch(const std::string &texturePath, uint32
     pipeline.Create<VertexData, InstanceData>("res/VKSprite.vert.spv", "res/VKSprite.frag.spv", vulkanState.device,
                                               renderPass, enableBlending);
 
-    Model<VertexData, uint32_t, InstanceData> model = Model<VertexData, uint32_t, InstanceData>::Create(
-        1, vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue, vulkanState.device);
+    // The streaming rings start empty and grow to fit what the batch draws each frame, see DrawSpriteBatch.
+    Model<VertexData, uint32_t, InstanceData> model = Model<VertexData, uint32_t, InstanceData>::CreateStreaming(
+        0, 0, 1, vulkanState.maxFramesInFlight, vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue,
+        vulkanState.device);
     model.UpdateInstances({InstanceData{}}, vulkanState.commands, vulkanState.allocator, vulkanState.graphicsQueue,
                           vulkanState.device);
 
     VKSpriteBatchData spriteBatchData{
-        textureImage, textureImageView, textureSampler, pipeline, model,
+        textureImage, textureImageView, textureSampler, pipeline, model, maxSprites,
     };
 
-    spriteBatchDatas.insert(std::make_pair(spriteBatch.GetId(), spriteBatchData));
-
-    return spriteBatch;
+    return spriteBatches.Create(textureWidth, textureHeight, maxSprites, enableBlending, spriteBatchData);
 }
 
 void VKRenderer::DrawSpriteBatch(SpriteBatch &spriteBatch)
 {
-    if (spriteBatchDatas.find(spriteBatch.GetId()) == spriteBatchDatas.end())
+    PXLIO_TRACE_ZONE("VKRenderer::DrawSpriteBatch");
+
+    VKSpriteBatchData *spriteBatchData = spriteBatches.Get(spriteBatch);
+
+    if (!spriteBatchData)
     {
         return;
     }
 
-    auto &spriteBatchData = spriteBatchDatas.at(spriteBatch.GetId());
+    spriteBatchData->capacity = spriteBatch.GetCapacity();
+    spriteBatchData->peakSprites = std::max(spriteBatchData->peakSprites,
+                                            spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount());
 
-    const VertexData *vertices = reinterpret_cast<const VertexData *>(&spriteBatch.GetVertices()[0]);
+    const VertexData *vertices = reinterpret_cast<const VertexData *>(spriteBatch.GetVertices().data());
     size_t vertexCount = spriteBatch.GetSpriteCount() * verticesPerSprite;
     size_t indexCount = spriteBatch.GetSpriteCount() * indicesPerSprite;
 
-    spriteBatchData.model.Update(vertices, &spriteBatch.GetIndices()[0], vertexCount, indexCount, vulkanState.commands,
-                                 vulkanState.allocator, vulkanState.graphicsQueue, vulkanState.device);
+    // Appended to the frame's ring rather than written over the last draw, a batch drawn several times per frame
+    // has already had its earlier draws recorded against the data they were given.
+    spriteBatchData->model.UpdateStreaming(vertices, spriteBatch.GetIndices().data(), vertexCount, indexCount,
+                                           currentFrame, vulkanState.allocator, deletionQueue);
+
+    // Each batch's descriptor set holds its texture, so binding its pipeline also binds the texture.
+    currentFrameStats.spritesSubmitted += spriteBatch.GetSpriteCount() + spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.spritesCulled += spriteBatch.GetDroppedSpriteCount();
+    currentFrameStats.drawCalls++;
+    currentFrameStats.pipelineBinds++;
+    currentFrameStats.textureBinds++;
+    currentFrameStats.bytesUploaded += vertexCount * sizeof(VertexData) + indexCount * sizeof(uint32_t);
 
     const VkCommandBuffer &currentBuffer = vulkanState.commands.GetBuffer(currentFrame);
 
-    spriteBatchData.pipeline.Bind(currentBuffer, currentFrame);
+    gpuTimer.BeginSpriteBatch(currentBuffer, spriteBatch.GetId());
+
+    spriteBatchData->pipeline.Bind(currentBuffer, currentFrame);
 
-    spriteBatchData.model.Draw(currentBuffer);
+    spriteBatchData->model.DrawStreaming(currentBuffer, currentFrame);
+
+    gpuTimer.EndSpriteBatch(currentBuffer);
 }
 
 void VKRenderer::DestroySpriteBatch(SpriteBatch &spriteBatch)
 {
-    if (spriteBatchDatas.find(spriteBatch.GetId()) == spriteBatchDatas.end())
+    VKSpriteBatchData *existingSpriteBatchData = spriteBatches.Get(spriteBatch);
+
+    if (!existingSpriteBatchData)
     {
         return;
     }
 
-    auto &spriteBatchData = spriteBatchDatas.at(spriteBatch.GetId());
+    // The batch may still be referenced by frames that are in flight.
+    VKSpriteBatchData spriteBatchData = *existingSpriteBatchData;
+    VkDevice device = vulkanState.device;
+    VmaAllocator allocator = vulkanState.allocator;
+    deletionQueue.Push([=]() mutable { spriteBatchData.Cleanup(device, allocator); });
 
-    vkDeviceWaitIdle(vulkanState.device);
-    spriteBatchData.Cleanup(vulkanState.device, vulkanState.allocator);
+    spriteBatches.Destroy(spriteBatch);
+}
 
-    spriteBatchDatas.erase(spriteBatch.GetId());
+SpriteBatch *VKRenderer::GetSpriteBatch(uint32_t id)
+{
+    return spriteBatches.GetSpriteBatch(id);
 }
 
 void VKRenderer::InitWindow(const std::string &windowName)
 {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0)
     {
-        RUNTIME_ERROR("Unable to initialize SDL!");
+        INIT_ERROR("Unable to initialize SDL!");
     }
 
     if (SDL_Vulkan_LoadLibrary(NULL))
     {
-        RUNTIME_ERROR("Unable to initialize Vulkan!");
+        INIT_ERROR("Unable to initialize Vulkan!");
     }
 
     window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth,
                               windowHeight, SDL_WINDOW_VULKAN | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+
+    if (!window)
+    {
+        INIT_ERROR("Failed to create a window!");
+    }
 }
 
-void VKRenderer::InitVulkan(const uint32_t maxFramesInFlight)
+void VKRenderer::InitVulkan()
 {
     CreateInstance();
     SetupDebugMessenger();
@@ -366,13 +789,19 @@ void VKRenderer::InitVulkan(const uint32_t maxFramesInFlight)
     int32_t height;
     SDL_Vulkan_GetDrawableSize(window, &width, &height);
 
-    vulkanState.maxFramesInFlight = maxFramesInFlight;
+    vulkanState.maxFramesInFlight = presentConfig.maxFramesInFlight;
+    submittedFrameStartTimes.resize(vulkanState.maxFramesInFlight);
 
     vulkanState.swapchain.Create(vulkanState.device, vulkanState.physicalDevice, vulkanState.surface, width, height,
-                                 enableVsync ? VK_PRESENT_MODE_FIFO_KHR : VK_PRESENT_MODE_IMMEDIATE_KHR);
+                                 ConvertPresentMode(presentConfig.presentMode), presentConfig.imageCount);
     vulkanState.commands.CreatePool(vulkanState.physicalDevice, vulkanState.device, vulkanState.surface);
     vulkanState.commands.CreateBuffers(vulkanState.device, vulkanState.maxFramesInFlight);
 
+    QueueFamilyIndices queueFamilyIndices =
+        QueueFamilyIndices::FindQueueFamilies(vulkanState.physicalDevice, vulkanState.surface);
+    gpuTimer.Create(vulkanState.physicalDevice, vulkanState.device, queueFamilyIndices.graphicsFamily.value(),
+                    vulkanState.maxFramesInFlight);
+
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.magFilter = VK_FILTER_NEAREST;
@@ -391,7 +820,7 @@ void VKRenderer::InitVulkan(const uint32_t maxFramesInFlight)
 
     if (vkCreateSampler(vulkanState.device, &samplerInfo, nullptr, &screenColorSampler) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create color sampler!");
+        INIT_ERROR("Failed to create color sampler!");
     }
 
     ubo.Create(vulkanState.maxFramesInFlight, vulkanState.allocator);
@@ -403,108 +832,142 @@ void VKRenderer::InitVulkan(const uint32_t maxFramesInFlight)
 
     screenUbo.Create(vulkanState.maxFramesInFlight, vulkanState.allocator);
 
-    renderPass.CreateCustom(
-        vulkanState.device, vulkanState.swapchain, viewWidth, viewHeight,
-        [&] {
-            VkAttachmentDescription colorAttachment{};
-            colorAttachment.format = vulkanState.swapchain.GetImageFormat();
-            colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-            colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-            colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-            VkFormat depthFormat = renderPass.FindDepthFormat(vulkanState.physicalDevice);
-            VkAttachmentDescription depthAttachment{};
-            depthAttachment.format = depthFormat;
-            depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-            depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-            depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            VkAttachmentReference colorAttachmentRef{};
-            colorAttachmentRef.attachment = 0;
-            colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-            VkAttachmentReference depthAttachmentRef{};
-            depthAttachmentRef.attachment = 1;
-            depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            VkSubpassDescription subpass{};
-            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-            subpass.colorAttachmentCount = 1;
-            subpass.pColorAttachments = &colorAttachmentRef;
-            subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-            std::array<VkSubpassDependency, 2> dependencies;
-
-            dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-            dependencies[0].dstSubpass = 0;
-            dependencies[0].srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dependencies[0].srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-            dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-            dependencies[1].srcSubpass = 0;
-            dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-            dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dependencies[1].dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dependencies[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-            dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-            std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
-
-            VkRenderPassCreateInfo renderPassInfo{};
-            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-            renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-            renderPassInfo.pAttachments = attachments.data();
-            renderPassInfo.subpassCount = 1;
-            renderPassInfo.pSubpasses = &subpass;
-            renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
-            renderPassInfo.pDependencies = dependencies.data();
-
-            VkRenderPass renderPass;
-
-            if (vkCreateRenderPass(vulkanState.device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
-            {
-                RUNTIME_ERROR("Failed to create render pass!");
-            }
+    // The offscreen images only depend on the view size, so they live for as long as the renderer does.
+    // Each frame in flight gets its own pair so that drawing the next frame doesn't have to wait for
+    // the screen pass of the previous frame to finish reading from them.
+    screenColorImages.resize(vulkanState.maxFramesInFlight);
+    screenColorImageViews.resize(vulkanState.maxFramesInFlight);
+    screenDepthImages.resize(vulkanState.maxFramesInFlight);
+    screenDepthImageViews.resize(vulkanState.maxFramesInFlight);
 
-            return renderPass;
-        },
-        [&](const VkExtent2D &extent) {
-            screenColorImage =
-                Image(vulkanState.allocator, viewWidth, viewHeight, vulkanState.swapchain.GetImageFormat(),
-                      VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-            screenColorImageView = screenColorImage.CreateView(VK_IMAGE_ASPECT_COLOR_BIT, vulkanState.device);
-
-            VkFormat depthFormat = renderPass.FindDepthFormat(vulkanState.physicalDevice);
-            screenDepthImage = Image(vulkanState.allocator, viewWidth, viewHeight, depthFormat, VK_IMAGE_TILING_OPTIMAL,
-                                     VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-            screenDepthImageView = screenDepthImage.CreateView(VK_IMAGE_ASPECT_DEPTH_BIT, vulkanState.device);
-        },
-        [=] {
-            vkDestroyImageView(vulkanState.device, screenColorImageView, nullptr);
-            screenColorImage.Destroy(vulkanState.allocator);
-
-            vkDestroyImageView(vulkanState.device, screenDepthImageView, nullptr);
-            screenDepthImage.Destroy(vulkanState.allocator);
-        },
-        [&](std::vector<VkImageView> &attachments, VkImageView imageView) {
-            attachments.push_back(screenColorImageView);
-            attachments.push_back(screenDepthImageView);
-        });
+    VkFormat depthFormat = renderPass.FindDepthFormat(vulkanState.physicalDevice);
+    viewFormat = vulkanState.swapchain.GetImageFormat();
+
+    for (uint32_t i = 0; i < vulkanState.maxFramesInFlight; i++)
+    {
+        screenColorImages[i] = Image(vulkanState.allocator, viewWidth, viewHeight, viewFormat, VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        screenColorImageViews[i] = screenColorImages[i].CreateView(VK_IMAGE_ASPECT_COLOR_BIT, vulkanState.device);
+
+        screenDepthImages[i] =
+            Image(vulkanState.allocator, viewWidth, viewHeight, depthFormat, VK_IMAGE_TILING_OPTIMAL,
+                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        screenDepthImageViews[i] = screenDepthImages[i].CreateView(VK_IMAGE_ASPECT_DEPTH_BIT, vulkanState.device);
+    }
 
-    screenRenderPass.Create(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
-                            vulkanState.swapchain, true, false);
+    if (vulkanState.dynamicRenderingEnabled)
+    {
+        std::vector<RenderTarget> targets(vulkanState.maxFramesInFlight);
+
+        for (uint32_t i = 0; i < vulkanState.maxFramesInFlight; i++)
+        {
+            targets[i].colorImage = screenColorImages[i].GetImage();
+            targets[i].colorImageView = screenColorImageViews[i];
+            targets[i].depthImage = screenDepthImages[i].GetImage();
+            targets[i].depthImageView = screenDepthImageViews[i];
+        }
+
+        renderPass.CreateDynamicOffscreen(vulkanState.swapchain.GetImageFormat(), depthFormat,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, targets,
+                                          vulkanState.dynamicRenderingFunctions);
+        screenRenderPass.CreateDynamic(vulkanState.device, vulkanState.swapchain,
+                                       vulkanState.dynamicRenderingFunctions);
+        directRenderPass.CreateDynamic(vulkanState.device, vulkanState.swapchain,
+                                       vulkanState.dynamicRenderingFunctions);
+    }
+    else
+    {
+        renderPass.CreateOffscreen(
+            vulkanState.device, viewWidth, viewHeight, vulkanState.maxFramesInFlight,
+            [&] {
+                VkAttachmentDescription colorAttachment{};
+                colorAttachment.format = vulkanState.swapchain.GetImageFormat();
+                colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+                colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+                VkAttachmentDescription depthAttachment{};
+                depthAttachment.format = depthFormat;
+                depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+                depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+                VkAttachmentReference colorAttachmentRef{};
+                colorAttachmentRef.attachment = 0;
+                colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+                VkAttachmentReference depthAttachmentRef{};
+                depthAttachmentRef.attachment = 1;
+                depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+                VkSubpassDescription subpass{};
+                subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+                subpass.colorAttachmentCount = 1;
+                subpass.pColorAttachments = &colorAttachmentRef;
+                subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+                std::array<VkSubpassDependency, 2> dependencies;
+
+                // The frame's fence has already been waited on before its offscreen images are reused, so there is
+                // no need to wait for all previous work to reach the bottom of the pipe before drawing into them.
+                dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+                dependencies[0].dstSubpass = 0;
+                dependencies[0].srcStageMask =
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+                dependencies[0].dstStageMask =
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+                dependencies[0].srcAccessMask = 0;
+                dependencies[0].dstAccessMask =
+                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+                // The screen pass samples the color attachment in its fragment shader.
+                dependencies[1].srcSubpass = 0;
+                dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+                dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+                std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+
+                VkRenderPassCreateInfo renderPassInfo{};
+                renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+                renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+                renderPassInfo.pAttachments = attachments.data();
+                renderPassInfo.subpassCount = 1;
+                renderPassInfo.pSubpasses = &subpass;
+                renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+                renderPassInfo.pDependencies = dependencies.data();
+
+                VkRenderPass renderPass;
+
+                if (vkCreateRenderPass(vulkanState.device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+                {
+                    INIT_ERROR("Failed to create render pass!");
+                }
+
+                return renderPass;
+            },
+            [&](std::vector<VkImageView> &attachments, uint32_t i) {
+                attachments.push_back(screenColorImageViews[i]);
+                attachments.push_back(screenDepthImageViews[i]);
+            });
+
+        screenRenderPass.Create(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                                vulkanState.swapchain, false, false);
+    }
 
     screenPipeline.CreateDescriptorSetLayout(
         vulkanState.device, [&](std::vector<VkDescriptorSetLayoutBinding> &bindings) {
@@ -553,7 +1016,7 @@ void VKRenderer::InitVulkan(const uint32_t maxFramesInFlight)
 
             VkDescriptorImageInfo imageInfo{};
             imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = screenColorImageView;
+            imageInfo.imageView = screenColorImageViews[i];
             imageInfo.sampler = screenColorSampler;
 
             descriptorWrites.resize(2);
@@ -591,6 +1054,8 @@ void VKRenderer::InitVulkan(const uint32_t maxFramesInFlight)
                                 vulkanState.graphicsQueue, vulkanState.device);
 
     CreateSyncObjects();
+
+    UpdateViewTransform();
 }
 
 void VKRenderer::CreateAllocator()
@@ -607,6 +1072,11 @@ void VKRenderer::CreateAllocator()
     aci.instance = instance;
     aci.pVulkanFunctions = &vkFuncs;
 
+    if (vulkanState.memoryBudgetEnabled)
+    {
+        aci.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+
     vmaCreateAllocator(&aci, &vulkanState.allocator);
 }
 
@@ -626,12 +1096,13 @@ VKRenderer::~VKRenderer()
 {
     vkDeviceWaitIdle(vulkanState.device);
 
+    deletionQueue.FlushAll();
+
     vulkanState.swapchain.Cleanup(vulkanState.allocator, vulkanState.device);
 
-    for (auto &it = spriteBatchDatas.begin(); it != spriteBatchDatas.end(); it++)
-    {
-        it->second.Cleanup(vulkanState.device, vulkanState.allocator);
-    }
+    spriteBatches.ForEach([&](uint32_t id, VKSpriteBatchData &spriteBatchData) {
+        spriteBatchData.Cleanup(vulkanState.device, vulkanState.allocator);
+    });
 
 
     screenPipeline.Cleanup(vulkanState.device);
@@ -641,6 +1112,25 @@ VKRenderer::~VKRenderer()
     renderPass.Cleanup(vulkanState.allocator, vulkanState.device);
     screenRenderPass.Cleanup(vulkanState.allocator, vulkanState.device);
 
+    if (vulkanState.dynamicRenderingEnabled)
+    {
+        directRenderPass.Cleanup(vulkanState.allocator, vulkanState.device);
+    }
+
+    for (size_t i = 0; i < directDepthImageViews.size(); i++)
+    {
+        vkDestroyImageView(vulkanState.device, directDepthImageViews[i], nullptr);
+        directDepthImages[i].Destroy(vulkanState.allocator);
+    }
+
+    for (uint32_t i = 0; i < vulkanState.maxFramesInFlight; i++)
+    {
+        vkDestroyImageView(vulkanState.device, screenColorImageViews[i], nullptr);
+        screenColorImages[i].Destroy(vulkanState.allocator);
+        vkDestroyImageView(vulkanState.device, screenDepthImageViews[i], nullptr);
+        screenDepthImages[i].Destroy(vulkanState.allocator);
+    }
+
     ubo.Destroy(vulkanState.allocator);
     screenUbo.Destroy(vulkanState.allocator);
 
@@ -657,6 +1147,8 @@ VKRenderer::~VKRenderer()
 
     vulkanState.commands.Destroy(vulkanState.device);
 
+    gpuTimer.Cleanup(vulkanState.device);
+
     vkDestroyDevice(vulkanState.device, nullptr);
 
     if (enableValidationLayers)
@@ -672,11 +1164,102 @@ VKRenderer::~VKRenderer()
     SDL_Quit();
 }
 
+void VKRenderer::CleanupFailedInit()
+{
+    // Objects created from the logical device before the error are released along with it rather than one by one,
+    // only the swapchain has to go first since it belongs to the surface as well.
+    if (vulkanState.device != VK_NULL_HANDLE)
+    {
+        vkDeviceWaitIdle(vulkanState.device);
+        vkDestroySwapchainKHR(vulkanState.device, vulkanState.swapchain.GetSwapchain(), nullptr);
+        vkDestroyDevice(vulkanState.device, nullptr);
+    }
+
+    if (instance != VK_NULL_HANDLE)
+    {
+        if (debugMessenger != VK_NULL_HANDLE)
+        {
+            DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
+        }
+
+        if (vulkanState.surface != VK_NULL_HANDLE)
+        {
+            vkDestroySurfaceKHR(instance, vulkanState.surface, nullptr);
+        }
+
+        vkDestroyInstance(instance, nullptr);
+    }
+
+    if (window)
+    {
+        SDL_DestroyWindow(window);
+    }
+
+    SDL_Vulkan_UnloadLibrary();
+    SDL_Quit();
+}
+
+bool VKRenderer::IsAvailable()
+{
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0)
+    {
+        return false;
+    }
+
+    bool isAvailable = false;
+
+    if (SDL_Vulkan_LoadLibrary(nullptr) == 0)
+    {
+        VkApplicationInfo appInfo{};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pApplicationName = "PxlIO";
+        appInfo.pEngineName = "PxlIO";
+        appInfo.apiVersion = VK_API_VERSION_1_1;
+
+        VkInstanceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        createInfo.pApplicationInfo = &appInfo;
+
+        // Without a window there is no surface to check presentation against, so this only rules out drivers that
+        // fail early or have no GPU that could possibly be suitable, and the constructor can still fail later.
+        VkInstance probeInstance;
+        if (vkCreateInstance(&createInfo, nullptr, &probeInstance) == VK_SUCCESS)
+        {
+            uint32_t deviceCount = 0;
+            vkEnumeratePhysicalDevices(probeInstance, &deviceCount, nullptr);
+
+            std::vector<VkPhysicalDevice> devices(deviceCount);
+            vkEnumeratePhysicalDevices(probeInstance, &deviceCount, devices.data());
+
+            for (const auto &device : devices)
+            {
+                VkPhysicalDeviceProperties properties;
+                vkGetPhysicalDeviceProperties(device, &properties);
+
+                if (properties.apiVersion >= VK_API_VERSION_1_1 &&
+                    CheckDeviceExtensionSupport(device, deviceExtensions))
+                {
+                    isAvailable = true;
+                    break;
+                }
+            }
+
+            vkDestroyInstance(probeInstance, nullptr);
+        }
+
+        SDL_Vulkan_UnloadLibrary();
+    }
+
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+
+    return isAvailable;
+}
+
 void VKRenderer::CreateInstance()
 {
     if (enableValidationLayers && !CheckValidationLayerSupport())
     {
-        RUNTIME_ERROR("Validation layers requested, but not available!");
+        INIT_ERROR("Validation layers requested, but not available!");
     }
 
     VkApplicationInfo appInfo{};
@@ -713,7 +1296,7 @@ void VKRenderer::CreateInstance()
 
     if (vkCreateInstance(&createInfo, nullptr, &instance) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create instance!");
+        INIT_ERROR("Failed to create instance!");
     }
 }
 
@@ -740,7 +1323,7 @@ void VKRenderer::SetupDebugMessenger()
 
     if (CreateDebugUtilsMessengerEXT(instance, &createInfo, nullptr, &debugMessenger) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to set up debug messenger!");
+        INIT_ERROR("Failed to set up debug messenger!");
     }
 }
 
@@ -748,7 +1331,7 @@ void VKRenderer::CreateSurface()
 {
     if (!SDL_Vulkan_CreateSurface(window, instance, &vulkanState.surface))
     {
-        RUNTIME_ERROR("Failed to create window surface!");
+        INIT_ERROR("Failed to create window surface!");
     }
 }
 
@@ -759,7 +1342,7 @@ void VKRenderer::PickPhysicalDevice()
 
     if (deviceCount == 0)
     {
-        RUNTIME_ERROR("Failed to find GPUs with Vulkan support!");
+        INIT_ERROR("Failed to find GPUs with Vulkan support!");
     }
 
     std::vector<VkPhysicalDevice> devices(deviceCount);
@@ -776,7 +1359,7 @@ void VKRenderer::PickPhysicalDevice()
 
     if (vulkanState.physicalDevice == VK_NULL_HANDLE)
     {
-        RUNTIME_ERROR("Failed to find a suitable GPU!");
+        INIT_ERROR("Failed to find a suitable GPU!");
     }
 }
 
@@ -810,8 +1393,31 @@ void VKRenderer::CreateLogicalDevice()
 
     createInfo.pEnabledFeatures = &deviceFeatures;
 
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    std::vector<const char *> enabledExtensions = deviceExtensions;
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+
+    vulkanState.dynamicRenderingEnabled = CheckDynamicRenderingSupport(vulkanState.physicalDevice);
+
+    if (vulkanState.dynamicRenderingEnabled)
+    {
+        enabledExtensions.insert(enabledExtensions.end(), dynamicRenderingExtensions.begin(),
+                                 dynamicRenderingExtensions.end());
+        createInfo.pNext = &dynamicRenderingFeatures;
+    }
+
+    vulkanState.memoryBudgetEnabled = CheckDeviceExtensionSupport(vulkanState.physicalDevice, memoryBudgetExtensions);
+
+    if (vulkanState.memoryBudgetEnabled)
+    {
+        enabledExtensions.insert(enabledExtensions.end(), memoryBudgetExtensions.begin(),
+                                 memoryBudgetExtensions.end());
+    }
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     if (enableValidationLayers)
     {
@@ -825,11 +1431,23 @@ void VKRenderer::CreateLogicalDevice()
 
     if (vkCreateDevice(vulkanState.physicalDevice, &createInfo, nullptr, &vulkanState.device) != VK_SUCCESS)
     {
-        RUNTIME_ERROR("Failed to create logical device!");
+        INIT_ERROR("Failed to create logical device!");
     }
 
     vkGetDeviceQueue(vulkanState.device, indices.graphicsFamily.value(), 0, &vulkanState.graphicsQueue);
     vkGetDeviceQueue(vulkanState.device, indices.presentFamily.value(), 0, &presentQueue);
+
+    if (vulkanState.dynamicRenderingEnabled)
+    {
+        DynamicRenderingFunctions &functions = vulkanState.dynamicRenderingFunctions;
+        functions.beginRendering =
+            (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(vulkanState.device, "vkCmdBeginRenderingKHR");
+        functions.endRendering =
+            (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(vulkanState.device, "vkCmdEndRenderingKHR");
+
+        // Fall back to render passes if the entry points aren't exposed.
+        vulkanState.dynamicRenderingEnabled = functions.beginRendering != nullptr && functions.endRendering != nullptr;
+    }
 }
 
 bool VKRenderer::HasStencilComponent(VkFormat format)
@@ -874,7 +1492,7 @@ void VKRenderer::CreateSyncObjects()
                 VK_SUCCESS ||
             vkCreateFence(vulkanState.device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS)
         {
-            RUNTIME_ERROR("Failed to create synchronization objects for a frame!");
+            INIT_ERROR("Failed to create synchronization objects for a frame!");
         }
     }
 }
@@ -899,6 +1517,11 @@ bool VKRenderer::IsDeviceSuitable(VkPhysicalDevice device)
 }
 
 bool VKRenderer::CheckDeviceExtensionSupport(VkPhysicalDevice device)
+{
+    return CheckDeviceExtensionSupport(device, deviceExtensions);
+}
+
+bool VKRenderer::CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char *> &extensions)
 {
     uint32_t extensionCount;
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
@@ -906,7 +1529,7 @@ bool VKRenderer::CheckDeviceExtensionSupport(VkPhysicalDevice device)
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-    std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+    std::set<std::string> requiredExtensions(extensions.begin(), extensions.end());
 
     for (const auto &extension : availableExtensions)
     {
@@ -916,18 +1539,41 @@ bool VKRenderer::CheckDeviceExtensionSupport(VkPhysicalDevice device)
     return requiredExtensions.empty();
 }
 
+bool VKRenderer::CheckDynamicRenderingSupport(VkPhysicalDevice device)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    // Querying extension features requires vkGetPhysicalDeviceFeatures2.
+    if (properties.apiVersion < VK_API_VERSION_1_1 ||
+        !CheckDeviceExtensionSupport(device, dynamicRenderingExtensions))
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &dynamicRenderingFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &features);
+
+    return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+}
+
 std::vector<const char *> VKRenderer::GetRequiredExtensions()
 {
     uint32_t extensionCount = 0;
     std::vector<const char *> extensions;
     if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, nullptr))
     {
-        RUNTIME_ERROR("Unable to get Vulkan extensions!");
+        INIT_ERROR("Unable to get Vulkan extensions!");
     }
     extensions.resize(extensionCount);
     if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, &extensions[0]))
     {
-        RUNTIME_ERROR("Unable to get Vulkan extensions!");
+        INIT_ERROR("Unable to get Vulkan extensions!");
     }
 
     if (enableValidationLayers)
@@ -1006,6 +1652,25 @@ glm::mat4 VKRenderer::VkOrtho(float left, float right, float bottom, float top,
     return ortho;
 }
 
+VkImageMemoryBarrier VKRenderer::CreateColorBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                                    VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = image;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstAccessMask = dstAccessMask;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    return barrier;
+}
+
 VkClearColorValue VKRenderer::ConvertClearColor(float r, float g, float b, VkFormat format)
 {
     if (format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_R8G8B8_SRGB)
@@ -1014,4 +1679,34 @@ VkClearColorValue VKRenderer::ConvertClearColor(float r, float g, float b, VkFor
     }
 
     return {{r, g, b, 1.0f}};
-}
\ No newline at end of file
+}
+
+VkPresentModeKHR VKRenderer::ConvertPresentMode(PresentMode presentMode)
+{
+    switch (presentMode)
+    {
+    case PresentModeFifoRelaxed:
+        return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    case PresentModeMailbox:
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+    case PresentModeImmediate:
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    default:
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
+
+PresentMode VKRenderer::ConvertVkPresentMode(VkPresentModeKHR presentMode)
+{
+    switch (presentMode)
+    {
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return PresentModeFifoRelaxed;
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return PresentModeMailbox;
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return PresentModeImmediate;
+    default:
+        return PresentModeFifo;
+    }
+}
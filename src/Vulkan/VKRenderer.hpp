@@ -2,7 +2,9 @@
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "../FramePacer.hpp"
 #include "../Renderer.hpp"
+#include "../SpriteBatchPool.hpp"
 #include <SDL2/SDL_vulkan.h>
 
 #include <glm/glm.hpp>
@@ -22,11 +24,12 @@
 #include <optional>
 #include <set>
 #include <stdexcept>
-#include <unordered_map>
 #include <vector>
 
 #include "Buffer.hpp"
 #include "Commands.hpp"
+#include "DeletionQueue.hpp"
+#include "GpuTimer.hpp"
 #include "Model.hpp"
 #include "Pipeline.hpp"
 #include "QueueFamilyIndices.hpp"
@@ -127,14 +130,17 @@ const std::vector<uint32_t> screenIndices = {0, 1, 2, 0, 2, 3};
 
 struct VulkanState
 {
-    VkPhysicalDevice physicalDevice;
-    VkDevice device;
-    VkSurfaceKHR surface;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
     VkQueue graphicsQueue;
     VmaAllocator allocator;
     Swapchain swapchain;
     Commands commands;
     uint32_t maxFramesInFlight;
+    bool dynamicRenderingEnabled = false;
+    DynamicRenderingFunctions dynamicRenderingFunctions;
+    bool memoryBudgetEnabled = false;
 };
 
 struct VKSpriteBatchData
@@ -144,6 +150,10 @@ struct VKSpriteBatchData
     VkSampler textureSampler;
     Pipeline pipeline;
     Model<VertexData, uint32_t, InstanceData> model;
+    uint32_t maxSprites = 0;
+    // The batch's capacity as of its last draw.
+    uint32_t capacity = 0;
+    uint32_t peakSprites = 0;
 
     void Cleanup(VkDevice device, VmaAllocator allocator)
     {
@@ -159,21 +169,33 @@ class VKRenderer : public Renderer
 {
   public:
     VKRenderer(const std::string &windowName, int32_t windowWidth, int32_t windowHeight, int32_t viewWidth,
-               int32_t viewHeight, bool enableVsync = true);
+               int32_t viewHeight, const PresentConfig &presentConfig = PresentConfig());
     ~VKRenderer() override;
 
     void ResizeWindow(int width, int height) override;
     SDL_Window *GetWindowPtr() override;
+    RendererBackend GetBackend() override;
 
     void SetBackgroundColor(float r, float g, float b) override;
     void SetScreenBackgroundColor(float r, float g, float b) override;
     void BeginDrawing() override;
     void EndDrawing() override;
 
-    SpriteBatch CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
-                                  bool enableBlending = false) override;
+    PresentStatus GetPresentStatus() override;
+    const FrameStats &GetFrameStats() override;
+    const GpuTimings &GetGpuTimings() override;
+    void SetGpuTimingsCsvPath(const std::string &path) override;
+    MemoryReport GetMemoryReport() override;
+    FrameTimeHistogram &GetFrameTimeHistogram(FrameTimeKind kind) override;
+
+    SpriteBatch &CreateSpriteBatch(const std::string &texturePath, uint32_t maxSprites, bool smooth = false,
+                                   bool enableBlending = false) override;
     void DrawSpriteBatch(SpriteBatch &spriteBatch) override;
     void DestroySpriteBatch(SpriteBatch &spriteBatch) override;
+    SpriteBatch *GetSpriteBatch(uint32_t id) override;
+
+    // Checks that the Vulkan loader works and that there is a GPU it could use, without creating a window.
+    static bool IsAvailable();
 
   private:
     SDL_Window *window = nullptr;
@@ -181,7 +203,12 @@ class VKRenderer : public Renderer
     int32_t windowHeight = 0;
     int32_t viewWidth = 0;
     int32_t viewHeight = 0;
-    bool enableVsync = false;
+    PresentConfig presentConfig;
+    FramePacer framePacer;
+    std::chrono::steady_clock::time_point frameStartTime;
+    // When each frame in flight began, so its latency can be measured once its fence is waited on.
+    std::vector<std::chrono::steady_clock::time_point> submittedFrameStartTimes;
+    float latencyMs = 0.0f;
 
     float backgroundR = 0.0f;
     float backgroundG = 0.0f;
@@ -190,8 +217,8 @@ class VKRenderer : public Renderer
     float screenBackgroundG = 0.0f;
     float screenBackgroundB = 0.0f;
 
-    VkInstance instance;
-    VkDebugUtilsMessengerEXT debugMessenger;
+    VkInstance instance = VK_NULL_HANDLE;
+    VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
     VkQueue presentQueue;
 
     VulkanState vulkanState;
@@ -204,27 +231,51 @@ class VKRenderer : public Renderer
 
     bool framebufferResized = false;
 
-    Image screenColorImage;
-    VkImageView screenColorImageView;
+    DeletionQueue deletionQueue;
+
+    FrameStats frameStats;
+    FrameStats currentFrameStats;
+    uint64_t frameStartAllocationCount = 0;
+
+    GpuTimer gpuTimer;
+    GpuTimings gpuTimings;
+    GpuTimingsCsv gpuTimingsCsv;
+
+    std::array<FrameTimeHistogram, frameTimeKindCount> frameTimeHistograms;
+    std::chrono::steady_clock::time_point lastPresentTime;
+
+    std::vector<Image> screenColorImages;
+    std::vector<VkImageView> screenColorImageViews;
     VkSampler screenColorSampler;
 
-    Image screenDepthImage;
-    VkImageView screenDepthImageView;
+    std::vector<Image> screenDepthImages;
+    std::vector<VkImageView> screenDepthImageViews;
 
     RenderPass renderPass;
     RenderPass screenRenderPass;
+    // Targets the swapchain with a depth attachment, so the view can be drawn without an offscreen image.
+    RenderPass directRenderPass;
+    // One per frame in flight, like the screen depth images, empty unless drawing directly.
+    std::vector<Image> directDepthImages;
+    std::vector<VkImageView> directDepthImageViews;
+    VkFormat viewFormat;
+    CompositeMode compositeMode = CompositeModeShader;
+    VkRect2D compositeRect{};
     std::vector<VkClearValue> clearValues;
 
     Pipeline screenPipeline;
 
     UniformBuffer<UniformBufferData> ubo;
     UniformBuffer<ScreenUniformBufferData> screenUbo;
+    ScreenUniformBufferData screenUboData{};
     Model<VertexData, uint32_t, InstanceData> screenModel;
-    std::unordered_map<uint32_t, VKSpriteBatchData> spriteBatchDatas;
+    SpriteBatchPool<VKSpriteBatchData> spriteBatches;
 
     void InitWindow(const std::string &windowTitle);
 
-    void InitVulkan(const uint32_t maxFramesInFlight);
+    void InitVulkan();
+    // Releases what was created before an init error, since the destructor doesn't run when the constructor throws.
+    void CleanupFailedInit();
     void CreateInstance();
     void CreateAllocator();
     void CreateLogicalDevice();
@@ -232,7 +283,11 @@ class VKRenderer : public Renderer
     void MainLoop();
     void DrawFrame();
     void WaitWhileMinimized();
+    void RecreateSwapchain();
     void HandleResize();
+    void UpdateViewTransform();
+    bool CheckBlitSupport();
+    void BlitToSwapchain(VkCommandBuffer commandBuffer);
 
     void PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
     void SetupDebugMessenger();
@@ -251,6 +306,8 @@ class VKRenderer : public Renderer
 
     bool IsDeviceSuitable(VkPhysicalDevice device);
     bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+    static bool CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char *> &extensions);
+    bool CheckDynamicRenderingSupport(VkPhysicalDevice device);
     QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device);
     std::vector<const char *> GetRequiredExtensions();
     bool CheckValidationLayerSupport();
@@ -262,5 +319,11 @@ class VKRenderer : public Renderer
 
     static glm::mat4 VkOrtho(float left, float right, float bottom, float top, float near, float far);
 
+    static VkImageMemoryBarrier CreateColorBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                                   VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
+
     static VkClearColorValue ConvertClearColor(float r, float g, float b, VkFormat format);
+
+    static VkPresentModeKHR ConvertPresentMode(PresentMode presentMode);
+    static PresentMode ConvertVkPresentMode(VkPresentModeKHR presentMode);
 };
\ No newline at end of file
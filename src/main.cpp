@@ -4,19 +4,31 @@
 #include <iostream>
 
 #include "PxlIO.hpp"
+#include "Capture.hpp"
 #include "Input.hpp"
 #include "Audio.hpp"
 
 int main(int argc, char **argv)
 {
-    std::unique_ptr<Renderer> rend = PxlIO::Create("PxlIO", 640, 480, 320, 240);
+    // --backend overrides both the default fallback order and PXLIO_BACKEND.
+    RendererBackend backend = RendererBackendDefault;
+    if (argc == 3 && std::string(argv[1]) == "--backend" && !PxlIO::ParseBackend(argv[2], backend))
+    {
+        RUNTIME_ERROR("Unknown backend: " << argv[2]);
+    }
+
+    auto rend = std::make_unique<CaptureRenderer>(
+        PxlIO::Create(backend, "PxlIO", 640, 480, 320, 240, PresentConfig()), 320, 240);
+    std::cout << "Using the " << PxlIO::GetBackendName(rend->GetBackend()) << " backend\n";
 
     SDL_Window *window = rend->GetWindowPtr();
 
     rend->SetBackgroundColor(0, 0, 0.2f);
     rend->SetScreenBackgroundColor(1, 1, 1);
 
-    auto spriteBatch = rend->CreateSpriteBatch("res/tiles.png", 50000);
+    SpriteBatch &spriteBatch = rend->CreateSpriteBatch("res/tiles.png", 50000);
+    SpriteBatch &graphBatch = rend->CreateSpriteBatch("res/tiles.png", 320);
+    bool showGraph = false;
 
     auto lastTime = std::chrono::high_resolution_clock::now();
 
@@ -49,6 +61,66 @@ int main(int argc, char **argv)
                 case SDLK_w:
                     audio.Play();
                     break;
+                case SDLK_t:
+                    // Only writes zones when built with PXLIO_ENABLE_TRACING.
+                    Trace::WriteChromeJson("trace.json", Trace::GetFrame() > 60 ? Trace::GetFrame() - 60 : 0,
+                                           Trace::GetFrame());
+                    break;
+                case SDLK_f: {
+                    const char *names[frameTimeKindCount] = {"CPU", "GPU", "Present"};
+
+                    for (uint32_t i = 0; i < frameTimeKindCount; i++)
+                    {
+                        FrameTimePercentiles percentiles =
+                            rend->GetFrameTimeHistogram(static_cast<FrameTimeKind>(i)).CalcPercentiles();
+                        std::cout << names[i] << ": p50 " << percentiles.p50Ms << "ms, p95 " << percentiles.p95Ms
+                                  << "ms, p99 " << percentiles.p99Ms << "ms, max " << percentiles.maxMs << "ms, "
+                                  << percentiles.hitchCount << " hitches in " << percentiles.sampleCount
+                                  << " frames\n";
+                    }
+                    break;
+                }
+                case SDLK_m: {
+                    MemoryReport report = rend->GetMemoryReport();
+
+                    for (const SpriteBatchMemory &memory : report.spriteBatches)
+                    {
+                        std::cout << "Sprite batch " << memory.spriteBatchId << ": " << memory.peakSprites << "/"
+                                  << memory.capacity << "/" << memory.maxSprites << " sprites, "
+                                  << memory.cpuVertexBytes + memory.cpuIndexBytes << " CPU bytes, "
+                                  << memory.gpuBufferBytes << " buffer bytes, " << memory.textureBytes
+                                  << " texture bytes\n";
+                    }
+
+                    std::cout << report.allocatedBytes << " bytes in " << report.allocationCount << " allocations"
+                              << (report.estimated ? " (estimated)" : "") << "\n";
+
+                    for (const MemoryHeapBudget &heap : report.heaps)
+                    {
+                        std::cout << "Heap: " << heap.usageBytes << "/" << heap.budgetBytes << " bytes\n";
+                    }
+                    break;
+                }
+                case SDLK_a: {
+                    // Only counts allocations when built with PXLIO_TRACK_ALLOCATIONS.
+                    const AllocationReport &report = AllocationTracker::GetLastReport();
+                    std::cout << report.count << " allocations, " << report.byteSize << " bytes last frame\n";
+
+                    for (uint32_t i = 0; i < report.siteCount; i++)
+                    {
+                        const AllocationSite &site = report.sites[i];
+                        std::cout << "  " << (site.name ? site.name : "Outside of any zone") << ": " << site.count
+                                  << " allocations, " << site.byteSize << " bytes\n";
+                    }
+                    break;
+                }
+                case SDLK_c:
+                    // Replay it with PxlIOReplay.
+                    rend->StartCapture("capture.pxlc", 60);
+                    break;
+                case SDLK_g:
+                    showGraph = !showGraph;
+                    break;
                 case SDLK_ESCAPE:
                     isRunning = false;
                     break;
@@ -74,12 +146,25 @@ int main(int argc, char **argv)
         }
         rend->DrawSpriteBatch(spriteBatch);
 
+        if (showGraph)
+        {
+            // Bars are tinted, so any opaque texel works, the middle of the first tile is used here.
+            auto graphSprite = Sprite{};
+            graphSprite.texX = graphSprite.texY = 32;
+
+            graphBatch.Clear();
+            FrameTimeHistogram &presentTimes = rend->GetFrameTimeHistogram(FrameTimeKindPresent);
+            presentTimes.AddGraph(graphBatch, 0, 0, 1, 320, 40, 50.0f, graphSprite);
+            rend->DrawSpriteBatch(graphBatch);
+        }
+
         rend->EndDrawing();
 
         frame++;
     }
 
     rend->DestroySpriteBatch(spriteBatch);
+    rend->DestroySpriteBatch(graphBatch);
 
     return 0;
 }
\ No newline at end of file